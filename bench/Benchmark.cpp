@@ -0,0 +1,162 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <ostream>
+#include <regex>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+
+using namespace std;
+
+namespace Bench {
+
+namespace {
+
+volatile const void *sink = nullptr;
+
+string jsonEscape(const string &text) {
+    string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+string currentDate() {
+    time_t now = time(nullptr);
+    tm local{};
+    localtime_r(&now, &local);
+    ostringstream date;
+    date << put_time(&local, "%Y-%m-%dT%H:%M:%S%z");
+    return date.str();
+}
+
+string hostName() {
+    char name[256] = {};
+    gethostname(name, sizeof(name) - 1);
+    return name;
+}
+
+} // namespace
+
+/**
+ * @brief Interpreta una opción --benchmark_* (mismos nombres que Google Benchmark)
+ * @return false si arg no es una opción del arnés
+ */
+bool parseOption(const string &arg, Options &options) {
+    auto value = [&](const string &prefix, string &target) {
+        if (arg.rfind(prefix, 0) != 0) {
+            return false;
+        }
+        target = arg.substr(prefix.size());
+        return true;
+    };
+
+    string minTime;
+    if (value("--benchmark_filter=", options.filter) || value("--benchmark_format=", options.format) ||
+        value("--benchmark_out=", options.outPath)) {
+        return true;
+    }
+    if (value("--benchmark_min_time=", minTime)) {
+        options.minTime = atof(minTime.c_str());
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Indica si un benchmark pasa el filtro (búsqueda de la expresión en el nombre)
+ */
+bool matches(const Options &options, const string &name) {
+    return options.filter.empty() || regex_search(name, regex(options.filter));
+}
+
+/**
+ * @brief Mide un benchmark
+ * @details Una iteración de calentamiento (cachés, buffers reutilizables) y después rondas de
+ * 1, 10, 100... iteraciones hasta que una dure al menos minTime; se reporta esa ronda
+ * @param name Nombre del benchmark
+ * @param function Una iteración; recibe el número de iteración (p. ej. para cambiar de slice)
+ * @param minTime Segundos mínimos de la ronda reportada
+ */
+Result run(const string &name, const Function &function, double minTime) {
+    function(0);
+
+    Result result;
+    result.name = name;
+    size_t iterations = 1;
+    while (true) {
+        clock_t cpuStart = clock();
+        auto realStart = chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++) {
+            function(i + 1);
+        }
+        double realSeconds = chrono::duration<double>(chrono::steady_clock::now() - realStart).count();
+        double cpuSeconds = double(clock() - cpuStart) / CLOCKS_PER_SEC;
+
+        if (realSeconds >= minTime || iterations >= 1000000000) {
+            result.iterations = iterations;
+            result.realTimeUs = realSeconds * 1e6 / iterations;
+            result.cpuTimeUs = cpuSeconds * 1e6 / iterations;
+            return result;
+        }
+
+        // Como Google Benchmark: estimar cuántas iteraciones llegan al mínimo (con margen)
+        double estimate = realSeconds > 0.0 ? iterations * 1.4 * minTime / realSeconds : iterations * 10.0;
+        iterations = static_cast<size_t>(min(max(estimate, iterations * 2.0), iterations * 10.0));
+    }
+}
+
+void printConsoleHeader(ostream &out) {
+    out << left << setw(56) << "Benchmark" << right << setw(14) << "Time" << setw(14) << "CPU" << setw(12)
+        << "Iterations" << "\n"
+        << string(96, '-') << "\n";
+}
+
+void printConsole(ostream &out, const Result &result) {
+    out << left << setw(56) << result.name << right << fixed << setprecision(1) << setw(11) << result.realTimeUs
+        << " us" << setw(11) << result.cpuTimeUs << " us" << setw(12) << result.iterations << "\n"
+        << flush;
+}
+
+/**
+ * @brief Escribe los resultados con el esquema JSON de Google Benchmark
+ */
+void writeJson(ostream &out, const vector<Result> &results) {
+    out << "{\n"
+        << "  \"context\": {\n"
+        << "    \"date\": \"" << currentDate() << "\",\n"
+        << "    \"host_name\": \"" << jsonEscape(hostName()) << "\",\n"
+        << "    \"num_cpus\": " << thread::hardware_concurrency() << ",\n"
+        << "    \"library_build_type\": \"release\"\n"
+        << "  },\n"
+        << "  \"benchmarks\": [";
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result &result = results[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\n"
+            << "      \"name\": \"" << jsonEscape(result.name) << "\",\n"
+            << "      \"run_name\": \"" << jsonEscape(result.name) << "\",\n"
+            << "      \"run_type\": \"iteration\",\n"
+            << "      \"iterations\": " << result.iterations << ",\n"
+            << setprecision(6) << defaultfloat << "      \"real_time\": " << result.realTimeUs << ",\n"
+            << "      \"cpu_time\": " << result.cpuTimeUs << ",\n"
+            << "      \"time_unit\": \"us\"\n"
+            << "    }";
+    }
+    out << "\n  ]\n}\n";
+}
+
+void doNotOptimize(const void *pointer) {
+    sink = pointer;
+}
+
+} // namespace Bench
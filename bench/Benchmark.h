@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Mini arnés de microbenchmarks (sin dependencias) con la salida JSON de Google Benchmark
+ * @details Cada benchmark es una función que hace una iteración; el arnés la repite (1, 10,
+ * 100... veces) hasta superar el tiempo mínimo y reporta el tiempo medio por iteración. El
+ * JSON tiene los mismos campos que `--benchmark_format=json` de Google Benchmark, así que las
+ * herramientas de comparación de resultados sirven igual
+ */
+namespace Bench {
+
+using Function = std::function<void(size_t iteration)>;
+
+struct Result {
+    std::string name;
+    size_t iterations = 0;
+    double realTimeUs = 0.0; // Por iteración
+    double cpuTimeUs = 0.0;  // Por iteración, todos los hilos del proceso
+};
+
+struct Options {
+    std::string filter;    // Expresión regular sobre el nombre; vacía = todos
+    double minTime = 0.5;  // Segundos mínimos de medición por benchmark
+    std::string format = "console"; // "console" o "json" (salida estándar)
+    std::string outPath;   // Si no está vacío, el JSON se escribe también aquí
+};
+
+bool parseOption(const std::string &arg, Options &options);
+bool matches(const Options &options, const std::string &name);
+Result run(const std::string &name, const Function &function, double minTime);
+
+void printConsoleHeader(std::ostream &out);
+void printConsole(std::ostream &out, const Result &result);
+void writeJson(std::ostream &out, const std::vector<Result> &results);
+
+// Evita que el compilador descarte el resultado de la operación medida
+void doNotOptimize(const void *pointer);
+
+} // namespace Bench
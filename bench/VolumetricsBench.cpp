@@ -0,0 +1,394 @@
+#include "Benchmark.h"
+
+#include "helpers/EffectPipeline.h"
+#include "helpers/EffectRegistry.h"
+#include "helpers/VolumeFilters.h"
+#include "helpers/VolumeStatistics.h"
+#include "helpers/Volumetrics.h"
+#include "utils/Utils.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace cv;
+using namespace std;
+
+//* |------------| | Volúmenes sintéticos | |------------|
+
+namespace {
+
+struct VolumeSize {
+    unsigned width;
+    unsigned height;
+    unsigned depth;
+
+    string name() const { return to_string(width) + "x" + to_string(height) + "x" + to_string(depth); }
+};
+
+template <typename Pixel> typename itk::Image<Pixel, 3>::Pointer allocateVolume(const VolumeSize &size) {
+    typename itk::Image<Pixel, 3>::SizeType itkSize;
+    itkSize[0] = size.width;
+    itkSize[1] = size.height;
+    itkSize[2] = size.depth;
+    typename itk::Image<Pixel, 3>::RegionType region;
+    region.SetSize(itkSize);
+
+    typename itk::Image<Pixel, 3>::Pointer image = itk::Image<Pixel, 3>::New();
+    image->SetRegions(region);
+    image->Allocate();
+    return image;
+}
+
+/**
+ * @brief Genera en memoria un "paciente": cerebro elipsoidal con ruido y un tumor en capas
+ * @details Intensidades tipo FLAIR (fondo 0, cerebro ~400-600, tumor más brillante) y una
+ * segmentación BraTS con edema (2) alrededor de tumor realzado (4) y necrosis (1). Con
+ * semilla fija: cada ejecución mide exactamente los mismos datos. Intensidades int16 y
+ * máscara uint8, como quedan en memoria al leer los NIfTI de BraTS
+ */
+void generatePatient(const VolumeSize &size, LoadedVolume &flair, LoadedVolume &mask) {
+    itk::Image<int16_t, 3>::Pointer intensityImage = allocateVolume<int16_t>(size);
+    LabelImagePointer labelImage = allocateVolume<uint8_t>(size);
+    int16_t *intensity = intensityImage->GetBufferPointer();
+    uint8_t *labels = labelImage->GetBufferPointer();
+
+    double cx = size.width * 0.5, cy = size.height * 0.5, cz = size.depth * 0.5;
+    double tx = size.width * 0.62, ty = size.height * 0.42, tz = size.depth * 0.55;
+    double tumorRadius = size.width * 0.12;
+    uint32_t seed = 12345;
+
+    size_t index = 0;
+    for (unsigned z = 0; z < size.depth; z++) {
+        for (unsigned y = 0; y < size.height; y++) {
+            for (unsigned x = 0; x < size.width; x++, index++) {
+                seed = seed * 1664525u + 1013904223u; // LCG: barato y reproducible
+                double noise = (seed >> 8) / double(1 << 24) - 0.5;
+
+                double bx = (x - cx) / (size.width * 0.42), by = (y - cy) / (size.height * 0.48), bz = (z - cz) / (size.depth * 0.45);
+                double brain = bx * bx + by * by + bz * bz;
+                double tumor = sqrt((x - tx) * (x - tx) + (y - ty) * (y - ty) + (z - tz) * (z - tz)) / tumorRadius;
+
+                double value = 0.0;
+                uint8_t label = 0;
+                if (brain < 1.0) {
+                    value = 400.0 + 200.0 * (1.0 - brain) + 60.0 * noise;
+                    if (tumor < 0.35) {
+                        label = 1;
+                        value *= 0.6;
+                    } else if (tumor < 0.6) {
+                        label = 4;
+                        value *= 1.8;
+                    } else if (tumor < 1.0) {
+                        label = 2;
+                        value *= 1.4;
+                    }
+                }
+                intensity[index] = static_cast<int16_t>(lround(value));
+                labels[index] = label;
+            }
+        }
+    }
+
+    flair.image = intensityImage;
+    mask.image = labelImage;
+}
+
+/**
+ * @brief Volumetrics con un paciente sintético cargado, listo para recorrer slices
+ */
+struct Fixture {
+    VolumeSize size;
+    Volumetrics volumetrics;
+    QSize displaySize{512, 512}; // Label de la interfaz
+    VolumeImage image;           // Los mismos volúmenes, para los casos por bloques
+    VolumeImage labels;
+
+    explicit Fixture(const VolumeSize &size) : size(size) {
+        LoadedVolume flair, mask;
+        generatePatient(size, flair, mask);
+        image = flair.image;
+        labels = mask.image.toLabels();
+        volumetrics.setMultiPlanarEnabled(true); // Cachés sagitales, como con la vista multiplanar abierta
+        volumetrics.setVolume("flair", flair);
+        volumetrics.setVolume("mask", mask);
+        volumetrics.setActiveModality("flair");
+        selectSlice(size.depth / 2);
+    }
+
+    void selectSlice(int index) {
+        volumetrics.setSliceIndex(index);
+        volumetrics.setSliceAsMat();
+        volumetrics.setSliceMaskAsMat();
+    }
+
+    // Recorre la mitad central del volumen (donde hay cerebro y tumor)
+    int sliceFor(size_t iteration) const {
+        int range = max(1u, size.depth / 2);
+        return static_cast<int>(size.depth / 4 + iteration % range);
+    }
+};
+
+//* |------------| | Benchmarks | |------------|
+
+struct Case {
+    string name;
+    Bench::Function function;
+};
+
+vector<Case> casesFor(Fixture &fixture) {
+    // La fixture vive mientras se ejecutan sus casos; las lambdas guardan punteros a ella
+    Fixture *f = &fixture;
+    Volumetrics *v = &fixture.volumetrics;
+    vector<Case> cases;
+
+    // Extracción del slice y de la máscara (vistas sobre la caché 8-bit)
+    cases.push_back({"setSliceAsMat", [f, v](size_t i) {
+                         v->setSliceIndex(f->sliceFor(i));
+                         v->setSliceAsMat();
+                         Bench::doNotOptimize(v->getSliceAsMat().data);
+                     }});
+    cases.push_back({"setSliceMaskAsMat", [f, v](size_t i) {
+                         v->setSliceIndex(f->sliceFor(i));
+                         v->setSliceMaskAsMat();
+                         Bench::doNotOptimize(v->getSliceMaskAsMat().data);
+                     }});
+    cases.push_back({"getSliceView/Coronal", [f, v](size_t i) {
+                         Mat view = v->getSliceView(SliceAxis::Coronal, static_cast<int>(i % f->size.height));
+                         Bench::doNotOptimize(view.data);
+                     }});
+
+    // Cortes de la vista multiplanar: recolección sobre el buffer nativo frente a las cachés
+    // (coronal fila a fila, sagital de la copia traspuesta), más el resaltado con su máscara
+    cases.push_back({"getSliceView/Sagittal", [f, v](size_t i) {
+                         Mat view = v->getSliceView(SliceAxis::Sagittal, static_cast<int>(i % f->size.width));
+                         Bench::doNotOptimize(view.data);
+                     }});
+    for (SliceAxis axis : {SliceAxis::Coronal, SliceAxis::Sagittal}) {
+        string name = axis == SliceAxis::Coronal ? "Coronal" : "Sagittal";
+        cases.push_back({"getSliceAsMat/" + name + "+overlay", [v, axis](size_t i) {
+                             int index = static_cast<int>(i % v->getSliceCount(axis));
+                             Mat plane, mask = v->getSliceMaskAsMat(axis, index);
+                             v->processSliceInto(v->getSliceAsMat(axis, index), mask, plane);
+                             Bench::doNotOptimize(plane.data);
+                         }});
+    }
+
+    // Almacenamiento por bloques: construir la copia y recorrerla frente al buffer lineal
+    // (corte sagital sin caché, estadísticos 3D y filtro 3D con halo por brick)
+    auto bricked = make_shared<BrickedVolume>(f->image);
+    auto brickedLabels = make_shared<BrickedVolume>(f->labels);
+    cases.push_back({"BrickedVolume/build", [f](size_t) {
+                         BrickedVolume volume(f->image);
+                         Bench::doNotOptimize(volume.buffer<int16_t>());
+                     }});
+    cases.push_back({"BrickedVolume/slice/Sagittal", [f, bricked](size_t i) {
+                         Mat view = bricked->slice(SliceAxis::Sagittal, static_cast<int>(i % f->size.width));
+                         Bench::doNotOptimize(view.data);
+                     }});
+    cases.push_back({"VolumeStatistics::compute/linear", [f](size_t) {
+                         VolumeStats stats;
+                         VolumeStatistics::compute(f->image, f->labels, stats);
+                         Bench::doNotOptimize(stats.labels.data());
+                     }});
+    cases.push_back({"VolumeStatistics::compute/bricked", [bricked, brickedLabels](size_t) {
+                         VolumeStats stats;
+                         VolumeStatistics::compute(*bricked, *brickedLabels, stats);
+                         Bench::doNotOptimize(stats.labels.data());
+                     }});
+    cases.push_back({"VolumeFilters::apply/GaussianFilter/linear", [f](size_t) {
+                         VolumetricImagePointer result =
+                             VolumeFilters::apply(EffectId::GaussianFilter, f->image, EffectParams());
+                         Bench::doNotOptimize(result->GetBufferPointer());
+                     }});
+    cases.push_back({"VolumeFilters::apply/GaussianFilter/bricked", [bricked](size_t) {
+                         VolumetricImagePointer result =
+                             VolumeFilters::apply(EffectId::GaussianFilter, *bricked, EffectParams());
+                         Bench::doNotOptimize(result->GetBufferPointer());
+                     }});
+
+    // Resaltado de la máscara sobre un slice fijo
+    cases.push_back({"processSlice", [v](size_t) {
+                         Mat result = v->processSlice();
+                         Bench::doNotOptimize(result.data);
+                     }});
+
+    // Cada efecto de la tabla (es decir, cada aply*), sobre el slice en grises y sobre el resaltado
+    Mat overlay = v->processSlice();
+    for (const EffectDescriptor &descriptor : EffectRegistry::all()) {
+        if (descriptor.id == EffectId::None) {
+            continue;
+        }
+        EffectId id = descriptor.id;
+        cases.push_back({string("Effect/") + descriptor.name, [v, id](size_t) {
+                             Mat result = EffectRegistry::apply(id, *v, v->getSliceAsMat());
+                             Bench::doNotOptimize(result.data);
+                         }});
+        cases.push_back({string("Effect/") + descriptor.name + "/overlay", [v, id, overlay](size_t) {
+                             Mat result = EffectRegistry::apply(id, *v, overlay);
+                             Bench::doNotOptimize(result.data);
+                         }});
+    }
+
+    // Conversión a QImage para la interfaz (sin escalar y escalada al label)
+    cases.push_back({"matToQImage/gray", [v](size_t) {
+                         QImage image = Utils::matToQImage(v->getSliceAsMat());
+                         Bench::doNotOptimize(image.constBits());
+                     }});
+    cases.push_back({"matToQImage/bgr", [overlay](size_t) {
+                         QImage image = Utils::matToQImage(overlay);
+                         Bench::doNotOptimize(image.constBits());
+                     }});
+    cases.push_back({"matToQImage/bgr/scaled", [f, overlay](size_t) {
+                         QImage image = Utils::matToQImage(overlay, f->displaySize);
+                         Bench::doNotOptimize(image.constBits());
+                     }});
+
+    // Frame completo de la interfaz: slice + máscara + resaltado + efecto + QImage escalada
+    for (EffectId id : {EffectId::None, EffectId::Threshold, EffectId::GaussianFilter, EffectId::Closing}) {
+        cases.push_back({string("FullFrame/") + EffectRegistry::get(id).name, [f, id](size_t i) {
+                             f->selectSlice(f->sliceFor(i));
+                             Mat result = EffectRegistry::apply(id, f->volumetrics, f->volumetrics.processSlice());
+                             QImage image = Utils::matToQImage(result, f->displaySize);
+                             Bench::doNotOptimize(image.constBits());
+                         }});
+    }
+
+    // Mismo frame con EffectPipeline (buffers reutilizados), como la exportación de video
+    auto pipeline = make_shared<EffectPipeline>();
+    pipeline->addOverlay().addEffect(EffectId::GaussianFilter).addEffect(EffectId::Threshold);
+    cases.push_back({"FullFrame/Pipeline/Overlay+GaussianFilter+Threshold", [f, pipeline](size_t i) {
+                         f->selectSlice(f->sliceFor(i));
+                         Mat slice = f->volumetrics.getSliceAsMat();
+                         const Mat &result = pipeline->run(f->volumetrics, slice);
+                         QImage image = Utils::matToQImage(result, f->displaySize);
+                         Bench::doNotOptimize(image.constBits());
+                     }});
+
+    // Slice de fondo (constante, como los de los extremos del volumen): ContrastStretch devuelve
+    // su entrada y la etapa siguiente no puede escribir sobre ella
+    auto constantPipeline = make_shared<EffectPipeline>();
+    constantPipeline->addEffect(EffectId::GaussianFilter)
+        .addEffect(EffectId::ContrastStretch)
+        .addEffect(EffectId::BilateralFilter);
+    Mat background = Mat::zeros(static_cast<int>(f->size.height), static_cast<int>(f->size.width), CV_8UC1);
+    cases.push_back({"Pipeline/Constant/GaussianFilter+ContrastStretch+BilateralFilter",
+                     [v, constantPipeline, background](size_t) {
+                         const Mat &result = constantPipeline->run(*v, background);
+                         Bench::doNotOptimize(result.data);
+                     }});
+
+    // Normalización: cambiar la ventana (toda la caché desde los niveles, y su traspuesta) y un
+    // slice sin caché.
+    // Van al final porque cambiar la ventana rehace la caché de la que salen los demás casos
+    cases.push_back({"setIntensityWindow", [v](size_t i) {
+                         IntensityWindow range = v->getIntensityRange();
+                         double width = range.width() * (0.4 + 0.1 * (i % 4));
+                         v->setIntensityWindow(IntensityWindow::fromCenterWidth(range.center(), width));
+                     }});
+    cases.push_back({"IntensityWindowing::convert", [f, v](size_t i) {
+                         Mat slice = v->getSliceView(SliceAxis::Axial, f->sliceFor(i));
+                         Mat normalized;
+                         IntensityWindowing::convert(slice, v->getIntensityWindow(), normalized);
+                         Bench::doNotOptimize(normalized.data);
+                     }});
+
+    return cases;
+}
+
+bool parseSizes(const string &text, vector<VolumeSize> &sizes) {
+    sizes.clear();
+    stringstream stream(text);
+    string item;
+    while (getline(stream, item, ',')) {
+        VolumeSize size{};
+        if (sscanf(item.c_str(), "%ux%ux%u", &size.width, &size.height, &size.depth) != 3 || size.width == 0 ||
+            size.height == 0 || size.depth == 0) {
+            return false;
+        }
+        sizes.push_back(size);
+    }
+    return !sizes.empty();
+}
+
+void printUsage(const char *program) {
+    cout << "Uso: " << program << " [opciones]\n"
+         << "\n"
+         << "Microbenchmarks de Volumetrics sobre volúmenes sintéticos generados en memoria.\n"
+         << "\n"
+         << "Opciones:\n"
+         << "  --sizes=<WxHxD,...>           Tamaños de volumen (por defecto: 240x240x155,480x480x155)\n"
+         << "  --benchmark_filter=<regex>    Solo los benchmarks cuyo nombre contenga la expresión\n"
+         << "  --benchmark_min_time=<s>      Segundos mínimos de medición (por defecto: 0.5)\n"
+         << "  --benchmark_format=<console|json>\n"
+         << "  --benchmark_out=<archivo>     Escribe además los resultados en JSON\n"
+         << "  -h, --help                    Muestra esta ayuda\n";
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    Bench::Options options;
+    vector<VolumeSize> sizes = {{240, 240, 155}, {480, 480, 155}};
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg.rfind("--sizes=", 0) == 0) {
+            if (!parseSizes(arg.substr(8), sizes)) {
+                cerr << "Tamaños no válidos: " << arg.substr(8) << " (use p. ej. 240x240x155)\n";
+                return 1;
+            }
+        } else if (!Bench::parseOption(arg, options)) {
+            cerr << "Argumento no reconocido: " << arg << "\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (options.format != "console" && options.format != "json") {
+        cerr << "Formato no soportado: " << options.format << " (use console o json)\n";
+        return 1;
+    }
+
+    bool console = (options.format == "console");
+    if (console) {
+        Bench::printConsoleHeader(cout);
+    }
+
+    // Un volumen a la vez: el de 480 x 480 ocupa varios cientos de MB entre imagen y cachés
+    vector<Bench::Result> results;
+    for (const VolumeSize &size : sizes) {
+        Fixture fixture(size);
+        for (const Case &benchmark : casesFor(fixture)) {
+            string name = benchmark.name + "/" + size.name();
+            if (!Bench::matches(options, name)) {
+                continue;
+            }
+            results.push_back(Bench::run(name, benchmark.function, options.minTime));
+            if (console) {
+                Bench::printConsole(cout, results.back());
+            }
+        }
+    }
+
+    if (!console) {
+        Bench::writeJson(cout, results);
+    }
+    if (!options.outPath.empty()) {
+        ofstream out(options.outPath);
+        if (!out) {
+            cerr << "No se pudo escribir " << options.outPath << "\n";
+            return 1;
+        }
+        Bench::writeJson(out, results);
+    }
+    return 0;
+}
@@ -2,6 +2,15 @@
 
 #include "helpers/Volumetrics.h"
 #include "helpers/DirectionImages.h"
+#include "helpers/SliceResultCache.h"
+#include "helpers/Trace.h"
+#include "helpers/VolumeFilters.h"
+#include "utils/VideoExporter.h"
+#include "utils/MultiPlanarView.h"
+#include "utils/RenderWorker.h"
+#include "utils/SlicePrefetcher.h"
+#include "utils/VolumeFilterRunner.h"
+#include "utils/VolumeLoader.h"
 
 #include "ui_MainWindow.h" // Header generado por uic
 #include "utils/Utils.h"
@@ -10,11 +19,11 @@
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QPixmap>
+#include <QResizeEvent>
 
 #include <QFile>
 #include <QTextStream>
 #include <QDir>
-#include <QProcess>
 #include <QDialog>
 #include <QTabWidget>
 #include <QTextEdit>
@@ -25,8 +34,17 @@
 #include <QMessageBox>
 #include <QDebug>  
 
+#include <QAction>
+#include <QApplication>
+#include <QActionGroup>
+#include <QDockWidget>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QInputDialog>
+#include <QSlider>
 #include <QImage>
 #include <QMainWindow>
+#include <QMenu>
 #include <QString>
 #include <opencv2/opencv.hpp>
 
@@ -37,6 +55,9 @@ class MainWindow : public QMainWindow {
     explicit MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+  protected:
+    void resizeEvent(QResizeEvent *event) override;
+
   private slots:
     void on_btLoadImage_clicked();
     void on_slSliceNumber_valueChanged(int value);
@@ -45,9 +66,39 @@ class MainWindow : public QMainWindow {
     void on_btSaveImage_clicked();
     void on_btGenerateVideo_clicked();
 
+    void onVideoExportProgress(int written, int total);
+    void onVideoExportFinished(bool ok, const QString &message);
+
+    void onVolumeLoaded(const QString &type, bool ok, const QString &path);
+    void onVolumeLoadProgress(int loaded, int total);
+    void onVolumeLoadFinished(int failed);
+    void onSlicesPrefetched();
+    void onFrameRendered();
+    void onCrosshairMoved(int x, int y, int z);
+
+    void applyEffectToVolume();
+    void onVolumeFilterFinished(bool ok);
+    void clearVolumeFilters();
+
+    void showTraceSummary();
+    void exportTrace();
+
   private:
     Ui::MainWindow *ui;      // Puntero a la UI generada por uic
     Volumetrics volumetrics; // Objeto para carga y filtros
+    VideoExporter *videoExporter; // Exportación de video en segundo plano
+    VolumeLoader *volumeLoader;   // Carga de volúmenes en segundo plano
+    VolumeFilterRunner *volumeFilterRunner; // Filtros 3D en segundo plano
+    SlicePrefetcher *slicePrefetcher; // Slices vecinos procesados por adelantado
+    QDockWidget *effectParamsDock;    // Sliders de los parámetros del efecto seleccionado
+    QDockWidget *intensityWindowDock; // Centro y ancho de la ventana de intensidades
+    QDockWidget *multiPlanarDock;     // Cortes axial, coronal y sagital con cruz común
+    MultiPlanarView *multiPlanarView;
+    std::map<std::string, QAction *> modalityActions; // Menú “Modalidad”
+    SliceResultCache sliceResults; // Slices ya procesados (LRU acotada por memoria)
+    RenderWorker *renderWorker;    // Procesa y escala los slices fuera del hilo de la interfaz
+    RenderRequest lastRender;      // Lo último pedido: los frames de otras peticiones se descartan
+    qint64 shownOriginalKey = 0;   // cacheKey del original pintado: si no cambia no se vuelve a subir
 
     int currentSliceIndex;
     int numberSlicesToVideo = 0;
@@ -58,7 +109,16 @@ class MainWindow : public QMainWindow {
     cv::Mat processedSlice;
 
     QString outputFolder; // Carpeta donde guardaremos imágenes
+    std::string videoFormat = VideoFormats::defaultFormat().name; // Menú “Video”
+    double videoFps = 10.0;
+    QString filteringEffectName; // Filtro 3D en curso (mensaje al terminar)
 
-    QImage cvMatToQImage(const cv::Mat &mat);
-    void showSliceOnLabel(const cv::Mat &mat, QLabel *label);
+    void requestRender(bool withProcessed);
+    void rebuildEffectParamsPanel();
+    void rebuildIntensityWindowPanel();
+    void refreshProcessedSlice();
+    void refreshMultiPlanarView();
+    void showLoadedVolume();
+    void showModality(const std::string &type);
+    void showCurrentSlice();
 };
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "helpers/EffectRegistry.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Un paciente a procesar: volumen de intensidades + máscara de segmentación
+ */
+struct BatchCase {
+    std::string name; // Nombre de salida, por defecto derivado del volumen
+    std::string volumePath;
+    std::string maskPath;
+};
+
+/**
+ * @brief Opciones del procesamiento por lotes (sin interfaz Qt)
+ */
+struct BatchOptions {
+    std::vector<EffectId> effectIds; // Cadena de efectos, en orden
+    std::vector<EffectId> volumeEffectIds; // Filtros 3D sobre el volumen, antes de extraer los slices
+    EffectParams effectParams;
+    bool useImageProcessed = false; // Resaltar la máscara antes de los efectos
+    std::string format = "png";     // Un VideoFormat ("png", "mp4", "avi", "ffv1") o "stats" (estadísticos 3D)
+    double fps = 10.0;              // De los videos
+    std::string outputFolder = "output";
+    int jobs = 0; // Pacientes en paralelo; 0 = todos los núcleos
+};
+
+/**
+ * @brief Procesa muchos pacientes en paralelo con un pool de hilos acotado
+ */
+class BatchProcessor {
+  public:
+    explicit BatchProcessor(BatchOptions options);
+
+    int run(const std::vector<BatchCase> &batchCases);
+
+    static std::string caseNameFromPath(const std::string &volumePath);
+
+  private:
+    bool processCase(const BatchCase &batchCase, size_t threads, std::string &error) const;
+    bool processStats(const BatchCase &batchCase, size_t threads, std::string &rows, std::string &histogramRows,
+                      std::string &error) const;
+    int runStats(const std::vector<BatchCase> &cases);
+    size_t threadsPerCase(size_t caseCount) const;
+
+    BatchOptions options;
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "helpers/VolumeImage.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <opencv2/core.hpp>
+#include <vector>
+
+/**
+ * @brief Copia de un volumen en bloques (bricks) de brickSize³ vóxeles contiguos
+ * @details El buffer de ITK es x-más-rápido: ideal para un slice axial, pero un vecindario
+ * 3D o un corte sagital saltan por todo el volumen. Aquí cada brick (32³ por defecto: 32 KB
+ * en uint8, 128 KB en float) es un bloque contiguo, x-más-rápido dentro del brick, así que
+ * recorrer uno o su vecindario se queda en L2 y repartir bricks entre hilos no necesita
+ * locks. Los bricks del borde se rellenan hasta brickSize³ (con ceros) para que todos tengan
+ * la misma dirección relativa; los recorridos usan Brick::size y nunca leen el relleno.
+ * Se copia como un puntero (comparte el buffer) y guarda la geometría ITK del original
+ * (origen, spacing, dirección) sin su buffer
+ */
+class BrickedVolume {
+  public:
+    static constexpr int defaultBrickSize = 32;
+
+    // Un brick: posición de su primer vóxel y vóxeles válidos en cada eje (x, y, z)
+    struct Brick {
+        int index = 0;
+        cv::Vec3i origin;
+        cv::Vec3i size;
+    };
+
+    BrickedVolume() = default;
+    explicit BrickedVolume(const VolumeImage &image, int brickSize = defaultBrickSize, size_t threads = 0);
+
+    explicit operator bool() const { return storage != nullptr; }
+
+    VoxelType type() const { return voxelType; }
+    int width() const { return dims[0]; }
+    int height() const { return dims[1]; }
+    int depth() const { return dims[2]; }
+    int brickSize() const { return edge; }
+    int brickCount() const { return grid[0] * grid[1] * grid[2]; }
+    cv::Vec3i brickGrid() const { return grid; }
+    size_t bytes() const { return storage ? storage->size() : 0; }
+    const itk::ImageBase<3> *geometry() const { return info.GetPointer(); }
+
+    Brick brick(int index) const;
+    Brick brickAt(int bx, int by, int bz) const { return brick((bz * grid[1] + by) * grid[0] + bx); }
+
+    // Vóxeles de un brick desde su primer vóxel; fila = brickSize, slice = brickSize² vóxeles
+    size_t offsetOf(const Brick &brick) const { return static_cast<size_t>(brick.index) * edge * edge * edge; }
+    size_t localOffset(int lx, int ly, int lz) const { return (static_cast<size_t>(lz) * edge + ly) * edge + lx; }
+
+    // Buffer tipado de todos los bricks; nullptr si el volumen no es de ese tipo
+    template <typename Pixel> const Pixel *buffer() const {
+        return voxelType == VoxelTraits<Pixel>::type ? reinterpret_cast<const Pixel *>(storage->data()) : nullptr;
+    }
+
+    /**
+     * @brief Llama a function con el buffer de bricks en su tipo (como VolumeImage::visit)
+     */
+    template <typename Function> decltype(auto) visit(Function &&function) const {
+        const void *pixels = storage ? storage->data() : nullptr;
+        switch (voxelType) {
+        case VoxelType::UInt8:
+            return function(static_cast<const uint8_t *>(pixels));
+        case VoxelType::Int16:
+            return function(static_cast<const int16_t *>(pixels));
+        case VoxelType::UInt16:
+            return function(static_cast<const uint16_t *>(pixels));
+        case VoxelType::Float32:
+            break;
+        }
+        return function(static_cast<const float *>(pixels));
+    }
+
+    cv::Mat slice(SliceAxis axis, int index) const;
+    void gather(const cv::Vec3i &origin, const cv::Vec3i &size, float *dst) const;
+
+  private:
+    std::shared_ptr<const std::vector<uint8_t>> storage;
+    itk::ImageBase<3>::ConstPointer info; // Solo la geometría, sin vóxeles
+    VoxelType voxelType = VoxelType::Float32;
+    int edge = defaultBrickSize;
+    cv::Vec3i dims{0, 0, 0};
+    cv::Vec3i grid{0, 0, 0}; // Bricks en cada eje
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "helpers/EffectRegistry.h"
+#include "helpers/Volumetrics.h"
+
+#include <opencv2/core.hpp>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Cadenas de efectos sin dependencias de Qt (GUI y línea de comandos)
+ */
+namespace EffectChain {
+
+cv::Mat applyChain(Volumetrics &volumetrics, cv::Mat processedSlice, const std::vector<EffectId> &effectIds,
+                   const EffectParams &params = EffectParams());
+
+bool parseChain(const std::string &chain, std::vector<EffectId> &effectIds, std::string &unknownName, char separator = ',');
+
+} // namespace EffectChain
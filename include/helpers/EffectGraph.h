@@ -0,0 +1,52 @@
+#pragma once
+
+#include "helpers/EffectRegistry.h"
+
+#include <opencv2/core.hpp>
+#include <vector>
+
+class Volumetrics;
+
+/**
+ * @brief Cadena de efectos con evaluación incremental: cada etapa guarda su resultado
+ * @details Pensada para ajustar parámetros en vivo sobre un mismo slice. Cambiar un parámetro
+ * de una etapa solo invalida esa etapa y las siguientes: run() vuelve a calcular desde ahí,
+ * partiendo del resultado guardado de la etapa anterior. Cambiar la entrada invalida todo.
+ * Al contrario que EffectPipeline (pensada para recorrer slices distintos con dos buffers),
+ * aquí cada etapa tiene su propio buffer, que se reutiliza entre ejecuciones
+ */
+class EffectGraph {
+  public:
+    EffectGraph &addEffect(EffectId id, const EffectParams &params = EffectParams());
+    EffectGraph &addOverlay();
+    void clear();
+    size_t size() const;
+
+    void setInput(const cv::Mat &input);
+    bool setParams(size_t stage, const EffectParams &params);
+    bool setParam(size_t stage, EffectParamId id, double value);
+    const EffectParams &params(size_t stage) const;
+    void invalidate(size_t fromStage = 0);
+
+    const cv::Mat &run(Volumetrics &volumetrics);
+    size_t lastRecomputed() const;
+
+  private:
+    struct Node {
+        bool overlay;
+        EffectId id;
+        EffectParams params;
+        cv::Mat output;
+        bool ownsOutput = true; // false si output comparte memoria con otra imagen
+        cv::Mat lut;            // Efectos punto a punto: tabla de 256 entradas
+        bool lutValid = false;
+        cv::Mat scratch; // Memoria propia de la etapa (elemento estructurante, grises...)
+    };
+
+    void evaluate(Node &node, Volumetrics &volumetrics, const cv::Mat &src);
+
+    std::vector<Node> nodes;
+    cv::Mat input;
+    size_t firstDirty = 0; // Primera etapa cuyo resultado guardado ya no vale
+    size_t recomputed = 0;
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "helpers/EffectRegistry.h"
+
+#include <opencv2/core.hpp>
+#include <vector>
+
+class Volumetrics;
+
+/**
+ * @brief Cadena de efectos (y resaltado de la máscara) ejecutada sobre dos buffers que se
+ * alternan entre etapas y se reutilizan entre frames
+ * @details Las etapas punto a punto consecutivas (Threshold, Brightness) se fusionan en una
+ * sola tabla de consulta de 256 entradas, es decir, una única pasada sobre la imagen. Una vez
+ * que los buffers tienen el tamaño del slice, run() no reserva memoria propia (solo la que
+ * OpenCV use internamente o los efectos sin variante applyInto)
+ */
+class EffectPipeline {
+  public:
+    EffectPipeline &addEffect(EffectId id);
+    EffectPipeline &addOverlay();
+    void setParams(const EffectParams &params);
+    void clear();
+    bool empty() const;
+
+    const cv::Mat &run(Volumetrics &volumetrics, const cv::Mat &input);
+
+  private:
+    enum class StageKind { Effect, Overlay, PointLut };
+
+    struct Stage {
+        StageKind kind;
+        EffectId id = EffectId::None;
+        bool needsGray = false;
+        cv::Mat lut;     // PointLut: 1x256 CV_8UC1
+        cv::Mat scratch; // Memoria propia de la etapa (elemento estructurante, grises...)
+    };
+
+    struct Step {
+        bool overlay;
+        EffectId id;
+    };
+
+    void compile();
+
+    std::vector<Step> steps; // Lo pedido por el usuario, en orden
+    std::vector<Stage> stages; // Lo que se ejecuta, tras fusionar
+    bool compiled = false;
+    EffectParams params;
+
+    cv::Mat buffers[2];
+    bool ownsBuffer[2] = {true, true}; // false si el buffer comparte memoria con otra imagen
+};
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <array>
+#include <opencv2/core.hpp>
+#include <string>
+#include <vector>
+
+class Volumetrics;
+
+/**
+ * @brief Identificador de cada efecto; el orden es el del combo de la interfaz
+ */
+enum class EffectId {
+    None,
+    Threshold,
+    ContrastStretch,
+    UmbralBinary,
+    BitwiseAND,
+    BitwiseOR,
+    BitwiseXOR,
+    Canny,
+    Brightness,
+    MeanFilter,
+    GaussianFilter,
+    MedianFilter,
+    BilateralFilter,
+    Erosion,
+    Dilation,
+    Opening,
+    Closing,
+    HistogramEqualization,
+    Emboss,
+    Count
+};
+
+/**
+ * @brief Parámetros de los efectos (los valores por defecto son los de la interfaz)
+ */
+struct EffectParams {
+    double threshold = 55.0;
+    double cannyLower = 50.0;
+    double cannyUpper = 150.0;
+    int brightness = 50;
+    int smoothKernelSize = 5; // Media, Gaussiano y Mediana
+    double gaussianSigma = 1.0;
+    int bilateralDiameter = 9;
+    double bilateralSigmaColor = 75.0;
+    double bilateralSigmaSpace = 75.0;
+    int morphKernelSize = 3; // Erosión, Dilatación, Apertura y Cierre
+
+    bool operator==(const EffectParams &other) const;
+    bool operator!=(const EffectParams &other) const { return !(*this == other); }
+};
+
+/**
+ * @brief Identificador de cada parámetro ajustable de EffectParams
+ */
+enum class EffectParamId {
+    Threshold,
+    CannyLower,
+    CannyUpper,
+    Brightness,
+    SmoothKernelSize,
+    GaussianSigma,
+    BilateralDiameter,
+    BilateralSigmaColor,
+    BilateralSigmaSpace,
+    MorphKernelSize,
+    Count
+};
+
+constexpr size_t EffectParamCount = static_cast<size_t>(EffectParamId::Count);
+
+constexpr unsigned paramBit(EffectParamId id) {
+    return 1u << static_cast<unsigned>(id);
+}
+
+/**
+ * @brief Descripción de un parámetro: nombre para la línea de comandos, etiqueta y rango
+ * @details Los valores válidos son minimum + k * step (los tamaños de kernel van de 2 en 2)
+ */
+struct EffectParamSpec {
+    EffectParamId id;
+    const char *key;   // "threshold", "canny-lower"...
+    const char *label; // Texto de la interfaz
+    double minimum;
+    double maximum;
+    double step;
+    bool integer;
+};
+
+using EffectFunction = cv::Mat (*)(Volumetrics &volumetrics, const cv::Mat &slice, const EffectParams &params);
+
+// Variante sobre un destino reutilizable; scratch es memoria propia de la etapa entre frames
+using EffectIntoFunction = void (*)(Volumetrics &volumetrics, const cv::Mat &src, cv::Mat &dst,
+                                    const EffectParams &params, cv::Mat &scratch);
+
+// Efectos punto a punto sobre 8-bit: llenan una tabla de 256 entradas
+using EffectLutFunction = void (*)(uchar *lut, const EffectParams &params);
+
+/**
+ * @brief Entrada de la tabla de efectos: nombre visible y funciones que lo aplican
+ * @details applyInto y buildLut son opcionales (nullptr si el efecto no los soporta);
+ * needsGray indica que el efecto convierte primero la imagen a grises; params son los bits
+ * (paramBit) de los parámetros que usa
+ */
+struct EffectDescriptor {
+    EffectId id;
+    const char *name;
+    EffectFunction apply;
+    EffectIntoFunction applyInto;
+    EffectLutFunction buildLut;
+    bool needsGray;
+    unsigned params;
+};
+
+constexpr size_t EffectCount = static_cast<size_t>(EffectId::Count);
+
+/**
+ * @brief Tabla de efectos indexada por EffectId: el nombre se resuelve una vez (al cambiar
+ * la selección) y aplicar un efecto por frame es una sola llamada indirecta
+ */
+namespace EffectRegistry {
+
+const std::array<EffectDescriptor, EffectCount> &all();
+const EffectDescriptor &get(EffectId id);
+EffectId idFromName(const std::string &name);
+
+cv::Mat apply(EffectId id, Volumetrics &volumetrics, const cv::Mat &slice, const EffectParams &params = EffectParams());
+
+const std::array<EffectParamSpec, EffectParamCount> &paramSpecs();
+const EffectParamSpec &paramSpec(EffectParamId id);
+bool paramFromKey(const std::string &key, EffectParamId &id);
+std::vector<EffectParamId> paramsOf(EffectId id);
+double getParam(const EffectParams &params, EffectParamId id);
+double setParam(EffectParams &params, EffectParamId id, double value);
+
+} // namespace EffectRegistry
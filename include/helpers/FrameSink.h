@@ -0,0 +1,68 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Formato de salida de una exportación: contenedor + codec, o secuencia de PNG
+ */
+struct VideoFormat {
+    const char *name;      // Para la línea de comandos: "mp4", "avi", "ffv1", "png"
+    const char *label;     // Texto de la interfaz
+    const char *extension; // Del archivo de video; vacío en las secuencias de imágenes
+    char fourcc[5];        // Codec de VideoWriter; vacío en las secuencias de imágenes
+    bool lossless;
+    bool imageSequence; // Un PNG por frame en una carpeta, en lugar de un video
+};
+
+/**
+ * @brief Tabla de formatos de exportación (el primero es el de por defecto)
+ */
+namespace VideoFormats {
+
+const std::vector<VideoFormat> &all();
+const VideoFormat *find(const std::string &name);
+const VideoFormat &defaultFormat();
+std::string names(); // "mp4, avi, ffv1, png", para mensajes de ayuda y error
+
+} // namespace VideoFormats
+
+/**
+ * @brief Destino de los frames de una exportación: un VideoWriter o una carpeta de PNG
+ * @details Se abre con el primer frame (que fija el tamaño) y acepta frames BGR o en grises.
+ * Los buffers de conversión a BGR y de reescalado se conservan entre frames, así que escribir
+ * un frame no reserva memoria. Cada FrameSink escribe su propio archivo o carpeta: varios
+ * pueden trabajar a la vez en hilos distintos
+ */
+class FrameSink {
+  public:
+    FrameSink(const VideoFormat &format, double fps, const std::string &basePath);
+    ~FrameSink();
+
+    FrameSink(const FrameSink &) = delete;
+    FrameSink &operator=(const FrameSink &) = delete;
+
+    bool write(const cv::Mat &frame, int number, std::string &error);
+    void close();
+
+    const std::string &path() const { return outputPath; }
+    int framesWritten() const { return written; }
+    cv::Size frameSize() const { return size; }
+
+  private:
+    bool open(const cv::Mat &frame, std::string &error);
+
+    VideoFormat format;
+    double fps;
+    std::string outputPath; // Archivo de video o carpeta de la secuencia
+    cv::VideoWriter writer;
+    cv::Size size;
+    bool opened = false;
+    int written = 0;
+    std::vector<int> pngParams;
+    cv::Mat colorFrame;   // Frame en grises convertido a BGR
+    cv::Mat resizedFrame; // Frame con otro tamaño, llevado al del primero
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <opencv2/core.hpp>
+#include <string>
+
+using IntensityHistogram = std::array<uint64_t, 256>;
+
+/**
+ * @brief Estadísticos de las intensidades 8-bit dentro de la máscara
+ * @details Todo se deriva del histograma de 256 bins, sin ordenar ni copiar píxeles; los
+ * cuartiles usan interpolación lineal entre rangos (igual que pandas.quantile)
+ */
+struct IntensityStats {
+    IntensityHistogram histogram{};
+    uint64_t count = 0;
+    int minimum = 0;
+    int maximum = 0;
+    double mean = 0.0;
+    double q1 = 0.0;
+    double median = 0.0;
+    double q3 = 0.0;
+    double iqr = 0.0;
+    double lowerFence = 0.0; // q1 - 1.5 * iqr
+    double upperFence = 0.0; // q3 + 1.5 * iqr
+    uint64_t outliers = 0;   // Fuera de [lowerFence, upperFence]
+};
+
+namespace IntensityStatistics {
+
+/**
+ * @brief Histograma de un slice restringido a la máscara, en una sola pasada
+ * @param slice Slice CV_8UC1 o BGR (se pasa a grises)
+ * @param mask Máscara CV_8UC1 del mismo tamaño; cuenta todo píxel con etiqueta distinta de 0
+ * @param stats Resultado
+ * @return false si las entradas no son válidas o la máscara no cubre ningún píxel
+ */
+bool computeMasked(const cv::Mat &slice, const cv::Mat &mask, IntensityStats &stats);
+
+// Deriva mínimo, máximo, media, cuartiles, IQR y outliers de un histograma ya calculado
+IntensityStats fromHistogram(const IntensityHistogram &histogram);
+
+// Reporte de texto (mismo formato que reporte_estadisticas.txt)
+std::string report(const IntensityStats &stats);
+
+// Gráficos BGR listos para guardar o mostrar
+cv::Mat drawHistogram(const IntensityStats &stats, cv::Size size = cv::Size(600, 400));
+cv::Mat drawBoxplot(const IntensityStats &stats, cv::Size size = cv::Size(400, 600));
+cv::Mat drawSummary(const IntensityStats &stats, cv::Size size = cv::Size(600, 400));
+
+} // namespace IntensityStatistics
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "helpers/VolumeImage.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <opencv2/core.hpp>
+#include <vector>
+
+/**
+ * @brief Ventana de intensidades (window/level) con que el volumen pasa a 8-bit
+ * @details low se muestra negro y high blanco; lo que queda fuera se satura. Es la misma
+ * para todos los slices del volumen, así que un umbral fijo significa lo mismo en cada uno
+ */
+struct IntensityWindow {
+    double low = 0.0;
+    double high = 0.0;
+
+    double center() const { return 0.5 * (low + high); }
+    double width() const { return high - low; }
+    bool isValid() const { return high > low; }
+
+    static IntensityWindow fromCenterWidth(double center, double width) {
+        return {center - 0.5 * width, center + 0.5 * width};
+    }
+
+    bool operator==(const IntensityWindow &other) const { return low == other.low && high == other.high; }
+    bool operator!=(const IntensityWindow &other) const { return !(*this == other); }
+};
+
+/**
+ * @brief Intensidades de un volumen cuantizadas una sola vez, al cargarlo
+ * @details Cada vóxel corresponde a un nivel (0 .. levelCount - 1) y el histograma cuenta los
+ * vóxeles de cada nivel. En un volumen entero el nivel es el valor menos el mínimo, así que
+ * no hace falta guardar nada más: el propio buffer sirve de índice. En uno float se reparte
+ * el rango en floatLevels niveles y se guardan en levels, con el mismo orden que la caché
+ * 8-bit de slices. Cambiar la ventana solo rehace una tabla de levelCount entradas y la
+ * aplica sobre los niveles: no se vuelven a leer los float
+ */
+struct QuantizedVolume {
+    static constexpr int floatLevels = 4096; // 12 bits: la tabla cabe en la caché L1
+
+    float minimum = 0.0f;
+    float maximum = 0.0f;
+    uint64_t voxels = 0;
+    bool integral = false;           // Niveles = valor - minimum
+    int levelCount = 0;
+    double levelWidth = 0.0;         // Intensidad que abarca cada nivel (1 en un volumen entero)
+    std::vector<uint64_t> histogram; // levelCount bins
+    cv::Mat levels;                  // Solo float: CV_16UC1, (depth * height) x width; vacío si no se pidió
+
+    // Intensidad del centro de un nivel
+    double levelValue(int level) const { return minimum + (level + (integral ? 0.0 : 0.5)) * levelWidth; }
+
+    // Indica si se puede construir la caché 8-bit de image (float necesita levels)
+    bool hasLevels(const VolumeImage &image) const { return integral || !levels.empty() || image.voxelCount() == 0; }
+};
+
+namespace IntensityWindowing {
+
+// Percentiles de la ventana por defecto, sobre los vóxeles que no son fondo
+constexpr double defaultLowPercentile = 0.5;
+constexpr double defaultHighPercentile = 99.5;
+
+/**
+ * @brief Cuantiza un volumen y calcula su histograma en paralelo, en su tipo nativo
+ * @details Una pasada de mínimo/máximo y otra que acumula un histograma por bloque de
+ * slices (sin locks) y, si el volumen es float, escribe los niveles; al final se suman
+ * @param image Volumen (uint8, int16, uint16 o float)
+ * @param volume Resultado
+ * @param keepLevels false para calcular solo el rango y el histograma de un volumen float
+ * @param threads Hilos a usar; 0 = todos los núcleos, 1 = en el hilo que llama
+ * @return false si el volumen está vacío
+ */
+bool quantize(const VolumeImage &image, QuantizedVolume &volume, bool keepLevels = true, size_t threads = 0);
+
+/**
+ * @brief Ventana entre dos percentiles del histograma
+ * @details Se ignora el primer nivel (el fondo a 0 de un volumen sin cráneo ocupa la mayor
+ * parte de los vóxeles), salvo que no quede nada más
+ * @return Ventana no válida si el volumen es constante
+ */
+IntensityWindow percentileWindow(const QuantizedVolume &volume, double lowPercentile = defaultLowPercentile,
+                                 double highPercentile = defaultHighPercentile);
+
+/**
+ * @brief Pasa todo el volumen a 8-bit con una tabla de levelCount entradas
+ * @param image Volumen que se cuantizó
+ * @param volume Su cuantización (con levels si es float)
+ * @param window Ventana a aplicar
+ * @param dst Destino CV_8UC1 de (depth * height) x width; si ya lo tiene se escribe en su memoria
+ * @param threads Hilos a usar; 0 = todos los núcleos
+ * @return false si no hay niveles
+ */
+bool apply(const VolumeImage &image, const QuantizedVolume &volume, const IntensityWindow &window, cv::Mat &dst,
+           size_t threads = 0);
+
+/**
+ * @brief Pasa un slice a 8-bit con la ventana (escala y desplazamiento en una pasada)
+ * @param src Mat de un canal en cualquier profundidad (la del volumen: 8U, 16S, 16U o 32F)
+ * @param window Ventana a aplicar; si no es válida el resultado es negro
+ * @param dst Destino CV_8UC1; si ya tiene el tamaño correcto se escribe en su memoria
+ */
+void convert(const cv::Mat &src, const IntensityWindow &window, cv::Mat &dst);
+
+} // namespace IntensityWindowing
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Kernels del resaltado de la máscara sobre el slice
+ * @details Fusionan en una sola pasada la conversión gris → BGR y la mezcla alfa hacia el
+ * color de la máscara, en aritmética entera de 8/16 bits:
+ *   t = gris * (255 - alfa) + color * alfa + 128;  salida = (t + (t >> 8)) >> 8
+ * que es la división entre 255 redondeada, exacta para todo el rango. El camino (AVX2,
+ * SSSE3 o escalar) se elige una sola vez en tiempo de ejecución según la CPU; todos dan
+ * el mismo resultado bit a bit
+ */
+namespace OverlayKernels {
+
+/**
+ * @brief Color de resaltado en orden BGR (el de OpenCV)
+ */
+struct OverlayColor {
+    uint8_t b;
+    uint8_t g;
+    uint8_t r;
+};
+
+/**
+ * @brief Paleta de la máscara de etiquetas: color BGR y opacidad de cada valor (0–255)
+ * @details Una etiqueta oculta o sin color tiene alpha 0. Las 16 primeras entradas se
+ * consultan con una sola instrucción por tabla en los caminos SIMD
+ */
+struct LabelPalette {
+    uint8_t b[256];
+    uint8_t g[256];
+    uint8_t r[256];
+    uint8_t alpha[256];
+};
+
+/**
+ * @brief Mezcla una fila: gray y alpha tienen count bytes, bgr tiene 3 * count
+ * @param gray Intensidad del slice (CV_8UC1)
+ * @param alpha Opacidad del color por píxel (0 = solo gris, 255 = solo color)
+ * @param bgr Destino intercalado BGR (CV_8UC3); no debe solaparse con las entradas
+ * @param count Número de píxeles
+ * @param color Color hacia el que se mezcla
+ */
+void blendGrayRow(const uint8_t *gray, const uint8_t *alpha, uint8_t *bgr, int count, OverlayColor color);
+
+/**
+ * @brief Mezcla una fila de etiquetas: cada píxel toma color y opacidad de la paleta
+ * @param gray Intensidad del slice (CV_8UC1)
+ * @param labels Etiquetas sin normalizar (CV_8UC1)
+ * @param bgr Destino intercalado BGR (CV_8UC3); no debe solaparse con las entradas
+ * @param count Número de píxeles
+ * @param palette Color y opacidad de cada etiqueta
+ */
+void blendLabelRow(const uint8_t *gray, const uint8_t *labels, uint8_t *bgr, int count, const LabelPalette &palette);
+
+// Caminos escalares, siempre disponibles (también resuelven las colas de los caminos SIMD)
+void blendGrayRowScalar(const uint8_t *gray, const uint8_t *alpha, uint8_t *bgr, int count, OverlayColor color);
+void blendLabelRowScalar(const uint8_t *gray, const uint8_t *labels, uint8_t *bgr, int count, const LabelPalette &palette);
+
+// Nombre del camino elegido ("avx2", "ssse3" o "scalar"), para logs y benchmarks
+const char *activePath();
+
+} // namespace OverlayKernels
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+/**
+ * @brief Etiqueta de la segmentación: valor en la máscara, nombre y color por defecto (BGRA)
+ */
+struct SegmentationLabel {
+    uint8_t value;
+    const char *name;
+    uint8_t b, g, r, alpha;
+};
+
+// Etiquetas de BraTS; cualquier otro valor distinto de 0 se pinta con defaultLabelColor
+constexpr std::array<SegmentationLabel, 3> bratsLabels{{
+    {1, "Necrosis", 0, 0, 255, 160},
+    {2, "Edema", 0, 255, 0, 110},
+    {4, "Tumor realzado", 0, 255, 255, 160},
+}};
+
+constexpr SegmentationLabel defaultLabelColor{0, "Otra", 255, 0, 255, 160};
+
+// Nombre de una etiqueta de BraTS ("Otra" si no es ninguna de ellas)
+constexpr const char *labelName(int value) {
+    for (const SegmentationLabel &label : bratsLabels) {
+        if (label.value == value) {
+            return label.name;
+        }
+    }
+    return defaultLabelColor.name;
+}
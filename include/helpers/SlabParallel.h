@@ -0,0 +1,43 @@
+#pragma once
+
+#include "helpers/ThreadPool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <future>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Reparte [0, depth) en bloques Z contiguos y ejecuta work(zBegin, zEnd) en cada uno
+ * @details Hay varios bloques por hilo: el contenido interesante suele estar en los slices
+ * centrales y así ningún hilo se queda con todo el trabajo. Cada bloque debe escribir solo
+ * en sus propios slices (o en su propio resultado), sin locks
+ * @param depth Número de slices
+ * @param threads Hilos a usar; 0 = todos los núcleos, 1 = en el hilo que llama
+ * @return Resultado de cada bloque, en orden de Z
+ */
+template <typename Result, typename Work>
+std::vector<Result> forEachSlab(int depth, size_t threads, Work work) {
+    size_t workers = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+    if (workers == 1 || depth <= 1) {
+        std::vector<Result> results;
+        results.push_back(work(0, depth));
+        return results;
+    }
+
+    int slabs = static_cast<int>(std::min<size_t>(static_cast<size_t>(depth), workers * 4));
+    ThreadPool pool(workers);
+    std::vector<std::future<Result>> pending;
+    for (int slab = 0; slab < slabs; slab++) {
+        int zBegin = static_cast<int>(static_cast<int64_t>(depth) * slab / slabs);
+        int zEnd = static_cast<int>(static_cast<int64_t>(depth) * (slab + 1) / slabs);
+        pending.push_back(pool.submit([&work, zBegin, zEnd] { return work(zBegin, zEnd); }));
+    }
+
+    std::vector<Result> results;
+    for (std::future<Result> &result : pending) {
+        results.push_back(result.get());
+    }
+    return results;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "helpers/EffectGraph.h"
+#include "helpers/SliceResultCache.h"
+#include "helpers/Volumetrics.h"
+
+#include <cstdint>
+#include <mutex>
+#include <opencv2/core.hpp>
+
+/**
+ * @brief Copia de Volumetrics que la interfaz deja para los hilos de trabajo
+ * @details publish solo copia si cambió lo que se muestra (contentVersion); cada hilo la
+ * recoge con SliceRenderer::sync. La copia es superficial: comparte los buffers del volumen
+ */
+class VolumetricsSnapshot {
+  public:
+    void publish(const Volumetrics &volumetrics);
+
+  private:
+    friend class SliceRenderer;
+
+    std::mutex mutex;
+    Volumetrics snapshot;
+    uint64_t version = 0;
+    unsigned serial = 0; // Cambia con cada copia nueva; 0 = aún no hay ninguna
+};
+
+/**
+ * @brief Extrae y procesa slices (resaltado + efecto) sobre la copia propia de un hilo
+ * @details Los slices salen igual que en la interfaz, así que los resultados de todos los
+ * hilos pueden compartir la misma SliceResultCache. El EffectGraph conserva el resaltado del
+ * último slice: si solo cambian los parámetros, process solo rehace el efecto
+ */
+class SliceRenderer {
+  public:
+    void sync(VolumetricsSnapshot &source);
+    cv::Mat extract(int sliceIndex);
+    cv::Mat process(const SliceResultKey &key);
+
+  private:
+    Volumetrics volumetrics; // Propia: setSliceAsMat/processSlice modifican el estado del objeto
+    unsigned serial = 0;
+
+    cv::Mat original; // Último slice extraído
+    int originalIndex = -1;
+
+    EffectGraph graph;
+    SliceResultKey graphKey;
+    bool graphValid = false;
+};
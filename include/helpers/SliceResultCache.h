@@ -0,0 +1,70 @@
+#pragma once
+
+#include "helpers/EffectRegistry.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <opencv2/core.hpp>
+#include <unordered_map>
+
+/**
+ * @brief Identifica un slice procesado: qué se mostraba, qué slice y con qué efecto
+ */
+struct SliceResultKey {
+    uint64_t contentVersion = 0; // Volumetrics::getContentVersion()
+    int sliceIndex = 0;
+    EffectId effectId = EffectId::None;
+    EffectParams params;
+    bool overlay = false; // “Usar imagen destacada”
+
+    bool operator==(const SliceResultKey &other) const;
+};
+
+struct SliceResultKeyHash {
+    size_t operator()(const SliceResultKey &key) const;
+};
+
+/**
+ * @brief Caché LRU de slices ya procesados, acotada por memoria
+ * @details Volver a un slice ya visto (o marcar/desmarcar el resaltado) devuelve el resultado
+ * guardado sin repetir processSlice ni el efecto. Al superar el presupuesto se descartan los
+ * menos usados recientemente. Los Mat devueltos comparten memoria con la caché: no modificarlos.
+ * Se puede usar desde varios hilos a la vez (interfaz, render y prefetch)
+ */
+class SliceResultCache {
+  public:
+    static constexpr size_t defaultBudgetBytes = 128u << 20; // ~750 slices BGR de 240 x 240
+
+    explicit SliceResultCache(size_t budgetBytes = defaultBudgetBytes);
+
+    bool find(const SliceResultKey &key, cv::Mat &result);
+    bool contains(const SliceResultKey &key) const;
+    void insert(const SliceResultKey &key, const cv::Mat &result);
+    void clear();
+
+    void setBudget(size_t budgetBytes);
+    size_t budget() const;
+    size_t usedBytes() const;
+    size_t size() const;
+    uint64_t hits() const;
+    uint64_t misses() const;
+
+  private:
+    struct Entry {
+        SliceResultKey key;
+        cv::Mat result;
+        size_t bytes;
+    };
+
+    void evictToBudget();
+
+    mutable std::mutex mutex;
+    std::list<Entry> entries; // Más reciente al principio
+    std::unordered_map<SliceResultKey, std::list<Entry>::iterator, SliceResultKeyHash> index;
+    size_t budgetBytes;
+    size_t used = 0;
+    uint64_t hitCount = 0;
+    uint64_t missCount = 0;
+};
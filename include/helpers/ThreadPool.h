@@ -0,0 +1,62 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Pool de hilos de tamaño fijo (sin Qt) con cola de tareas FIFO
+ * @details El número de hilos acota cuántas tareas corren a la vez; submit() devuelve un
+ * std::future para recoger el resultado o la excepción de cada tarea
+ */
+class ThreadPool {
+  public:
+    explicit ThreadPool(size_t numThreads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    template <typename Task>
+    auto submit(Task task) -> std::future<decltype(task())>;
+
+    void waitAll();
+    size_t size() const;
+
+  private:
+    void workerLoop();
+
+    std::vector<std::thread> threads;
+    std::queue<std::function<void()>> tasks;
+
+    std::mutex mutex;
+    std::condition_variable taskAvailable;
+    std::condition_variable allDone;
+    size_t activeTasks = 0;
+    bool stopping = false;
+};
+
+/**
+ * @brief Encola una tarea en el pool
+ * @param task Callable sin argumentos
+ * @return future con el valor devuelto por la tarea
+ */
+template <typename Task>
+auto ThreadPool::submit(Task task) -> std::future<decltype(task())> {
+    using ResultType = decltype(task());
+
+    // packaged_task no es copiable: se comparte para poder guardarlo en std::function
+    auto packaged = std::make_shared<std::packaged_task<ResultType()>>(std::move(task));
+    std::future<ResultType> result = packaged->get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.emplace([packaged] { (*packaged)(); });
+    }
+    taskAvailable.notify_one();
+    return result;
+}
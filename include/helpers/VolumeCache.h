@@ -0,0 +1,43 @@
+#pragma once
+
+#include "helpers/VolumeImage.h"
+
+#include <memory>
+#include <string>
+
+/**
+ * @brief Caché en disco de volúmenes ya descomprimidos
+ * @details La primera carga de un .nii.gz escribe un archivo con una cabecera pequeña
+ * (dimensiones, spacing, origen, dirección, tipo de vóxel y el tamaño/fecha del original)
+ * seguida de los vóxeles en su tipo nativo, little-endian y alineados a página. Las cargas siguientes hacen mmap del
+ * archivo y lo envuelven en un itk::Image sin copiar: reabrir un paciente ya visto no
+ * descomprime nada y la caché de páginas del sistema se comparte entre procesos.
+ * La entrada se invalida sola si el archivo original cambia de tamaño o de fecha
+ */
+namespace VolumeCache {
+
+/**
+ * @brief Carga un volumen desde la caché
+ * @param sourcePath Ruta del volumen NIfTI original
+ * @param image Volumen resultante; su buffer apunta a la memoria mapeada
+ * @param mapping Mantiene vivo el mmap: debe vivir al menos tanto como image
+ * @return false si la caché está desactivada, no hay entrada o no es válida
+ */
+bool load(const std::string &sourcePath, VolumeImage &image, std::shared_ptr<const void> &mapping);
+
+/**
+ * @brief Guarda un volumen en la caché (escribe a un temporal y lo renombra)
+ * @details Se guarda en el tipo con que se leyó (uint8 para una máscara, el nativo del archivo
+ * para una modalidad)
+ * @return false si la caché está desactivada o no se pudo escribir
+ */
+bool store(const std::string &sourcePath, const VolumeImage &image);
+
+// Carpeta de la caché: VOLUME_CACHE_DIR si está definida, si no "cache/volumes"
+void setDirectory(const std::string &directory);
+std::string directory();
+
+void setEnabled(bool enabled);
+bool isEnabled();
+
+} // namespace VolumeCache
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "helpers/BrickedVolume.h"
+#include "helpers/EffectRegistry.h"
+#include "helpers/Volumetrics.h"
+
+#include <cstddef>
+
+/**
+ * @brief Filtros 3D sobre el volumen float completo (suavizado y morfología a través de Z)
+ * @details Gaussiano, media y morfología con elemento estructurante cúbico son separables:
+ * se aplican como tres pasadas 1D (X, Y, Z) que combinan filas enteras, así el bucle interno
+ * siempre recorre memoria contigua y se vectoriza. Cada pasada se reparte en bloques de
+ * slices Z entre hilos. La mediana no es separable y se calcula por vóxel sobre el cubo.
+ * Los bordes se reflejan como BORDER_REFLECT_101, igual que los filtros 2D de OpenCV
+ */
+namespace VolumeFilters {
+
+struct Dimensions {
+    int width = 0;
+    int height = 0;
+    int depth = 0;
+
+    size_t sliceSize() const { return static_cast<size_t>(width) * height; }
+    size_t voxels() const { return sliceSize() * depth; }
+};
+
+// true para MeanFilter, GaussianFilter, MedianFilter, Erosion, Dilation, Opening y Closing
+bool supports(EffectId id);
+
+/**
+ * @brief Filtra un buffer float x-más-rápido (el layout de ITK)
+ * @param src Vóxeles de entrada
+ * @param dst Salida, del mismo tamaño (puede ser src salvo para la mediana)
+ * @param params Tamaños de kernel y sigma (los mismos que los efectos 2D)
+ * @param threads Hilos a usar; 0 = todos los núcleos, 1 = en el hilo que llama
+ * @return false si el efecto no tiene versión 3D
+ */
+bool filter(EffectId id, const float *src, float *dst, Dimensions dims, const EffectParams &params, size_t threads = 0);
+
+/**
+ * @brief Filtra un volumen y devuelve uno nuevo, float, con la misma geometría
+ * @details Un volumen entero se promueve a float solo mientras dura el filtrado
+ * @return nullptr si el volumen no es válido o el efecto no tiene versión 3D
+ */
+VolumetricImagePointer apply(EffectId id, const VolumeImage &image, const EffectParams &params, size_t threads = 0);
+
+/**
+ * @brief Igual que apply, pero brick a brick sobre la copia por bloques del volumen
+ * @details Cada hilo toma un brick, lo copia a float con un halo del alcance del filtro
+ * (bordes reflejados como en el volumen completo), lo filtra solo y escribe su interior: el
+ * bloque de trabajo cabe en L2 y el resultado es el mismo que el de apply
+ * @return nullptr si el volumen no es válido o el efecto no tiene versión 3D
+ */
+VolumetricImagePointer apply(EffectId id, const BrickedVolume &volume, const EffectParams &params, size_t threads = 0);
+
+} // namespace VolumeFilters
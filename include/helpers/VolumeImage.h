@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <itkImage.h>
+#include <opencv2/core.hpp>
+#include <type_traits>
+
+// Volumen float: el que producen los filtros 3D y la promoción de VolumeImage::toFloat
+using VolumetricImageType = itk::Image<float, 3>;
+using VolumetricImagePointer = VolumetricImageType::Pointer;
+
+// Máscara de segmentación: etiquetas 0-255 en un byte por vóxel
+using LabelImageType = itk::Image<uint8_t, 3>;
+using LabelImagePointer = LabelImageType::Pointer;
+
+// Ejes de corte del volumen (X = sagital, Y = coronal, Z = axial)
+enum class SliceAxis { Axial, Coronal, Sagittal };
+
+// Tipo con que se guardan los vóxeles en memoria (el del archivo cuando es entero de 8/16 bits)
+enum class VoxelType : uint8_t { UInt8, Int16, UInt16, Float32 };
+
+template <typename Pixel> struct VoxelTraits;
+template <> struct VoxelTraits<uint8_t> {
+    static constexpr VoxelType type = VoxelType::UInt8;
+    static constexpr int cvDepth = CV_8U;
+};
+template <> struct VoxelTraits<int16_t> {
+    static constexpr VoxelType type = VoxelType::Int16;
+    static constexpr int cvDepth = CV_16S;
+};
+template <> struct VoxelTraits<uint16_t> {
+    static constexpr VoxelType type = VoxelType::UInt16;
+    static constexpr int cvDepth = CV_16U;
+};
+template <> struct VoxelTraits<float> {
+    static constexpr VoxelType type = VoxelType::Float32;
+    static constexpr int cvDepth = CV_32F;
+};
+
+// Tipo de vóxel del puntero que recibe la función de VolumeImage::visit
+template <typename Pointer> using PixelOf = std::remove_const_t<std::remove_pointer_t<Pointer>>;
+
+size_t voxelBytes(VoxelType type);
+const char *voxelTypeName(VoxelType type);
+
+/**
+ * @brief Volumen en memoria con su tipo de vóxel nativo (uint8, int16, uint16 o float)
+ * @details Envuelve el itk::Image<Pixel, 3> que corresponda y se copia como un puntero
+ * (comparte el buffer). Una resonancia int16 ocupa la mitad que en float y la máscara uint8
+ * la cuarta parte; los kernels que necesitan float lo leen con visit, que los instancia para
+ * cada tipo, o piden una copia con toFloat solo mientras trabajan
+ */
+class VolumeImage {
+  public:
+    VolumeImage() = default;
+    VolumeImage(const itk::Image<uint8_t, 3>::Pointer &image) { assign(image.GetPointer()); }
+    VolumeImage(const itk::Image<int16_t, 3>::Pointer &image) { assign(image.GetPointer()); }
+    VolumeImage(const itk::Image<uint16_t, 3>::Pointer &image) { assign(image.GetPointer()); }
+    VolumeImage(const itk::Image<float, 3>::Pointer &image) { assign(image.GetPointer()); }
+
+    explicit operator bool() const { return pixels != nullptr; }
+
+    VoxelType type() const { return voxelType; }
+    int cvDepth() const;
+    int width() const { return dims[0]; }
+    int height() const { return dims[1]; }
+    int depth() const { return dims[2]; }
+    size_t voxelCount() const { return static_cast<size_t>(dims[0]) * dims[1] * dims[2]; }
+    size_t bytes() const { return voxelCount() * voxelBytes(voxelType); }
+    const void *data() const { return pixels; }
+    const itk::ImageBase<3> *itkImage() const { return image.GetPointer(); }
+
+    // Buffer tipado; nullptr si el volumen no es de ese tipo
+    template <typename Pixel> const Pixel *buffer() const {
+        return voxelType == VoxelTraits<Pixel>::type ? static_cast<const Pixel *>(pixels) : nullptr;
+    }
+
+    /**
+     * @brief Llama a function con el buffer en su tipo (const uint8_t *, const int16_t *...)
+     * @details Así un kernel se escribe una vez, como plantilla o lambda genérica, y lee el
+     * tipo nativo sin copiar ni convertir el volumen
+     */
+    template <typename Function> decltype(auto) visit(Function &&function) const {
+        switch (voxelType) {
+        case VoxelType::UInt8:
+            return function(static_cast<const uint8_t *>(pixels));
+        case VoxelType::Int16:
+            return function(static_cast<const int16_t *>(pixels));
+        case VoxelType::UInt16:
+            return function(static_cast<const uint16_t *>(pixels));
+        case VoxelType::Float32:
+            break;
+        }
+        return function(static_cast<const float *>(pixels));
+    }
+
+    VolumetricImagePointer toFloat() const;
+    VolumeImage toLabels() const;
+
+  private:
+    template <typename Pixel> void assign(itk::Image<Pixel, 3> *typedImage) {
+        if (!typedImage) {
+            return;
+        }
+        auto size3D = typedImage->GetBufferedRegion().GetSize();
+        image = typedImage;
+        pixels = typedImage->GetBufferPointer();
+        voxelType = VoxelTraits<Pixel>::type;
+        dims = {static_cast<int>(size3D[0]), static_cast<int>(size3D[1]), static_cast<int>(size3D[2])};
+    }
+
+    itk::ImageBase<3>::ConstPointer image; // Mantiene vivo el buffer
+    const void *pixels = nullptr;
+    VoxelType voxelType = VoxelType::Float32;
+    std::array<int, 3> dims{};
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "helpers/BrickedVolume.h"
+#include "helpers/Volumetrics.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Estadísticos de una etiqueta de la segmentación sobre el volumen completo
+ * @details Los momentos son de las intensidades originales (float) de los vóxeles con esa
+ * etiqueta; el histograma reparte el rango de intensidades de todo el volumen en 256 bins
+ */
+struct LabelVolumeStats {
+    int label = 0;
+    uint64_t voxels = 0;
+    double volumeMm3 = 0.0; // voxels * volumen de un vóxel según el spacing de ITK
+
+    float minimum = 0.0f;
+    float maximum = 0.0f;
+    double mean = 0.0;
+    double stdDev = 0.0;
+    double skewness = 0.0;
+    double kurtosis = 0.0; // Exceso de curtosis (0 para una normal)
+    std::array<uint64_t, 256> histogram{};
+
+    // Caja envolvente en índices de vóxel, ambos extremos incluidos (x, y, z)
+    std::array<int, 3> boundsMin{};
+    std::array<int, 3> boundsMax{};
+
+    int largestSlice = -1; // Slice axial (Z) con más vóxeles de la etiqueta
+    uint64_t largestSliceArea = 0;
+};
+
+/**
+ * @brief Estadísticos de todo el volumen y su máscara
+ */
+struct VolumeStats {
+    std::array<size_t, 3> size{};
+    std::array<double, 3> spacing{};
+    double voxelVolumeMm3 = 0.0;
+
+    // Rango que cubren los 256 bins de los histogramas (mínimo y máximo de todo el volumen)
+    float histogramMin = 0.0f;
+    float histogramMax = 0.0f;
+
+    std::vector<LabelVolumeStats> labels; // Solo las etiquetas presentes (sin el fondo), en orden
+
+    // Tumor completo: todas las etiquetas distintas de 0 juntas (tumor.label = 0)
+    LabelVolumeStats tumor;
+    std::vector<uint64_t> tumorAreaPerSlice; // Vóxeles de tumor en cada slice axial
+};
+
+namespace VolumeStatistics {
+
+/**
+ * @brief Recorre el volumen y la máscara una vez y calcula los estadísticos de cada etiqueta
+ * @details El volumen se reparte en bloques de slices Z; cada bloque acumula en su propia
+ * estructura (sin locks ni escrituras compartidas) y al final se fusionan. Antes hay una
+ * pasada ligera de mínimo/máximo para fijar el rango de los histogramas
+ * @param image Volumen de intensidades (se lee en su tipo nativo, sin pasarlo a float)
+ * @param mask Máscara de etiquetas del mismo tamaño (uint8; otro tipo se convierte antes)
+ * @param stats Resultado
+ * @param threads Hilos a usar; 0 = todos los núcleos, 1 = en el hilo que llama
+ * @return false si falta alguno de los volúmenes o sus tamaños no coinciden
+ */
+bool compute(const VolumeImage &image, const VolumeImage &mask, VolumeStats &stats, size_t threads = 0);
+
+/**
+ * @brief Igual que compute, pero repartiendo bricks de las copias por bloques
+ * @details Cada bloque de trabajo recorre bricks completos de volumen y máscara, contiguos
+ * en memoria; el resultado es el mismo (los momentos pueden diferir en el último decimal
+ * por el orden de fusión)
+ * @param mask Máscara por bloques uint8, con el mismo tamaño y brickSize que image
+ */
+bool compute(const BrickedVolume &image, const BrickedVolume &mask, VolumeStats &stats, size_t threads = 0);
+
+// Reporte de texto legible (una sección por etiqueta)
+std::string report(const VolumeStats &stats);
+
+// Filas CSV (una por etiqueta y otra para el tumor completo) con csvHeader() como cabecera
+std::string csvHeader();
+std::string csvRows(const std::string &caseName, const VolumeStats &stats);
+
+// Histogramas en formato largo: caso, etiqueta, bin, límite inferior del bin, vóxeles (sin bins vacíos)
+std::string histogramCsvHeader();
+std::string histogramCsvRows(const std::string &caseName, const VolumeStats &stats);
+
+} // namespace VolumeStatistics
@@ -1,12 +1,33 @@
 #pragma once
 
-#include <itkImage.h>
+#include "helpers/BrickedVolume.h"
+#include "helpers/EffectRegistry.h"
+#include "helpers/IntensityWindow.h"
+#include "helpers/OverlayKernels.h"
+#include "helpers/SegmentationLabels.h"
+#include "helpers/VolumeImage.h"
+
+#include <array>
+#include <cstdint>
 #include <itkImageFileReader.h>
+#include <map>
+#include <memory>
 #include <opencv2/core.hpp>
 #include <string>
 
-using VolumetricImageType = itk::Image<float, 3>;
-using VolumetricImagePointer = VolumetricImageType::Pointer;
+struct VolumeStats; // helpers/VolumeStatistics.h
+
+/**
+ * @brief Volumen ya leído (de disco o de VolumeCache), listo para instalarse con setVolume
+ * @details Se puede preparar en cualquier hilo: no toca ningún objeto Volumetrics
+ */
+struct LoadedVolume {
+    std::shared_ptr<const void> mapping; // mmap de VolumeCache; antes que image para destruirse después
+    VolumeImage image; // uint8 para la máscara; tipo nativo del archivo para una modalidad
+    cv::Mat sliceCache; // Caché 8-bit ya construida con window (vacía si no se pidió)
+    std::shared_ptr<const QuantizedVolume> intensity; // Niveles e histograma (nada para la máscara)
+    IntensityWindow window; // Percentiles del volumen hasta que el usuario la cambie
+};
 
 class Volumetrics {
   public:
@@ -14,28 +35,67 @@ class Volumetrics {
     ~Volumetrics();
 
     bool loadVolumetric(std::string path, std::string type = "flair");
+    static bool readVolume(const std::string &path, bool isMask, LoadedVolume &volume, bool buildCache = true);
+    void setVolume(const std::string &type, const LoadedVolume &volume);
+    bool setActiveModality(const std::string &type);
+    bool applyVolumeFilter(EffectId effectId, const EffectParams &params, size_t threads = 0);
+    bool filterVolume(EffectId effectId, const EffectParams &params, LoadedVolume &filtered, size_t threads = 0) const;
+    void installFilteredVolume(const LoadedVolume &filtered);
+    void clearVolumeFilters();
+    void clearVolumes();
 
     void setSliceAsMat();
     void setSliceMaskAsMat();
     void setEffectName(std::string effectName);
+    void setEffectId(EffectId id);
+    void setEffectParams(const EffectParams &params);
     void setSliceIndex(int index);
+    void setSliceCacheEnabled(bool enabled);
+    void setMultiPlanarEnabled(bool enabled);
+    void setBrickedLayoutEnabled(bool enabled);
+    void setLabelColor(int label, const cv::Vec4b &color);
+    void setLabelVisible(int label, bool visible);
+    bool setIntensityWindow(const IntensityWindow &window);
+    void resetIntensityWindow();
 
     cv::Mat getSliceAsMat();
     cv::Mat getSliceMaskAsMat();
+    cv::Mat getSliceAsMat(SliceAxis axis, int index) const;
+    cv::Mat getSliceMaskAsMat(SliceAxis axis, int index) const;
     size_t getDepth() const;
+    int getSliceCount(SliceAxis axis) const;
+    cv::Vec3d getSpacing() const;
+    std::string getActiveModality() const;
+    bool hasModality(const std::string &type) const;
+    bool hasMask() const;
+    bool hasVolumeFilter() const;
+    uint64_t getContentVersion() const;
     std::string getEffectName() const;
+    EffectId getEffectId() const;
+    const EffectParams &getEffectParams() const;
     int getSliceIndex() const;
+    bool isSliceCacheEnabled() const;
+    bool isMultiPlanarEnabled() const;
+    bool isBrickedLayoutEnabled() const;
+    cv::Vec4b getLabelColor(int label) const;
+    bool isLabelVisible(int label) const;
+    IntensityWindow getIntensityWindow() const;
+    IntensityWindow getIntensityRange() const;
+    cv::Mat getSliceView(SliceAxis axis, int index, bool fromMask = false) const;
+    bool computeVolumeStatistics(VolumeStats &stats, size_t threads = 0) const;
 
 
     
     // técnicas de visión artificial
     cv::Mat processSlice(cv::Mat sliceToProceess = cv::Mat());
+    void processSliceInto(const cv::Mat &src, cv::Mat &dst) const;
+    void processSliceInto(const cv::Mat &src, const cv::Mat &mask, cv::Mat &dst) const;
     cv::Mat aplyThreshold(cv::Mat sliceProcessed = cv::Mat(), double umbral = 55.0);
     cv::Mat aplyContratstStreching(cv::Mat sliceProcessed = cv::Mat());
     cv::Mat aplyUmbralBinary();
     cv::Mat aplyBitWiseOperation(cv::Mat sliceProcessed1 = cv::Mat(), std::string type = "AND");
-    cv::Mat aplyCanny(cv::Mat sliceProcessed = cv::Mat());
-    cv::Mat adjustBrightness(cv::Mat sliceProcessed = cv::Mat());
+    cv::Mat aplyCanny(cv::Mat sliceProcessed = cv::Mat(), double lowerThreshold = 50.0, double upperThreshold = 150.0);
+    cv::Mat adjustBrightness(cv::Mat sliceProcessed = cv::Mat(), int valueBrightness = 50);
 
     // Suavizado
     cv::Mat aplyMeanFilter(cv::Mat sliceProcessed = cv::Mat(), int kernelSize = 5);
@@ -54,12 +114,61 @@ class Volumetrics {
     // investigado
     cv::Mat aplyEmbossFilter(cv::Mat sliceProcessed = cv::Mat());
   private:
-    VolumetricImagePointer volumetricImage;
-    VolumetricImagePointer volumetricImageMask;
+    static void prepareIntensity(LoadedVolume &volume, bool buildCache);
+    static cv::Mat buildLabelCache(const VolumeImage &image);
+    static cv::Mat sliceViewOf(const VolumeImage &image, SliceAxis axis, int index);
+    static cv::Mat buildSagittalCache(const cv::Mat &cache, int depth, size_t threads = 0);
+    void rebuildSagittalCaches(bool intensityCache, bool maskCache);
+    void rebuildBrickedVolumes(bool intensityVolume, bool maskVolume);
+    cv::Mat planeOf(const cv::Mat &cache, const cv::Mat &sagittal, const VolumeImage &image, SliceAxis axis, int index,
+                    bool labels) const;
+    static void labelsTo8U(const cv::Mat &src, cv::Mat &dst);
+    cv::Mat binaryMask() const;
+    void rebuildLabelPalette();
+
+    // Todas las modalidades cargadas ("flair", "t1", "t1c", "t2"); la activa se copia abajo
+    std::map<std::string, LoadedVolume> modalities;
+    std::string activeModality = "flair";
+
+    // Si el volumen viene de VolumeCache su buffer es este mmap; se declaran antes que las
+    // imágenes para destruirse después de ellas
+    std::shared_ptr<const void> volumeMapping;
+    std::shared_ptr<const void> volumeMaskMapping;
+
+    VolumeImage volumetricImage;     // Modalidad activa (filtrada en 3D si volumeFiltered)
+    VolumeImage volumetricImageMask; // Siempre uint8
     
     cv::Mat slice;    
-    cv::Mat sliceMask;
+    cv::Mat sliceMask; // Etiquetas de la segmentación tal cual (0, 1, 2, 4), CV_8UC1
+
+    // Caché 8-bit de todo el volumen: (depth * height) x width, un slice tras otro
+    cv::Mat sliceCache;
+    std::shared_ptr<const QuantizedVolume> intensity; // Del volumen mostrado (filtrado o no)
+    IntensityWindow intensityWindow;                  // Con la que se construyó sliceCache
+    cv::Mat sliceMaskCache;
+    bool sliceCacheEnabled = true;
+
+    // Las mismas cachés traspuestas para los cortes sagitales: (width * depth) x height, un
+    // corte X tras otro (filas = Z, columnas = Y). Solo con la vista multiplanar activa
+    cv::Mat sagittalCache;
+    cv::Mat sagittalMaskCache;
+    bool multiPlanarEnabled = false;
+
+    // Copias por bricks de 32³ del volumen mostrado y de la máscara, para los cortes no axiales,
+    // los estadísticos y los filtros 3D. Solo con el almacenamiento por bloques activo
+    BrickedVolume brickedImage;
+    BrickedVolume brickedMask;
+    bool brickedLayoutEnabled = false;
+    bool volumeFiltered = false; // volumetricImage es una copia filtrada de la modalidad activa
+    uint64_t contentVersion = 0; // Cambia con todo lo que altera los slices mostrados
+
+    // Color BGRA y visibilidad de cada etiqueta; labelPalette es lo que consume el kernel
+    std::array<cv::Vec4b, 256> labelColors;
+    std::array<bool, 256> labelVisible;
+    OverlayKernels::LabelPalette labelPalette;
 
     std::string effectName="";    
+    EffectId effectId = EffectId::None; // Resuelto una sola vez en setEffectName/setEffectId
+    EffectParams effectParams;
     int sliceIndex = 0;
 };
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "helpers/Volumetrics.h"
+
+#include <QWidget>
+#include <opencv2/core.hpp>
+
+#include <array>
+
+class QLabel;
+class PlanePane; // src/utils/MultiPlanarView.cpp
+
+/**
+ * @brief Vista multiplanar: cortes axial, coronal y sagital unidos por una cruz común
+ * @details La cruz es un vóxel (x, y, z); cada panel muestra el corte que pasa por ella en su
+ * eje, con la proporción real de los vóxeles y el eje Z hacia arriba en coronal y sagital.
+ * Hacer clic o arrastrar en un panel mueve la cruz en los dos ejes de ese panel y emite
+ * crosshairMoved(); quien la usa extrae los cortes (Volumetrics::getSliceAsMat(axis, index))
+ * y se los pasa con setPlane()
+ */
+class MultiPlanarView : public QWidget {
+    Q_OBJECT
+
+  public:
+    explicit MultiPlanarView(QWidget *parent = nullptr);
+
+    void setVolumeSize(int width, int height, int depth, const cv::Vec3d &spacing);
+    void setCrosshair(int x, int y, int z);
+    void setPlane(SliceAxis axis, const cv::Mat &plane);
+    void clear();
+
+    cv::Vec3i crosshair() const;
+    int indexOf(SliceAxis axis) const;
+
+  signals:
+    void crosshairMoved(int x, int y, int z);
+
+  private:
+    void pick(SliceAxis axis, int column, int row);
+    void updateTitles();
+
+    std::array<PlanePane *, 3> panes; // Axial, coronal, sagital
+    std::array<QLabel *, 3> titles;
+    cv::Vec3i size{0, 0, 0};          // width, height, depth
+    cv::Vec3d spacing{1.0, 1.0, 1.0}; // mm por vóxel en X, Y, Z
+    cv::Vec3i cross{0, 0, 0};
+};
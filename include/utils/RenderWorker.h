@@ -0,0 +1,84 @@
+#pragma once
+
+#include "helpers/SliceRenderer.h"
+#include "helpers/SliceResultCache.h"
+#include "helpers/Volumetrics.h"
+
+#include <QImage>
+#include <QObject>
+#include <QSize>
+#include <opencv2/core.hpp>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/**
+ * @brief Slice a mostrar y tamaño de los dos labels donde se va a pintar
+ */
+struct RenderRequest {
+    SliceResultKey key;
+    bool withProcessed = true; // false: solo el original (aún no hay nada procesado)
+    QSize originalSize;
+    QSize processedSize;
+};
+
+/**
+ * @brief Slice ya renderizado: el procesado (para guardarlo) y las imágenes ya escaladas
+ * @details Las imágenes envuelven los Mat escalados sin copiarlos. Si el original no cambió
+ * respecto al frame anterior (mismo slice y tamaño) se entrega el mismo QImage (igual cacheKey)
+ */
+struct RenderedFrame {
+    SliceResultKey key;
+    bool withProcessed = true;
+    cv::Mat processed;
+    QImage originalImage;
+    QImage processedImage;
+};
+
+/**
+ * @brief Renderiza slices fuera del hilo de la interfaz
+ * @details Extracción, resaltado, efecto, conversión a QImage y escalado corren en un hilo
+ * propio con un SliceRenderer (el mismo paso que SlicePrefetcher). Solo existe una petición pendiente: cada render()
+ * reemplaza la anterior, así que al arrastrar el slider rápido los slices intermedios se
+ * descartan en lugar de encolarse, y la interfaz nunca espera a un filtro caro. El efecto
+ * pasa por la caché de resultados compartida; si no está, mover un parámetro solo rehace el
+ * efecto. frameReady() avisa a la
+ * interfaz, que recoge el último frame con takeFrame()
+ */
+class RenderWorker : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit RenderWorker(SliceResultCache &cache, QObject *parent = nullptr);
+    ~RenderWorker();
+
+    void render(const Volumetrics &volumetrics, const RenderRequest &request);
+    bool takeFrame(RenderedFrame &frame);
+
+  signals:
+    void frameReady();
+
+  private:
+    void workerLoop();
+    bool hasPendingRequest();
+
+    SliceResultCache &cache;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    RenderRequest pending;
+    bool hasPending = false;
+    RenderedFrame latest;
+    bool hasLatest = false;
+    bool stopping = false;
+    VolumetricsSnapshot snapshot; // Lo que se muestra, para el hilo
+
+    // Último original escalado (solo en el hilo de render): cambiar de efecto no lo repite
+    uint64_t scaledVersion = 0;
+    int scaledSlice = -1;
+    QSize scaledSize;
+    QImage scaledOriginal;
+
+    std::thread worker; // Último miembro: arranca con todo lo demás ya construido
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "helpers/SliceRenderer.h"
+#include "helpers/SliceResultCache.h"
+#include "helpers/Volumetrics.h"
+
+#include <QObject>
+#include <opencv2/core.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Slice procesado en segundo plano, listo para guardarse en la caché de resultados
+ */
+struct PrefetchedSlice {
+    SliceResultKey key;
+    cv::Mat result;
+};
+
+/**
+ * @brief Procesa por adelantado los slices vecinos mientras el usuario recorre el volumen
+ * @details Con los últimos movimientos del slider estima la dirección (y el paso) del
+ * recorrido y encola los siguientes slices en esa dirección, más alguno por detrás. Un único
+ * hilo los extrae y procesa con un SliceRenderer, igual que RenderWorker, así que el
+ * resultado es idéntico al que se muestra. Cada request() reemplaza la
+ * cola: un salto a otra zona descarta lo pendiente. slicesReady() avisa a la interfaz, que
+ * recoge los resultados con takeResults() y los guarda en su SliceResultCache
+ */
+class SlicePrefetcher : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit SlicePrefetcher(QObject *parent = nullptr);
+    ~SlicePrefetcher();
+
+    void request(const Volumetrics &volumetrics, const SliceResultKey &current, const SliceResultCache &cache);
+    void cancel();
+    std::vector<PrefetchedSlice> takeResults();
+    void setLookahead(int ahead, int behind);
+
+  signals:
+    void slicesReady();
+
+  private:
+    void workerLoop();
+    std::vector<int> predictTargets(int sliceIndex, int depth);
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<SliceResultKey> jobs;      // Pendientes, en orden de prioridad
+    std::vector<PrefetchedSlice> results; // Listos y aún no recogidos
+    bool stopping = false;
+    VolumetricsSnapshot snapshot; // Lo que se muestra, para el hilo
+
+    // Historial del slider (solo en el hilo de la interfaz)
+    std::deque<int> recentDeltas;
+    int lastIndex = -1;
+    int ahead = 4;
+    int behind = 1;
+
+    std::thread worker; // Último miembro: arranca con todo lo demás ya construido
+};
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <MainWindow.h>
+#include <QImage>
+#include <QSize>
 #include <opencv2/core.hpp>
 #include <opencv2/imgproc.hpp>
 
@@ -8,7 +10,9 @@ namespace Utils {
 
 bool isChecked(Ui::MainWindow *ui);
 
-cv::Mat aplyFilter(Volumetrics volumetrics, cv::Mat processedSlice ,std::string effectName);
+cv::Mat aplyFilter(Volumetrics &volumetrics, const cv::Mat &processedSlice, EffectId effectId);
+
+QImage matToQImage(const cv::Mat &mat, const QSize &size = QSize());
 
 bool generateStatistics(Volumetrics &volumetrics,const cv::Mat &slice,const QString &outputFolder,QWidget *parent);
 
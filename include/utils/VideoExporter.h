@@ -0,0 +1,83 @@
+#pragma once
+
+#include "helpers/FrameSink.h"
+#include "helpers/Volumetrics.h"
+
+#include <QObject>
+#include <QString>
+#include <opencv2/core.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Parámetros de una exportación de video
+ * @details volumetrics es una copia superficial: comparte los buffers ITK y la caché de slices,
+ * cada hilo trabaja sobre su propia copia para no pisar el slice/sliceMask de los demás
+ */
+struct VideoExportJob {
+    Volumetrics volumetrics;
+    EffectId effectId = EffectId::None;
+    bool useImageProcessed = false;
+    int beginSlice = 0;
+    int endSlice = 0; // inclusivo
+    std::string outputPath; // Sin extensión: la añade el formato (o es la carpeta de la secuencia)
+    VideoFormat format = VideoFormats::defaultFormat();
+    double fps = 10.0;
+};
+
+/**
+ * @brief Exportador de video en pipeline: N hilos extraen y filtran slices en paralelo,
+ * un buffer de reordenamiento los entrega en orden y un único hilo los codifica
+ * @details El buffer de reordenamiento es un pool fijo de frames BGR reservado al empezar: la
+ * posición p va siempre al hueco p % huecos, que se reutiliza en cuanto el codificador lo ha
+ * escrito, así que tras los primeros frames ni los workers ni el codificador reservan memoria
+ */
+class VideoExporter : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit VideoExporter(QObject *parent = nullptr);
+    ~VideoExporter();
+
+    bool start(const VideoExportJob &job, int numWorkers = 0);
+    void cancel();
+    bool isRunning() const;
+
+  signals:
+    void progress(int written, int total);
+    void finished(bool ok, const QString &message);
+
+  private:
+    void workerLoop();
+    void encoderLoop();
+    void join();
+
+    VideoExportJob job;
+    int totalFrames = 0;
+    int reorderWindow = 0; // Huecos del pool
+
+    // Hueco del pool: el frame y la posición del video que contiene (-1 = libre o pendiente)
+    struct FrameSlot {
+        cv::Mat frame;
+        int position = -1;
+        bool blank = false; // El pipeline no devolvió imagen para esta posición
+    };
+
+    std::vector<std::thread> workers;
+    std::thread encoder;
+
+    std::mutex mutex;
+    std::condition_variable frameReady;   // worker → encoder
+    std::condition_variable slotReleased; // encoder → workers
+    std::vector<FrameSlot> framePool;     // reorderWindow huecos, reutilizados toda la exportación
+
+    std::atomic<int> nextToRender{0};
+    int nextToWrite = 0;
+    std::atomic<bool> cancelled{false};
+    std::atomic<bool> running{false};
+};
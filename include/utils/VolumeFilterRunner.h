@@ -0,0 +1,43 @@
+#pragma once
+
+#include "helpers/ThreadPool.h"
+#include "helpers/Volumetrics.h"
+
+#include <QObject>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+/**
+ * @brief Aplica un filtro 3D al volumen activo en segundo plano
+ * @details Filtra una copia superficial de Volumetrics en un hilo del pool, de modo que la
+ * interfaz sigue respondiendo mientras tanto. finished se emite al terminar; el resultado se
+ * recoge con take desde el hilo de la interfaz y se instala con
+ * Volumetrics::installFilteredVolume. take lo descarta si el volumen cambió entretanto
+ */
+class VolumeFilterRunner : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit VolumeFilterRunner(QObject *parent = nullptr);
+    ~VolumeFilterRunner();
+
+    bool start(const Volumetrics &volumetrics, EffectId effectId, const EffectParams &params);
+    bool take(const Volumetrics &volumetrics, LoadedVolume &filtered);
+    bool isRunning() const;
+
+  signals:
+    void finished(bool ok);
+
+  private:
+    void run(Volumetrics snapshot, EffectId effectId, EffectParams params);
+
+    std::mutex mutex;
+    LoadedVolume result;      // Filtrado y aún no recogido
+    bool hasResult = false;
+    uint64_t startVersion = 0; // contentVersion del volumen que se está filtrando
+    std::atomic<bool> running{false};
+
+    ThreadPool pool; // Último miembro: sus hilos terminan antes de destruir lo demás
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "helpers/ThreadPool.h"
+#include "helpers/Volumetrics.h"
+
+#include <QObject>
+#include <QString>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Volumen a cargar: tipo ("flair", "t1", "t1c", "t2" o "mask") y ruta
+ */
+struct VolumeRequest {
+    std::string type;
+    std::string path;
+};
+
+/**
+ * @brief Carga en paralelo todas las modalidades de un paciente y su máscara
+ * @details Cada volumen se lee (y se construye su caché 8-bit) en un hilo del pool; la
+ * descompresión es CPU, así que el paciente completo tarda lo que el archivo más lento.
+ * volumeLoaded se emite en cuanto cada volumen está listo, para poder mostrar el primero
+ * sin esperar al resto; el volumen se recoge con takeVolume desde el hilo de la interfaz
+ */
+class VolumeLoader : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit VolumeLoader(QObject *parent = nullptr);
+    ~VolumeLoader();
+
+    void start(const std::vector<VolumeRequest> &requests);
+    bool takeVolume(const std::string &type, LoadedVolume &volume);
+    bool isRunning() const;
+
+  signals:
+    void volumeLoaded(const QString &type, bool ok, const QString &path);
+    void progress(int loaded, int total);
+    void finished(int failed);
+
+  private:
+    void loadOne(unsigned generation, VolumeRequest request);
+
+    std::mutex mutex;
+    std::map<std::string, LoadedVolume> results; // Leídos y aún no recogidos
+    unsigned generation = 0; // Cambia con cada start(): descarta resultados de cargas anteriores
+    int total = 0;
+    int loaded = 0;
+    int failed = 0;
+    std::atomic<bool> running{false};
+
+    ThreadPool pool; // Último miembro: sus hilos terminan antes de destruir lo demás
+};
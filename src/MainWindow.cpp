@@ -9,11 +9,34 @@ using namespace std;
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent),
       ui(new Ui::MainWindow),
+      videoExporter(new VideoExporter(this)),
+      volumeLoader(new VolumeLoader(this)),
+      volumeFilterRunner(new VolumeFilterRunner(this)),
+      slicePrefetcher(new SlicePrefetcher(this)),
+      renderWorker(new RenderWorker(sliceResults, this)),
       currentSliceIndex(0),
       outputFolder("output") {
     // 1) Cargar la interfaz generada por uic
     ui->setupUi(this);
 
+    //* Progreso de la exportación de video (emitido desde el hilo codificador)
+    connect(videoExporter, &VideoExporter::progress, this, &MainWindow::onVideoExportProgress);
+    connect(videoExporter, &VideoExporter::finished, this, &MainWindow::onVideoExportFinished);
+
+    //* Carga en paralelo de las modalidades y la máscara (emitido desde los hilos del pool)
+    connect(volumeLoader, &VolumeLoader::volumeLoaded, this, &MainWindow::onVolumeLoaded);
+    connect(volumeLoader, &VolumeLoader::progress, this, &MainWindow::onVolumeLoadProgress);
+    connect(volumeLoader, &VolumeLoader::finished, this, &MainWindow::onVolumeLoadFinished);
+
+    //* Filtro 3D del menú “Volumen 3D” (emitido desde el hilo del filtro)
+    connect(volumeFilterRunner, &VolumeFilterRunner::finished, this, &MainWindow::onVolumeFilterFinished);
+
+    //* Slices vecinos procesados por adelantado (emitido desde el hilo del prefetcher)
+    connect(slicePrefetcher, &SlicePrefetcher::slicesReady, this, &MainWindow::onSlicesPrefetched);
+
+    //* Slices renderizados (emitido desde el hilo de render)
+    connect(renderWorker, &RenderWorker::frameReady, this, &MainWindow::onFrameRendered);
+
     //|----------| |CONFIGURACIÓN INICIAL DE WIDGETS | |----------|
     //* ComboBox de Brats
     ui->cbImageBrats->addItem("---- Seleccione un volumen ----");
@@ -27,35 +50,11 @@ MainWindow::MainWindow(QWidget *parent)
     ui->slSliceNumber->setValue(0);
     ui->slSliceNumber->setEnabled(false);
 
-    //* ComboBox de efectos de visión
-    ui->cbAplyEffect->addItem("---- Seleccione un efecto ----");
-    ui->cbAplyEffect->addItem("Ninguno");
-    ui->cbAplyEffect->addItem("Threshold");
-    ui->cbAplyEffect->addItem("ContrastStretch");
-    ui->cbAplyEffect->addItem("UmbralBinary");
-    ui->cbAplyEffect->addItem("BitwiseAND");
-    ui->cbAplyEffect->addItem("BitwiseOR");
-    ui->cbAplyEffect->addItem("BitwiseXOR");
-    ui->cbAplyEffect->addItem("Canny");
-    ui->cbAplyEffect->addItem("Brightness");
-
-    // Filtros de suavizado añadidos
-    ui->cbAplyEffect->addItem("MeanFilter");
-    ui->cbAplyEffect->addItem("GaussianFilter");
-    ui->cbAplyEffect->addItem("MedianFilter");
-    ui->cbAplyEffect->addItem("BilateralFilter");
-
-    // Morfologicas
-    ui->cbAplyEffect->addItem("Erosion");
-    ui->cbAplyEffect->addItem("Dilation");
-    ui->cbAplyEffect->addItem("Opening");
-    ui->cbAplyEffect->addItem("Closing");
-
-    // histograma
-    ui->cbAplyEffect->addItem("HistogramEqualization");
-
-    // Investigado
-    ui->cbAplyEffect->addItem("Emboss");
+    //* ComboBox de efectos de visión: se llena desde la tabla de efectos, el id va como dato
+    ui->cbAplyEffect->addItem("---- Seleccione un efecto ----", static_cast<int>(EffectId::None));
+    for (const EffectDescriptor &descriptor : EffectRegistry::all()) {
+        ui->cbAplyEffect->addItem(descriptor.name, static_cast<int>(descriptor.id));
+    }
 
     //* Botones “Guardar Imagen” y “Generar Video” deshabilitados al inicio
     ui->btSaveImage->setEnabled(false);
@@ -63,9 +62,118 @@ MainWindow::MainWindow(QWidget *parent)
 
     //* TextEdit “txtVideoImages” inicialmente vacío
     ui->txtVideoImages->setPlainText("");
+
+    //* Menú “Modalidad”: cada una se habilita cuando termina de cargarse
+    QMenu *modalityMenu = ui->menubar->addMenu("Modalidad");
+    QActionGroup *modalityGroup = new QActionGroup(this);
+    const vector<pair<string, QString>> modalityNames = {
+        {"flair", "FLAIR"}, {"t1", "T1"}, {"t1c", "T1c"}, {"t2", "T2"}};
+    for (const auto &modality : modalityNames) {
+        QAction *action = modalityMenu->addAction(modality.second);
+        action->setCheckable(true);
+        action->setEnabled(false);
+        modalityGroup->addAction(action);
+        modalityActions[modality.first] = action;
+
+        string type = modality.first;
+        connect(action, &QAction::triggered, this, [this, type] { showModality(type); });
+    }
+
+    //* Menú “Etiquetas”: mostrar u ocultar cada etiqueta de la segmentación en el resaltado
+    QMenu *labelsMenu = ui->menubar->addMenu("Etiquetas");
+    for (const SegmentationLabel &label : bratsLabels) {
+        QAction *action = labelsMenu->addAction(QString("%1 - %2").arg(label.value).arg(label.name));
+        action->setCheckable(true);
+        action->setChecked(volumetrics.isLabelVisible(label.value));
+
+        int value = label.value;
+        connect(action, &QAction::toggled, this, [this, value](bool checked) {
+            volumetrics.setLabelVisible(value, checked);
+            refreshProcessedSlice();
+            refreshMultiPlanarView();
+        });
+    }
+
+    //* Menú “Volumen 3D”: filtrar todo el volumen una vez en lugar de cada slice al mostrarlo
+    QMenu *volumeMenu = ui->menubar->addMenu("Volumen 3D");
+    connect(volumeMenu->addAction("Aplicar efecto seleccionado en 3D"), &QAction::triggered, this,
+            &MainWindow::applyEffectToVolume);
+    connect(volumeMenu->addAction("Quitar filtros 3D"), &QAction::triggered, this, &MainWindow::clearVolumeFilters);
+    volumeMenu->addSeparator();
+    QAction *brickedAction = volumeMenu->addAction("Almacenamiento por bloques (32³)");
+    brickedAction->setCheckable(true);
+    brickedAction->setChecked(volumetrics.isBrickedLayoutEnabled());
+    connect(brickedAction, &QAction::toggled, this, [this](bool checked) {
+        QApplication::setOverrideCursor(Qt::WaitCursor);
+        volumetrics.setBrickedLayoutEnabled(checked);
+        QApplication::restoreOverrideCursor();
+    });
+
+    //* Menú “Video”: formato (contenedor y codec, o secuencia de PNG) y fps de “Generar Video”
+    QMenu *videoMenu = ui->menubar->addMenu("Video");
+    QActionGroup *videoFormatGroup = new QActionGroup(this);
+    for (const VideoFormat &format : VideoFormats::all()) {
+        QAction *action = videoMenu->addAction(format.label);
+        action->setCheckable(true);
+        action->setChecked(videoFormat == format.name);
+        videoFormatGroup->addAction(action);
+        string name = format.name;
+        connect(action, &QAction::triggered, this, [this, name] { videoFormat = name; });
+    }
+    videoMenu->addSeparator();
+    connect(videoMenu->addAction("Fotogramas por segundo..."), &QAction::triggered, this, [this] {
+        bool accepted = false;
+        double fps = QInputDialog::getDouble(this, "Video", "Fotogramas por segundo:", videoFps, 1.0, 120.0, 1,
+                                             &accepted);
+        if (accepted) {
+            videoFps = fps;
+        }
+    });
+
+    //* Menú “Depuración”: tiempos por etapa del camino caliente (solo con make TRACE=1)
+    QMenu *debugMenu = ui->menubar->addMenu("Depuración");
+    QAction *traceAction =
+        debugMenu->addAction(Trace::compiledIn ? "Medir tiempos por etapa" : "Medir tiempos (compilar con make TRACE=1)");
+    traceAction->setCheckable(true);
+    traceAction->setChecked(Trace::isEnabled());
+    traceAction->setEnabled(Trace::compiledIn);
+    connect(traceAction, &QAction::toggled, this, [](bool checked) { Trace::setEnabled(checked); });
+    connect(debugMenu->addAction("Ver tiempos por etapa..."), &QAction::triggered, this, &MainWindow::showTraceSummary);
+    connect(debugMenu->addAction("Exportar traza Chrome..."), &QAction::triggered, this, &MainWindow::exportTrace);
+    connect(debugMenu->addAction("Reiniciar medidas"), &QAction::triggered, this, [] { Trace::reset(); });
+
+    //* Panel “Parámetros del efecto”: se rehace al cambiar de efecto
+    effectParamsDock = new QDockWidget("Parámetros del efecto", this);
+    addDockWidget(Qt::RightDockWidgetArea, effectParamsDock);
+    rebuildEffectParamsPanel();
+
+    //* Panel “Ventana de intensidad”: se rehace al cambiar el volumen mostrado
+    intensityWindowDock = new QDockWidget("Ventana de intensidad", this);
+    addDockWidget(Qt::RightDockWidgetArea, intensityWindowDock);
+    rebuildIntensityWindowPanel();
+
+    //* Panel “Vista multiplanar”: oculto hasta abrirlo desde el menú “Vista”; mientras se ve,
+    //  Volumetrics mantiene las cachés sagitales
+    multiPlanarView = new MultiPlanarView;
+    multiPlanarDock = new QDockWidget("Vista multiplanar", this);
+    multiPlanarDock->setWidget(multiPlanarView);
+    addDockWidget(Qt::BottomDockWidgetArea, multiPlanarDock);
+    multiPlanarDock->hide();
+    connect(multiPlanarView, &MultiPlanarView::crosshairMoved, this, &MainWindow::onCrosshairMoved);
+    connect(multiPlanarDock, &QDockWidget::visibilityChanged, this, [this](bool visible) {
+        volumetrics.setMultiPlanarEnabled(visible);
+        refreshMultiPlanarView();
+    });
+
+    QMenu *viewMenu = ui->menubar->addMenu("Vista");
+    QAction *multiPlanarAction = multiPlanarDock->toggleViewAction();
+    multiPlanarAction->setText("Vista multiplanar (axial/coronal/sagital)");
+    viewMenu->addAction(multiPlanarAction);
 }
 
 MainWindow::~MainWindow() {
+    // Antes que sliceResults: el hilo de render la usa
+    delete renderWorker;
     delete ui;
 }
 
@@ -84,20 +192,101 @@ void MainWindow::on_btLoadImage_clicked() {
     }
     BratsPaths paths = allBratsMap.at(optionUser);
 
-    // Cargar volumen FLAIR
-    bool okFlair = volumetrics.loadVolumetric(paths.standar, "flair");
-    if (!okFlair) {
-        ui->statusbar->showMessage("Error cargando FLAIR: " + QString::fromStdString(paths.standar));
+    // Descartar el paciente anterior y lo que se estuviera mostrando
+    volumetrics.clearVolumes();
+    currentSlice.release();
+    currentMask.release();
+    processedSlice.release();
+    ui->slSliceNumber->setEnabled(false);
+    ui->btSaveImage->setEnabled(false);
+    ui->btGenerateVideo->setEnabled(false);
+    ui->lbSliceImageProcessed->setText("Sin procesar");
+    ui->lbSliceImageProcessed->setPixmap(QPixmap());
+    for (auto &entry : modalityActions) {
+        entry.second->setEnabled(false);
+    }
+    multiPlanarView->clear();
+
+    // Las cinco lecturas van en paralelo; cada una avisa al terminar (onVolumeLoaded)
+    volumeLoader->start({
+        {"flair", paths.standar},
+        {"t1", paths.t1},
+        {"t1c", paths.t1c},
+        {"t2", paths.t2},
+        {"mask", paths.mask},
+    });
+    ui->statusbar->showMessage("Cargando volúmenes de " + qOption + "...");
+}
+
+/**
+ * @brief Se ejecuta (en el hilo de la interfaz) cada vez que VolumeLoader termina un volumen
+ * @param type "flair", "t1", "t1c", "t2" o "mask"
+ * @param ok false si no se pudo leer
+ * @param path Ruta del volumen
+ */
+void MainWindow::onVolumeLoaded(const QString &type, bool ok, const QString &path) {
+    if (!ok) {
+        ui->statusbar->showMessage("Error cargando " + type.toUpper() + ": " + path);
         return;
     }
 
-    // Cargar volumen MÁSCARA
-    bool okMask = volumetrics.loadVolumetric(paths.mask, "mask");
-    if (!okMask) {
-        ui->statusbar->showMessage("Error cargando MASK: " + QString::fromStdString(paths.mask));
+    string volumeType = type.toStdString();
+    LoadedVolume volume;
+    if (!volumeLoader->takeVolume(volumeType, volume)) {
+        return; // Resultado de un paciente anterior
+    }
+    volumetrics.setVolume(volumeType, volume);
+
+    if (volumeType == "mask") {
+        // Si el slice ya se muestra, completar con la máscara
+        if (!currentSlice.empty()) {
+            volumetrics.setSliceMaskAsMat();
+            currentMask = volumetrics.getSliceMaskAsMat();
+            ui->btGenerateVideo->setEnabled(true);
+            refreshMultiPlanarView();
+        }
         return;
     }
 
+    auto action = modalityActions.find(volumeType);
+    if (action != modalityActions.end()) {
+        action->second->setEnabled(true);
+    }
+
+    // La primera modalidad disponible se muestra sin esperar al resto
+    if (currentSlice.empty() && volumetrics.setActiveModality(volumeType)) {
+        if (action != modalityActions.end()) {
+            action->second->setChecked(true);
+        }
+        showLoadedVolume();
+    }
+}
+
+/**
+ * @brief Progreso de la carga de volúmenes
+ */
+void MainWindow::onVolumeLoadProgress(int loaded, int total) {
+    if (loaded < total) {
+        ui->statusbar->showMessage(QString("Cargando volúmenes: %1/%2").arg(loaded).arg(total));
+    }
+}
+
+/**
+ * @brief Fin de la carga de todos los volúmenes del paciente
+ * @param failed Cuántos no se pudieron leer
+ */
+void MainWindow::onVolumeLoadFinished(int failed) {
+    if (failed == 0) {
+        ui->statusbar->showMessage("Volumen cargado correctamente.");
+    } else {
+        ui->statusbar->showMessage(QString("Carga terminada: %1 volumen(es) con error.").arg(failed));
+    }
+}
+
+/**
+ * @brief Configura el slider y muestra el slice 0 de la modalidad activa
+ */
+void MainWindow::showLoadedVolume() {
     // Obtener profundidad total (cantidad de slices en Z)
     size_t depth = volumetrics.getDepth();
     if (depth == 0) {
@@ -110,28 +299,118 @@ void MainWindow::on_btLoadImage_clicked() {
     ui->slSliceNumber->setMinimum(0);
     ui->slSliceNumber->setMaximum(static_cast<int>(depth) - 1);
     ui->slSliceNumber->setValue(0);
+    volumetrics.setSliceIndex(0);
 
     // Mostrar “0” en la etiqueta lbSliceNum
     ui->lbSliceNum->setText("0");
+    rebuildIntensityWindowPanel();
 
-    // Extraer y mostrar slice Z=0
-
+    // Extraer y mostrar slice Z=0 (la máscara puede llegar después)
     volumetrics.setSliceAsMat();
-    volumetrics.setSliceMaskAsMat();
     currentSlice = volumetrics.getSliceAsMat();
-    currentMask = volumetrics.getSliceMaskAsMat();
-    showSliceOnLabel(currentSlice, ui->lbSliceImage);
+    if (volumetrics.hasMask()) {
+        volumetrics.setSliceMaskAsMat();
+        currentMask = volumetrics.getSliceMaskAsMat();
+    }
+    requestRender(false);
 
     // Limpiar label procesado (aún no hay)
     ui->lbSliceImageProcessed->setText("Sin procesar");
     ui->lbSliceImageProcessed->setPixmap(QPixmap());
     processedSlice.release();
 
-    // Habilitar botones de “Guardar Imagen” y “Generar Video”
+    // Habilitar “Guardar Imagen”; “Generar Video” necesita además la máscara
     ui->btSaveImage->setEnabled(true);
-    ui->btGenerateVideo->setEnabled(true);
+    ui->btGenerateVideo->setEnabled(!currentMask.empty());
+
+    // La cruz de la vista multiplanar empieza en el centro del slice 0
+    multiPlanarView->setVolumeSize(volumetrics.getSliceCount(SliceAxis::Sagittal),
+                                   volumetrics.getSliceCount(SliceAxis::Coronal), static_cast<int>(depth),
+                                   volumetrics.getSpacing());
+    Vec3i cross = multiPlanarView->crosshair();
+    multiPlanarView->setCrosshair(cross[0], cross[1], 0);
+    refreshMultiPlanarView();
+}
+
+/**
+ * @brief Cambia la modalidad mostrada (menú “Modalidad”) conservando el slice actual
+ */
+void MainWindow::showModality(const string &type) {
+    if (!volumetrics.setActiveModality(type) || currentSlice.empty()) {
+        return;
+    }
+    rebuildIntensityWindowPanel();
+    showCurrentSlice();
+}
+
+/**
+ * @brief Filtra todo el volumen con el efecto seleccionado (menú “Volumen 3D”)
+ * @details Filtra en segundo plano; el resultado se muestra en onVolumeFilterFinished y el
+ * efecto 2D se quita entonces para no aplicarlo dos veces sobre cada slice
+ */
+void MainWindow::applyEffectToVolume() {
+    EffectId effectId = volumetrics.getEffectId();
+    if (currentSlice.empty()) {
+        ui->statusbar->showMessage("No hay volumen cargado para filtrar.");
+        return;
+    }
+    if (!VolumeFilters::supports(effectId)) {
+        ui->statusbar->showMessage("El efecto seleccionado no tiene versión 3D (media, gaussiano, mediana o morfología).");
+        return;
+    }
 
-    ui->statusbar->showMessage("Volumen cargado correctamente.");
+    if (!volumeFilterRunner->start(volumetrics, effectId, volumetrics.getEffectParams())) {
+        ui->statusbar->showMessage("Ya hay un filtro 3D en curso.");
+        return;
+    }
+    filteringEffectName = EffectRegistry::get(effectId).name;
+    ui->statusbar->showMessage("Filtrando el volumen en 3D: " + filteringEffectName + "...");
+}
+
+/**
+ * @brief Muestra el volumen filtrado en 3D cuando el filtro termina (hilo de la interfaz)
+ * @details Si entretanto se cambió de modalidad, de paciente o de filtros, el resultado ya no
+ * corresponde a lo que se muestra y se descarta
+ */
+void MainWindow::onVolumeFilterFinished(bool ok) {
+    LoadedVolume filtered;
+    if (!ok) {
+        ui->statusbar->showMessage("No se pudo filtrar el volumen.");
+        return;
+    }
+    if (!volumeFilterRunner->take(volumetrics, filtered)) {
+        ui->statusbar->showMessage("El volumen cambió mientras se filtraba; se descartó el filtro 3D.");
+        return;
+    }
+
+    volumetrics.installFilteredVolume(filtered);
+    ui->cbAplyEffect->setCurrentIndex(0);
+    rebuildIntensityWindowPanel();
+    showCurrentSlice();
+    ui->statusbar->showMessage("Volumen filtrado en 3D: " + filteringEffectName);
+}
+
+/**
+ * @brief Vuelve a la modalidad sin filtrar (menú “Volumen 3D”)
+ */
+void MainWindow::clearVolumeFilters() {
+    if (!volumetrics.hasVolumeFilter()) {
+        return;
+    }
+    volumetrics.clearVolumeFilters();
+    rebuildIntensityWindowPanel();
+    showCurrentSlice();
+    ui->statusbar->showMessage("Filtros 3D quitados.");
+}
+
+/**
+ * @brief Vuelve a extraer y mostrar el slice actual (tras cambiar el volumen mostrado)
+ */
+void MainWindow::showCurrentSlice() {
+    volumetrics.setSliceAsMat();
+    currentSlice = volumetrics.getSliceAsMat();
+    requestRender(!processedSlice.empty());
+    refreshMultiPlanarView();
 }
 
 /**
@@ -142,27 +421,62 @@ void MainWindow::on_slSliceNumber_valueChanged(int value) {
     volumetrics.setSliceIndex(value);
     ui->lbSliceNum->setText(QString::number(value));
 
-    // Extraer slice y máscara en el nuevo índice
+    // Extraer slice y máscara en el nuevo índice (vistas sobre la caché 8-bit, no cuesta nada)
     volumetrics.setSliceAsMat();
-    volumetrics.setSliceMaskAsMat();
     currentSlice = volumetrics.getSliceAsMat();
-    currentMask = volumetrics.getSliceMaskAsMat();
+    if (volumetrics.hasMask()) {
+        volumetrics.setSliceMaskAsMat();
+        currentMask = volumetrics.getSliceMaskAsMat();
+    }
 
-    // Mostrar slice original
-    showSliceOnLabel(currentSlice, ui->lbSliceImage);
+    // Procesado, conversión y escalado van al hilo de render; los labels se pintan al llegar
+    requestRender(true);
 
-    // Si “Usar Imagen Destacada” está marcado, mostrar processedSlice
-    if (Utils::isChecked(ui) && !processedSlice.empty()) {
-        showSliceOnLabel(processedSlice, ui->lbSliceImageProcessed);
-    } else {
-        ui->lbSliceImageProcessed->setText("Sin procesar");
-        ui->lbSliceImageProcessed->setPixmap(QPixmap());
-    }
+    // La cruz sigue al slider: coronal y sagital marcan el nuevo Z
+    Vec3i cross = multiPlanarView->crosshair();
+    multiPlanarView->setCrosshair(cross[0], cross[1], value);
+    refreshMultiPlanarView();
+}
 
-    processedSlice = Utils::isChecked(ui) ? volumetrics.processSlice() : volumetrics.getSliceAsMat();
-    processedSlice = Utils::aplyFilter(volumetrics, processedSlice, volumetrics.getEffectName());
+/**
+ * @brief Se movió la cruz de la vista multiplanar: el slider sigue a su Z
+ * @details Si el Z cambia, on_slSliceNumber_valueChanged muestra el slice y refresca los
+ * tres cortes; si no, solo cambian coronal y sagital
+ */
+void MainWindow::onCrosshairMoved(int /*x*/, int /*y*/, int z) {
+    if (ui->slSliceNumber->isEnabled() && ui->slSliceNumber->value() != z) {
+        ui->slSliceNumber->setValue(z);
+        return;
+    }
+    refreshMultiPlanarView();
+}
 
-    showSliceOnLabel(processedSlice, ui->lbSliceImageProcessed);
+/**
+ * @brief Vuelve a pintar los tres cortes que pasan por la cruz de la vista multiplanar
+ * @details Se hace en el hilo de la interfaz: con la caché activa los tres cortes salen de
+ * memoria contigua (axial y coronal de la caché 8-bit, sagital de su copia traspuesta), así
+ * que casi todo el coste es el resaltado de la máscara, si está marcado. El efecto 2D se ve
+ * solo en el panel principal
+ */
+void MainWindow::refreshMultiPlanarView() {
+    if (!multiPlanarDock->isVisible() || currentSlice.empty()) {
+        return;
+    }
+    TRACE_SCOPE("MainWindow::refreshMultiPlanarView");
+
+    bool overlay = Utils::isChecked(ui) && volumetrics.hasMask();
+    for (SliceAxis axis : {SliceAxis::Axial, SliceAxis::Coronal, SliceAxis::Sagittal}) {
+        int index = multiPlanarView->indexOf(axis);
+        Mat plane = volumetrics.getSliceAsMat(axis, index);
+        if (overlay && !plane.empty()) {
+            Mat highlighted;
+            volumetrics.processSliceInto(plane, volumetrics.getSliceMaskAsMat(axis, index), highlighted);
+            if (!highlighted.empty()) {
+                plane = highlighted;
+            }
+        }
+        multiPlanarView->setPlane(axis, plane);
+    }
 }
 
 /**
@@ -170,33 +484,244 @@ void MainWindow::on_slSliceNumber_valueChanged(int value) {
  * @param index Nuevo valor del combo
  */
 void MainWindow::on_cbAplyEffect_currentIndexChanged(int /*index*/) {
-    // Si no hay slice ni máscara, no hacemos nada
+    // El combo guarda el id de cada efecto como dato: no hace falta buscar el nombre
+    volumetrics.setEffectId(static_cast<EffectId>(ui->cbAplyEffect->currentData().toInt()));
+    rebuildEffectParamsPanel();
+
+    // Si no hay slice ni máscara, no hay nada que mostrar todavía
     if (currentSlice.empty() || currentMask.empty()) {
         return;
     }
 
-    QString fx = ui->cbAplyEffect->currentText();
-    volumetrics.setEffectName(fx.toStdString());
+    requestRender(true);
+}
+
+/**
+ * @brief Recalcula y muestra el slice procesado (p. ej. al cambiar las etiquetas visibles)
+ */
+void MainWindow::refreshProcessedSlice() {
+    if (currentSlice.empty() || currentMask.empty() || processedSlice.empty()) {
+        return;
+    }
+
+    requestRender(true);
+}
+
+/**
+ * @brief Pide al hilo de render el slice actual con el resaltado (si está marcado) y el efecto
+ * @details Las peticiones no se encolan: si el usuario sigue moviendo el slider solo se
+ * renderiza la última. El procesado pasa por la caché LRU de resultados, y mientras tanto el
+ * prefetcher prepara los vecinos en la dirección del recorrido
+ * @param withProcessed false para pintar solo el original (aún no hay nada procesado)
+ */
+void MainWindow::requestRender(bool withProcessed) {
+    TRACE_SCOPE("MainWindow::requestRender");
+    RenderRequest request;
+    request.key.contentVersion = volumetrics.getContentVersion();
+    request.key.sliceIndex = volumetrics.getSliceIndex();
+    request.key.effectId = volumetrics.getEffectId();
+    request.key.params = volumetrics.getEffectParams();
+    request.key.overlay = Utils::isChecked(ui);
+    request.withProcessed = withProcessed;
+    request.originalSize = ui->lbSliceImage->size();
+    request.processedSize = ui->lbSliceImageProcessed->size();
+
+    lastRender = request;
+    renderWorker->render(volumetrics, request);
+    if (withProcessed) {
+        slicePrefetcher->request(volumetrics, request.key, sliceResults);
+    }
+}
+
+/**
+ * @brief Pinta el slice que terminó el hilo de render (si sigue siendo el último pedido)
+ */
+void MainWindow::onFrameRendered() {
+    TRACE_SCOPE("MainWindow::onFrameRendered");
+    RenderedFrame frame;
+    if (!renderWorker->takeFrame(frame) || !(frame.key == lastRender.key) ||
+        frame.withProcessed != lastRender.withProcessed) {
+        return;
+    }
+
+    // Cambiar de efecto o de resaltado no cambia el original: el pixmap pintado sigue valiendo
+    if (frame.originalImage.cacheKey() != shownOriginalKey) {
+        ui->lbSliceImage->setPixmap(QPixmap::fromImage(frame.originalImage));
+        ui->lbSliceImage->setText("");
+        shownOriginalKey = frame.originalImage.cacheKey();
+    }
+    if (!frame.withProcessed) {
+        return;
+    }
+
+    processedSlice = frame.processed;
+    if (frame.processedImage.isNull()) {
+        ui->lbSliceImageProcessed->setText("Sin imagen");
+        ui->lbSliceImageProcessed->setPixmap(QPixmap());
+        return;
+    }
+    ui->lbSliceImageProcessed->setPixmap(QPixmap::fromImage(frame.processedImage));
+    ui->lbSliceImageProcessed->setText("");
+
+    // Con las medidas activas, la barra de estado muestra el coste de cada frame
+    Trace::StageStats stats;
+    if (Trace::isEnabled() && Trace::stageSummary("RenderWorker::frame", stats)) {
+        ui->statusbar->showMessage(QString("Frame: %1 ms | p50 %2 | p95 %3 | p99 %4 ms (%5 frames)")
+                                       .arg(stats.lastMs, 0, 'f', 1)
+                                       .arg(stats.p50Ms, 0, 'f', 1)
+                                       .arg(stats.p95Ms, 0, 'f', 1)
+                                       .arg(stats.p99Ms, 0, 'f', 1)
+                                       .arg(stats.count));
+    }
+}
+
+/**
+ * @brief Crea un slider por cada parámetro del efecto seleccionado
+ * @details Mover un slider solo cambia ese parámetro: el hilo de render conserva el resaltado
+ * del slice (EffectGraph) y rehace únicamente el efecto, y mientras se arrastra solo se
+ * renderiza la última posición
+ */
+void MainWindow::rebuildEffectParamsPanel() {
+    QWidget *panel = new QWidget;
+    QFormLayout *layout = new QFormLayout(panel);
+
+    vector<EffectParamId> params = EffectRegistry::paramsOf(volumetrics.getEffectId());
+    if (params.empty()) {
+        layout->addRow(new QLabel("El efecto seleccionado no tiene parámetros."));
+    }
+
+    for (EffectParamId id : params) {
+        const EffectParamSpec &spec = EffectRegistry::paramSpec(id);
+        double value = EffectRegistry::getParam(volumetrics.getEffectParams(), id);
+
+        // El slider trabaja en pasos enteros: posición k = minimum + k * step
+        QSlider *slider = new QSlider(Qt::Horizontal);
+        slider->setRange(0, static_cast<int>(lround((spec.maximum - spec.minimum) / spec.step)));
+        slider->setValue(static_cast<int>(lround((value - spec.minimum) / spec.step)));
+        QLabel *valueLabel = new QLabel(QString::number(value));
+        valueLabel->setMinimumWidth(40);
+
+        QHBoxLayout *row = new QHBoxLayout;
+        row->addWidget(slider);
+        row->addWidget(valueLabel);
+        layout->addRow(spec.label, row);
+
+        connect(slider, &QSlider::valueChanged, this, [this, id, valueLabel](int position) {
+            const EffectParamSpec &spec = EffectRegistry::paramSpec(id);
+            EffectParams params = volumetrics.getEffectParams();
+            double value = EffectRegistry::setParam(params, id, spec.minimum + position * spec.step);
+            volumetrics.setEffectParams(params);
+            valueLabel->setText(QString::number(value));
+            refreshProcessedSlice();
+        });
+    }
+
+    QWidget *previous = effectParamsDock->widget();
+    effectParamsDock->setWidget(panel);
+    if (previous) {
+        previous->deleteLater();
+    }
+}
+
+/**
+ * @brief Rehace los sliders de centro y ancho de la ventana para el volumen mostrado
+ * @details Los sliders recorren el rango de intensidades del volumen en mil pasos. Mover uno
+ * rehace la caché 8-bit desde los niveles cuantizados (sin releer los float) y vuelve a
+ * pedir el slice actual; "Percentiles" vuelve a la ventana calculada al cargar
+ */
+void MainWindow::rebuildIntensityWindowPanel() {
+    QWidget *panel = new QWidget;
+    QFormLayout *layout = new QFormLayout(panel);
+
+    IntensityWindow range = volumetrics.getIntensityRange();
+    if (!range.isValid()) {
+        layout->addRow(new QLabel("Sin volumen cargado."));
+    } else {
+        const int steps = 1000;
+        const double step = range.width() / steps;
+        IntensityWindow window = volumetrics.getIntensityWindow();
+
+        QSlider *centerSlider = new QSlider(Qt::Horizontal);
+        centerSlider->setRange(0, steps);
+        centerSlider->setValue(static_cast<int>(lround((window.center() - range.low) / step)));
+        QSlider *widthSlider = new QSlider(Qt::Horizontal);
+        widthSlider->setRange(1, steps);
+        widthSlider->setValue(max(1, static_cast<int>(lround(window.width() / step))));
+
+        QLabel *centerLabel = new QLabel(QString::number(window.center(), 'f', 1));
+        QLabel *widthLabel = new QLabel(QString::number(window.width(), 'f', 1));
+        centerLabel->setMinimumWidth(60);
+        widthLabel->setMinimumWidth(60);
+
+        QHBoxLayout *centerRow = new QHBoxLayout;
+        centerRow->addWidget(centerSlider);
+        centerRow->addWidget(centerLabel);
+        layout->addRow("Centro", centerRow);
+        QHBoxLayout *widthRow = new QHBoxLayout;
+        widthRow->addWidget(widthSlider);
+        widthRow->addWidget(widthLabel);
+        layout->addRow("Ancho", widthRow);
+
+        // Cada ventana nueva rehace la caché 8-bit de todo el volumen (y la sagital), así que
+        // mientras se arrastra solo cambian las etiquetas y se aplica al soltar el slider
+        centerSlider->setTracking(false);
+        widthSlider->setTracking(false);
+        auto windowAt = [range, step, centerSlider, widthSlider] {
+            return IntensityWindow::fromCenterWidth(range.low + centerSlider->sliderPosition() * step,
+                                                    widthSlider->sliderPosition() * step);
+        };
+        auto updateLabels = [windowAt, centerLabel, widthLabel] {
+            IntensityWindow window = windowAt();
+            centerLabel->setText(QString::number(window.center(), 'f', 1));
+            widthLabel->setText(QString::number(window.width(), 'f', 1));
+        };
+        auto applyWindow = [this, windowAt, updateLabels] {
+            updateLabels();
+            if (volumetrics.setIntensityWindow(windowAt()) && !currentSlice.empty()) {
+                showCurrentSlice();
+            }
+        };
+        connect(centerSlider, &QSlider::sliderMoved, this, updateLabels);
+        connect(widthSlider, &QSlider::sliderMoved, this, updateLabels);
+        connect(centerSlider, &QSlider::valueChanged, this, applyWindow);
+        connect(widthSlider, &QSlider::valueChanged, this, applyWindow);
+
+        QPushButton *resetButton = new QPushButton("Percentiles");
+        layout->addRow(resetButton);
+        connect(resetButton, &QPushButton::clicked, this, [this] {
+            volumetrics.resetIntensityWindow();
+            rebuildIntensityWindowPanel();
+            if (!currentSlice.empty()) {
+                showCurrentSlice();
+            }
+        });
+    }
 
-    processedSlice = Utils::isChecked(ui) ? volumetrics.processSlice() : volumetrics.getSliceAsMat();
-    processedSlice = Utils::aplyFilter(volumetrics, processedSlice, volumetrics.getEffectName());
+    QWidget *previous = intensityWindowDock->widget();
+    intensityWindowDock->setWidget(panel);
+    if (previous) {
+        previous->deleteLater();
+    }
+}
 
-    showSliceOnLabel(processedSlice, ui->lbSliceImageProcessed);
+/**
+ * @brief Guarda en la caché los slices que el prefetcher ya procesó
+ */
+void MainWindow::onSlicesPrefetched() {
+    for (PrefetchedSlice &prefetched : slicePrefetcher->takeResults()) {
+        sliceResults.insert(prefetched.key, prefetched.result);
+    }
 }
 
 /**
  * @brief Función que se ejecuta cuando se marca/desmarca el checkbox chUseImageProcessed
  * @param checked Nuevo valor del checkbox
  */
-void MainWindow::on_chUseImageProcessed_toggled(bool checked) {
+void MainWindow::on_chUseImageProcessed_toggled(bool /*checked*/) {
+    refreshMultiPlanarView();
+    // requestRender lee el estado del checkbox: volver a marcarlo sale de la caché
     if (!processedSlice.empty()) {
-        if (checked) {
-            processedSlice = (volumetrics.getEffectName().empty()) ? volumetrics.processSlice() : Utils::aplyFilter(volumetrics, volumetrics.processSlice(), volumetrics.getEffectName());
-        } else {
-            processedSlice = (volumetrics.getEffectName().empty()) ? volumetrics.getSliceAsMat() : Utils::aplyFilter(volumetrics, volumetrics.getSliceAsMat(), volumetrics.getEffectName());
-        }
-
-        showSliceOnLabel(processedSlice, ui->lbSliceImageProcessed);
+        requestRender(true);
     }
 }
 
@@ -284,10 +809,6 @@ void MainWindow::on_btGenerateVideo_clicked() {
         return;
     }
 
-    // 4) Obtener el nombre del efecto y si usar processedSlice
-    QString fx = ui->cbAplyEffect->currentText();
-    string effectName = fx.toStdString();
-
     QString qNumberSlicesToVideo = ui->txtVideoImages->toPlainText();
     string slicesToVideo = qNumberSlicesToVideo.toStdString();
     numberSlicesToVideo = atoi(slicesToVideo.c_str()) / 2;
@@ -296,115 +817,98 @@ void MainWindow::on_btGenerateVideo_clicked() {
     int beginSlice = (currentIndex - numberSlicesToVideo) < 0 ? 0 : (currentIndex - numberSlicesToVideo);
     int endSlice = (currentIndex + numberSlicesToVideo) > static_cast<int>(depth) ? static_cast<int>(depth) : (currentIndex + numberSlicesToVideo);
 
-    // 6) Extraer la primera imagen para conocer tamaño (width, height)
-    volumetrics.setSliceIndex(beginSlice);
-    volumetrics.setSliceAsMat();
-    volumetrics.setSliceMaskAsMat();
-
-    Mat firstFrame = Utils::isChecked(ui) ? volumetrics.processSlice() : volumetrics.getSliceAsMat();
-    firstFrame = Utils::aplyFilter(volumetrics, firstFrame, effectName);
-
-    if (firstFrame.empty()) {
-        ui->statusbar->showMessage("No se pudo obtener el primer slice para el video.");
+    // 5) Preparar el trabajo: el pipeline trabaja sobre copias de volumetrics en otros hilos
+    VideoExportJob job;
+    job.volumetrics = volumetrics;
+    job.effectId = volumetrics.getEffectId();
+    job.useImageProcessed = Utils::isChecked(ui);
+    job.beginSlice = beginSlice;
+    job.endSlice = min(endSlice, static_cast<int>(depth) - 1);
+
+    //    - Formato y fps del menú “Video”; el nombre lleva la modalidad y el rango, así que
+    //      exportar otro rango no pisa el anterior (la extensión la pone el formato)
+    QString videoName = QString("video_%1_%2-%3")
+                            .arg(QString::fromStdString(volumetrics.getActiveModality()))
+                            .arg(job.beginSlice)
+                            .arg(job.endSlice);
+    job.outputPath = QDir(outputFolder).filePath(videoName).toStdString();
+    job.format = *VideoFormats::find(videoFormat);
+    job.fps = videoFps;
+
+    // 6) Lanzar la exportación; el progreso y el resultado llegan por señales
+    if (!videoExporter->start(job)) {
+        ui->statusbar->showMessage("Ya hay un video generándose o el rango de slices está vacío.");
         return;
     }
+    ui->btGenerateVideo->setEnabled(false);
+    ui->statusbar->showMessage("Generando video...");
+}
 
-    // Asegurarse de que el primer frame esté en BGR (VideoWriter espera color)
-    cv::Mat colorFirst;
-    if (firstFrame.channels() == 1) {
-        cv::cvtColor(firstFrame, colorFirst, cv::COLOR_GRAY2BGR);
-    } else {
-        colorFirst = firstFrame;
-    }
-
-    int frameWidth = colorFirst.cols;
-    int frameHeight = colorFirst.rows;
+/**
+ * @brief Actualiza la barra de estado con el avance de la exportación de video
+ */
+void MainWindow::onVideoExportProgress(int written, int total) {
+    ui->statusbar->showMessage(QString("Generando video... %1/%2 slices").arg(written).arg(total));
+}
 
-    // 7) Crear el archivo de video (.mp4)
-    //    - Usamos el codec H.264 (mp4v suele funcionar en la mayoría de instalaciones)
-    //    - Elegimos, por ejemplo, 10 fps (puedes modificar ese valor si lo deseas)
-    QString videoName = QDir(outputFolder).filePath("output_video.mp4");
-    std::string videoPath = videoName.toStdString();
-    int fourcc = cv::VideoWriter::fourcc('m', 'p', '4', 'v');
-    double fps = 10.0;
+/**
+ * @brief Se ejecuta cuando termina la exportación de video
+ */
+void MainWindow::onVideoExportFinished(bool ok, const QString &message) {
+    ui->btGenerateVideo->setEnabled(true);
+    ui->statusbar->showMessage(ok ? message : "Error: " + message);
+}
 
-    cv::VideoWriter writer;
-    writer.open(videoPath, fourcc, fps, cv::Size(frameWidth, frameHeight), /*isColor=*/true);
-    if (!writer.isOpened()) {
-        ui->statusbar->showMessage("No se pudo crear el archivo de video: " + videoName);
+/**
+ * @brief Si cambió el tamaño de los labels, vuelve a escalar el slice mostrado
+ * @details Es el único caso en que el original se vuelve a escalar sin cambiar de slice
+ */
+void MainWindow::resizeEvent(QResizeEvent *event) {
+    QMainWindow::resizeEvent(event);
+    if (currentSlice.empty()) {
         return;
     }
-
-    // 8) Iterar sobre cada slice y escribirlo al video
-    for (int index = beginSlice; index <= endSlice; ++index) {
-        volumetrics.setSliceIndex(index);
-        volumetrics.setSliceAsMat();
-        volumetrics.setSliceMaskAsMat();
-
-        cv::Mat sliceOut = Utils::isChecked(ui) ? volumetrics.processSlice() : volumetrics.getSliceAsMat();
-        sliceOut = Utils::aplyFilter(volumetrics, sliceOut, effectName);
-
-        if (sliceOut.empty()) {
-            continue;
-        }
-
-        // Convertir a BGR si es que está en gris
-        cv::Mat colorFrame;
-        if (sliceOut.channels() == 1) {
-            cv::cvtColor(sliceOut, colorFrame, cv::COLOR_GRAY2BGR);
-        } else {
-            colorFrame = sliceOut;
-        }
-
-        // Redimensionar sólo si difiere del tamaño inicial (opcional, pero mantendremos fijo)
-        if (colorFrame.cols != frameWidth || colorFrame.rows != frameHeight) {
-            cv::resize(colorFrame, colorFrame, cv::Size(frameWidth, frameHeight));
-        }
-
-        // Escribir el fotograma en el video
-        writer.write(colorFrame);
+    if (ui->lbSliceImage->size() != lastRender.originalSize || ui->lbSliceImageProcessed->size() != lastRender.processedSize) {
+        requestRender(!processedSlice.empty());
     }
-
-    writer.release();
-    ui->statusbar->showMessage(QString("Video generado correctamente en %1").arg(videoName));
 }
 
 /**
- * @brief Convierte Mat (CV_8UC1 o CV_8UC3) a QImage (copia) para mostrarlo en QLabel
+ * @brief Muestra la tabla de tiempos por etapa (menú “Depuración”)
  */
-QImage MainWindow::cvMatToQImage(const Mat &mat) {
-    if (mat.empty()) {
-        return QImage();
-    }
-    if (mat.type() == CV_8UC1) {
-        QImage img(mat.data, mat.cols, mat.rows,
-                   static_cast<int>(mat.step),
-                   QImage::Format_Grayscale8);
-        return img.copy();
-    } else if (mat.type() == CV_8UC3) {
-        Mat rgb;
-        cvtColor(mat, rgb, COLOR_BGR2RGB);
-        QImage img(rgb.data, rgb.cols, rgb.rows,
-                   static_cast<int>(rgb.step),
-                   QImage::Format_RGB888);
-        return img.copy();
-    }
-    return QImage();
+void MainWindow::showTraceSummary() {
+    QDialog *dialog = new QDialog(this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->setWindowTitle("Tiempos por etapa");
+    dialog->resize(760, 420);
+
+    QTextEdit *text = new QTextEdit;
+    text->setReadOnly(true);
+    text->setFontFamily("monospace");
+    text->setPlainText(QString::fromStdString(Trace::summaryText()));
+
+    QPushButton *closeButton = new QPushButton("Cerrar");
+    connect(closeButton, &QPushButton::clicked, dialog, &QDialog::accept);
+
+    QVBoxLayout *layout = new QVBoxLayout(dialog);
+    layout->addWidget(text);
+    layout->addWidget(closeButton);
+    dialog->show();
 }
 
 /**
- * @brief Muestra un Mat en un QLabel, escalándolo para ajustarse al tamaño del label
+ * @brief Guarda los últimos eventos medidos como Chrome trace (menú “Depuración”)
+ * @details Se abre en chrome://tracing o en https://ui.perfetto.dev
  */
-void MainWindow::showSliceOnLabel(const Mat &mat, QLabel *label) {
-    QImage img = cvMatToQImage(mat);
-    if (img.isNull()) {
-        label->setText("Sin imagen");
-        label->setPixmap(QPixmap());
+void MainWindow::exportTrace() {
+    QString path = QFileDialog::getSaveFileName(this, "Exportar traza", QDir(outputFolder).filePath("traza.json"),
+                                                "Chrome trace (*.json)");
+    if (path.isEmpty()) {
+        return;
+    }
+    if (!Trace::writeChromeTrace(path.toStdString())) {
+        ui->statusbar->showMessage("No se pudo escribir " + path);
         return;
     }
-    QPixmap pix = QPixmap::fromImage(img);
-    QSize lblSize = label->size();
-    QPixmap scaled = pix.scaled(lblSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-    label->setPixmap(scaled);
-    label->setText("");
+    ui->statusbar->showMessage("Traza exportada: " + path);
 }
@@ -0,0 +1,265 @@
+#include "cli/BatchProcessor.h"
+#include "helpers/EffectPipeline.h"
+#include "helpers/FrameSink.h"
+#include "helpers/ThreadPool.h"
+#include "helpers/VolumeStatistics.h"
+#include "helpers/Volumetrics.h"
+
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using namespace cv;
+using namespace std;
+namespace fs = std::filesystem;
+
+BatchProcessor::BatchProcessor(BatchOptions options) : options(std::move(options)) {}
+
+/**
+ * @brief Procesa todos los pacientes, como máximo options.jobs a la vez
+ * @details Cada paciente escribe su propio video o carpeta, en paralelo; si dos comparten
+ * nombre, el segundo lleva un sufijo (_2, _3...) para no escribir en el mismo archivo
+ * @param batchCases Pacientes a procesar
+ * @return Número de pacientes que fallaron (0 si todo fue bien)
+ */
+int BatchProcessor::run(const vector<BatchCase> &batchCases) {
+    if (options.format == "stats") {
+        return runStats(batchCases);
+    }
+
+    vector<BatchCase> cases = batchCases;
+    set<string> usedNames;
+    for (BatchCase &batchCase : cases) {
+        string name = batchCase.name;
+        for (int suffix = 2; !usedNames.insert(name).second; suffix++) {
+            name = batchCase.name + "_" + to_string(suffix);
+        }
+        batchCase.name = name;
+    }
+
+    ThreadPool pool(static_cast<size_t>(max(0, options.jobs)));
+    mutex outputMutex;
+    size_t threads = threadsPerCase(cases.size());
+
+    vector<future<bool>> results;
+    results.reserve(cases.size());
+
+    for (const BatchCase &batchCase : cases) {
+        results.push_back(pool.submit([this, &batchCase, &outputMutex, threads] {
+            string error;
+            bool ok = processCase(batchCase, threads, error);
+
+            lock_guard<mutex> lock(outputMutex);
+            if (ok) {
+                cout << "[OK]    " << batchCase.name << "\n";
+            } else {
+                cerr << "[ERROR] " << batchCase.name << ": " << error << "\n";
+            }
+            return ok;
+        }));
+    }
+
+    int failed = 0;
+    for (future<bool> &result : results) {
+        failed += result.get() ? 0 : 1;
+    }
+    return failed;
+}
+
+/**
+ * @brief Estadísticos 3D de todos los pacientes en dos CSV de cohorte
+ * @details estadisticas_volumen.csv (una fila por paciente y etiqueta) e
+ * histogramas_volumen.csv (formato largo), con los pacientes en el orden de entrada
+ * @return Número de pacientes que fallaron
+ */
+int BatchProcessor::runStats(const vector<BatchCase> &cases) {
+    ThreadPool pool(static_cast<size_t>(max(0, options.jobs)));
+    mutex outputMutex;
+    size_t threads = threadsPerCase(cases.size());
+
+    struct CaseRows {
+        bool ok = false;
+        string rows;
+        string histogramRows;
+    };
+    vector<future<CaseRows>> results;
+    results.reserve(cases.size());
+
+    for (const BatchCase &batchCase : cases) {
+        results.push_back(pool.submit([this, &batchCase, &outputMutex, threads] {
+            CaseRows caseRows;
+            string error;
+            caseRows.ok = processStats(batchCase, threads, caseRows.rows, caseRows.histogramRows, error);
+
+            lock_guard<mutex> lock(outputMutex);
+            if (caseRows.ok) {
+                cout << "[OK]    " << batchCase.name << "\n";
+            } else {
+                cerr << "[ERROR] " << batchCase.name << ": " << error << "\n";
+            }
+            return caseRows;
+        }));
+    }
+
+    std::error_code fsError;
+    fs::create_directories(options.outputFolder, fsError);
+    string statsPath = (fs::path(options.outputFolder) / "estadisticas_volumen.csv").string();
+    string histogramPath = (fs::path(options.outputFolder) / "histogramas_volumen.csv").string();
+    ofstream statsFile(statsPath);
+    ofstream histogramFile(histogramPath);
+    if (!statsFile || !histogramFile) {
+        cerr << "No se pudo crear " << statsPath << " o " << histogramPath << "\n";
+    }
+    statsFile << VolumeStatistics::csvHeader();
+    histogramFile << VolumeStatistics::histogramCsvHeader();
+
+    int failed = 0;
+    for (future<CaseRows> &result : results) {
+        CaseRows caseRows = result.get();
+        failed += caseRows.ok ? 0 : 1;
+        statsFile << caseRows.rows;
+        histogramFile << caseRows.histogramRows;
+    }
+    return (statsFile && histogramFile) ? failed : static_cast<int>(cases.size());
+}
+
+/**
+ * @brief Hilos que usa cada paciente dentro de su propio cálculo (filtros 3D, estadísticos)
+ * @details Reparte los núcleos entre los pacientes que corren a la vez, min(jobs, pacientes),
+ * con jobs = 0 como un paciente por núcleo; así un lote pequeño no deja núcleos parados
+ * @param caseCount Pacientes del lote
+ * @return Al menos 1
+ */
+size_t BatchProcessor::threadsPerCase(size_t caseCount) const {
+    size_t cores = max<size_t>(1, thread::hardware_concurrency());
+    size_t concurrent = (options.jobs > 0) ? static_cast<size_t>(options.jobs) : cores;
+    concurrent = max<size_t>(1, min(concurrent, caseCount));
+    return max<size_t>(1, cores / concurrent);
+}
+
+/**
+ * @brief Deriva el nombre del paciente a partir de la ruta del volumen
+ * @details "/data/BraTS2021_00000_flair.nii.gz" → "BraTS2021_00000_flair"
+ */
+string BatchProcessor::caseNameFromPath(const string &volumePath) {
+    string name = fs::path(volumePath).filename().string();
+
+    for (const string &extension : {".nii.gz", ".nii"}) {
+        if (name.size() > extension.size() &&
+            name.compare(name.size() - extension.size(), extension.size(), extension) == 0) {
+            return name.substr(0, name.size() - extension.size());
+        }
+    }
+    return name;
+}
+
+/**
+ * @brief Carga un paciente, aplica la cadena de efectos a cada slice y escribe la salida
+ * @param batchCase Paciente a procesar
+ * @param threads Hilos para los filtros 3D de este paciente (ver threadsPerCase)
+ * @param error Mensaje de error si falla
+ * @return true si se escribió toda la salida
+ */
+bool BatchProcessor::processCase(const BatchCase &batchCase, size_t threads, string &error) const {
+    Volumetrics volumetrics;
+
+    if (!volumetrics.loadVolumetric(batchCase.volumePath, "flair")) {
+        error = "no se pudo cargar el volumen " + batchCase.volumePath;
+        return false;
+    }
+    if (!volumetrics.loadVolumetric(batchCase.maskPath, "mask")) {
+        error = "no se pudo cargar la máscara " + batchCase.maskPath;
+        return false;
+    }
+
+    // Filtros 3D: cada slice sale del volumen ya filtrado, sin saltos entre slices vecinos.
+    // Cada paciente filtra con su parte de los núcleos
+    for (EffectId effectId : options.volumeEffectIds) {
+        if (!volumetrics.applyVolumeFilter(effectId, options.effectParams, threads)) {
+            error = string("no se pudo aplicar el filtro 3D ") + EffectRegistry::get(effectId).name;
+            return false;
+        }
+    }
+
+    int depth = static_cast<int>(volumetrics.getDepth());
+    if (depth == 0) {
+        error = "volumen sin profundidad (depth = 0)";
+        return false;
+    }
+
+    const VideoFormat *format = VideoFormats::find(options.format);
+    if (!format) {
+        error = "formato no soportado: " + options.format;
+        return false;
+    }
+    std::error_code fsError;
+    fs::create_directories(options.outputFolder, fsError);
+    if (fsError) {
+        error = "no se pudo crear la carpeta de salida: " + fsError.message();
+        return false;
+    }
+
+    // <salida>/<paciente>.<extensión>, o la carpeta <salida>/<paciente> con un PNG por slice
+    FrameSink sink(*format, options.fps, (fs::path(options.outputFolder) / batchCase.name).string());
+
+    // Resaltado + cadena de efectos sobre buffers reutilizados entre slices
+    EffectPipeline pipeline;
+    if (options.useImageProcessed) {
+        pipeline.addOverlay();
+    }
+    for (EffectId effectId : options.effectIds) {
+        pipeline.addEffect(effectId);
+    }
+    pipeline.setParams(options.effectParams);
+
+    for (int index = 0; index < depth; index++) {
+        volumetrics.setSliceIndex(index);
+        volumetrics.setSliceAsMat();
+        volumetrics.setSliceMaskAsMat();
+
+        // El sink convierte y reescala en sus propios buffers, reutilizados entre slices
+        Mat slice = volumetrics.getSliceAsMat();
+        if (!sink.write(pipeline.run(volumetrics, slice), index, error)) {
+            return false;
+        }
+    }
+
+    sink.close();
+    return true;
+}
+
+/**
+ * @brief Lee volumen y máscara de un paciente y calcula sus estadísticos 3D
+ * @details Sin caché 8-bit de slices: solo se recorren los vóxeles originales
+ * @param threads Hilos para los bloques Z de este paciente (ver threadsPerCase)
+ * @param rows Filas de estadisticas_volumen.csv de este paciente
+ * @param histogramRows Filas de histogramas_volumen.csv de este paciente
+ * @return true si se pudieron calcular
+ */
+bool BatchProcessor::processStats(const BatchCase &batchCase, size_t threads, string &rows, string &histogramRows,
+                                  string &error) const {
+    LoadedVolume volume;
+    LoadedVolume mask;
+    if (!Volumetrics::readVolume(batchCase.volumePath, false, volume, /*buildCache=*/false)) {
+        error = "no se pudo cargar el volumen " + batchCase.volumePath;
+        return false;
+    }
+    if (!Volumetrics::readVolume(batchCase.maskPath, true, mask, /*buildCache=*/false)) {
+        error = "no se pudo cargar la máscara " + batchCase.maskPath;
+        return false;
+    }
+
+    VolumeStats stats;
+    if (!VolumeStatistics::compute(volume.image, mask.image, stats, threads)) {
+        error = "el volumen y la máscara no son compatibles";
+        return false;
+    }
+
+    rows = VolumeStatistics::csvRows(batchCase.name, stats);
+    histogramRows = VolumeStatistics::histogramCsvRows(batchCase.name, stats);
+    return true;
+}
@@ -0,0 +1,170 @@
+#include "cli/BatchProcessor.h"
+#include "helpers/EffectChain.h"
+#include "helpers/FrameSink.h"
+#include "helpers/VolumeCache.h"
+#include "helpers/VolumeFilters.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Muestra la ayuda de la herramienta de línea de comandos
+ */
+static void printUsage(const char *program) {
+    cout << "Uso: " << program << " [opciones] <volumen.nii.gz>:<mascara.nii.gz> ...\n"
+         << "\n"
+         << "Procesa por lotes volúmenes BraTS sin interfaz gráfica.\n"
+         << "\n"
+         << "Opciones:\n"
+         << "  -l, --list <archivo>    Archivo con un paciente por línea: <volumen> <mascara>\n"
+         << "  -e, --effects <a,b,..>  Cadena de efectos en orden (p. ej. GaussianFilter,Threshold)\n"
+         << "  -p, --overlay           Resaltar la máscara sobre el slice antes de los efectos\n"
+         << "  -P, --param <nombre=valor>\n"
+         << "                          Parámetro de los efectos (se puede repetir):\n"
+         << "                         ";
+    for (const EffectParamSpec &spec : EffectRegistry::paramSpecs()) {
+        cout << " " << spec.key;
+    }
+    cout << "\n"
+         << "  -v, --volume-effects <a,b,..>\n"
+         << "                          Filtros 3D sobre todo el volumen antes de extraer los slices\n"
+         << "                          (MeanFilter, GaussianFilter, MedianFilter, Erosion, Dilation,\n"
+         << "                          Opening, Closing)\n"
+         << "  -f, --format <png|mp4|avi|ffv1|stats>\n"
+         << "                          Un PNG por slice (por defecto), un video por paciente (mp4v,\n"
+         << "                          Motion JPEG o FFV1 sin pérdida en .mkv) o estadísticos 3D\n"
+         << "                          por etiqueta de toda la cohorte en CSV\n"
+         << "  --fps <n>               Fotogramas por segundo de los videos (por defecto: 10)\n"
+         << "  -o, --output <carpeta>  Carpeta de salida (por defecto: output)\n"
+         << "  -j, --jobs <n>          Pacientes en paralelo (por defecto: todos los núcleos)\n"
+         << "  --cache-dir <carpeta>   Caché de volúmenes descomprimidos (por defecto: VOLUME_CACHE_DIR o cache/volumes)\n"
+         << "  --no-cache              No leer ni escribir la caché de volúmenes\n"
+         << "  -h, --help              Muestra esta ayuda\n";
+}
+
+/**
+ * @brief Lee un archivo de lista con un par "volumen mascara" por línea
+ * @return false si el archivo no se pudo abrir o tiene líneas incompletas
+ */
+static bool readCaseList(const string &listPath, vector<BatchCase> &cases) {
+    ifstream file(listPath);
+    if (!file) {
+        cerr << "No se pudo abrir la lista " << listPath << "\n";
+        return false;
+    }
+
+    string line;
+    int lineNumber = 0;
+    while (getline(file, line)) {
+        lineNumber++;
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        BatchCase batchCase;
+        istringstream fields(line);
+        if (!(fields >> batchCase.volumePath >> batchCase.maskPath)) {
+            cerr << listPath << ":" << lineNumber << ": se esperaba <volumen> <mascara>\n";
+            return false;
+        }
+        batchCase.name = BatchProcessor::caseNameFromPath(batchCase.volumePath);
+        cases.push_back(batchCase);
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    BatchOptions options;
+    vector<BatchCase> cases;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+
+        if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        } else if ((arg == "-l" || arg == "--list") && hasValue) {
+            if (!readCaseList(argv[++i], cases)) {
+                return 1;
+            }
+        } else if ((arg == "-e" || arg == "--effects") && hasValue) {
+            string unknownName;
+            if (!EffectChain::parseChain(argv[++i], options.effectIds, unknownName)) {
+                cerr << "Efecto desconocido: " << unknownName << "\n";
+                return 1;
+            }
+        } else if ((arg == "-v" || arg == "--volume-effects") && hasValue) {
+            string unknownName;
+            if (!EffectChain::parseChain(argv[++i], options.volumeEffectIds, unknownName)) {
+                cerr << "Efecto desconocido: " << unknownName << "\n";
+                return 1;
+            }
+            for (EffectId effectId : options.volumeEffectIds) {
+                if (!VolumeFilters::supports(effectId)) {
+                    cerr << "El efecto " << EffectRegistry::get(effectId).name << " no tiene versión 3D\n";
+                    return 1;
+                }
+            }
+        } else if ((arg == "-P" || arg == "--param") && hasValue) {
+            string param = argv[++i];
+            size_t equals = param.find('=');
+            EffectParamId paramId;
+            if (equals == string::npos || !EffectRegistry::paramFromKey(param.substr(0, equals), paramId)) {
+                cerr << "Parámetro desconocido: " << param << " (use nombre=valor)\n";
+                return 1;
+            }
+            EffectRegistry::setParam(options.effectParams, paramId, atof(param.c_str() + equals + 1));
+        } else if (arg == "-p" || arg == "--overlay") {
+            options.useImageProcessed = true;
+        } else if ((arg == "-f" || arg == "--format") && hasValue) {
+            options.format = argv[++i];
+        } else if (arg == "--fps" && hasValue) {
+            options.fps = atof(argv[++i]);
+        } else if ((arg == "-o" || arg == "--output") && hasValue) {
+            options.outputFolder = argv[++i];
+        } else if ((arg == "-j" || arg == "--jobs") && hasValue) {
+            options.jobs = atoi(argv[++i]);
+        } else if (arg == "--cache-dir" && hasValue) {
+            VolumeCache::setDirectory(argv[++i]);
+        } else if (arg == "--no-cache") {
+            VolumeCache::setEnabled(false);
+        } else if (!arg.empty() && arg[0] != '-' && arg.find(':') != string::npos) {
+            BatchCase batchCase;
+            batchCase.volumePath = arg.substr(0, arg.find(':'));
+            batchCase.maskPath = arg.substr(arg.find(':') + 1);
+            batchCase.name = BatchProcessor::caseNameFromPath(batchCase.volumePath);
+            cases.push_back(batchCase);
+        } else {
+            cerr << "Argumento no reconocido: " << arg << "\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (options.format != "stats" && !VideoFormats::find(options.format)) {
+        cerr << "Formato no soportado: " << options.format << " (use " << VideoFormats::names() << " o stats)\n";
+        return 1;
+    }
+    if (options.fps <= 0.0) {
+        cerr << "Los fotogramas por segundo deben ser positivos\n";
+        return 1;
+    }
+
+    if (cases.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    BatchProcessor processor(options);
+    int failed = processor.run(cases);
+
+    cout << (cases.size() - failed) << "/" << cases.size() << " pacientes procesados.\n";
+    return failed == 0 ? 0 : 2;
+}
@@ -0,0 +1,206 @@
+#include "helpers/BrickedVolume.h"
+#include "helpers/SlabParallel.h"
+#include "helpers/Trace.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+// Índice reflejado sin repetir el borde (BORDER_REFLECT_101), como en VolumeFilters
+inline int reflect101(int index, int size) {
+    if (size == 1) {
+        return 0;
+    }
+    while (index < 0 || index >= size) {
+        index = (index < 0) ? -index : 2 * size - 2 - index;
+    }
+    return index;
+}
+
+} // namespace
+
+/**
+ * @brief Copia un volumen a bricks de brickSize³, repartiendo los bricks entre hilos
+ * @details Cada fila de un brick son size.x vóxeles contiguos también en el original, así
+ * que se copia con un memcpy por fila
+ * @param image Volumen en cualquier tipo de vóxel (se conserva el tipo)
+ * @param brickSize Lado del brick en vóxeles
+ * @param threads Hilos a usar; 0 = todos los núcleos
+ */
+BrickedVolume::BrickedVolume(const VolumeImage &image, int brickSize, size_t threads) {
+    TRACE_SCOPE("BrickedVolume::build");
+    if (!image || image.voxelCount() == 0 || brickSize <= 0) {
+        return;
+    }
+
+    edge = brickSize;
+    voxelType = image.type();
+    dims = Vec3i(image.width(), image.height(), image.depth());
+    for (int axis = 0; axis < 3; axis++) {
+        grid[axis] = (dims[axis] + edge - 1) / edge;
+    }
+
+    itk::ImageBase<3>::Pointer geometry = itk::ImageBase<3>::New();
+    geometry->CopyInformation(image.itkImage());
+    geometry->SetRegions(image.itkImage()->GetBufferedRegion());
+    info = geometry;
+
+    const size_t voxelSize = voxelBytes(voxelType);
+    const size_t rowBytes = static_cast<size_t>(dims[0]) * voxelSize;
+    const size_t sliceBytes = rowBytes * dims[1];
+    const uint8_t *src = static_cast<const uint8_t *>(image.data());
+    auto bricks = make_shared<vector<uint8_t>>(static_cast<size_t>(brickCount()) * edge * edge * edge * voxelSize, 0);
+    uint8_t *dst = bricks->data();
+
+    forEachSlab<int>(brickCount(), threads, [&](int first, int last) {
+        for (int index = first; index < last; index++) {
+            Brick current = brick(index);
+            uint8_t *out = dst + offsetOf(current) * voxelSize;
+            for (int lz = 0; lz < current.size[2]; lz++) {
+                for (int ly = 0; ly < current.size[1]; ly++) {
+                    const uint8_t *row = src + (current.origin[2] + lz) * sliceBytes +
+                                         (current.origin[1] + ly) * rowBytes + current.origin[0] * voxelSize;
+                    memcpy(out + localOffset(0, ly, lz) * voxelSize, row, current.size[0] * voxelSize);
+                }
+            }
+        }
+        return 0;
+    });
+    storage = bricks;
+}
+
+/**
+ * @brief Posición y tamaño válido de un brick (los bricks van x-más-rápido en la rejilla)
+ */
+BrickedVolume::Brick BrickedVolume::brick(int index) const {
+    Brick result;
+    result.index = index;
+    const int position[3] = {index % grid[0], (index / grid[0]) % grid[1], index / (grid[0] * grid[1])};
+    for (int axis = 0; axis < 3; axis++) {
+        result.origin[axis] = position[axis] * edge;
+        result.size[axis] = min(edge, dims[axis] - result.origin[axis]);
+    }
+    return result;
+}
+
+/**
+ * @brief Copia un corte en cualquier eje recorriendo solo los bricks que lo cortan
+ * @details Axial y coronal copian filas contiguas de cada brick; sagital lee con paso
+ * brickSize dentro de cada brick, que está entero en L2, en lugar de saltar un slice
+ * completo del volumen entre vóxeles
+ * @return Mat en el tipo del volumen (filas = Y para axial, Z para coronal/sagital), vacío si
+ * el índice no es válido
+ */
+Mat BrickedVolume::slice(SliceAxis axis, int index) const {
+    TRACE_SCOPE("BrickedVolume::slice");
+    const int axisIndex = (axis == SliceAxis::Sagittal) ? 0 : (axis == SliceAxis::Coronal ? 1 : 2);
+    if (!storage || index < 0 || index >= dims[axisIndex]) {
+        return Mat();
+    }
+
+    const int layer = index / edge;
+    const int local = index % edge;
+    return visit([&](const auto *voxels) {
+        using Pixel = PixelOf<decltype(voxels)>;
+        const int type = CV_MAKETYPE(VoxelTraits<Pixel>::cvDepth, 1);
+
+        switch (axis) {
+        case SliceAxis::Axial: {
+            Mat axial(dims[1], dims[0], type);
+            for (int by = 0; by < grid[1]; by++) {
+                for (int bx = 0; bx < grid[0]; bx++) {
+                    Brick current = brickAt(bx, by, layer);
+                    const Pixel *data = voxels + offsetOf(current);
+                    for (int ly = 0; ly < current.size[1]; ly++) {
+                        const Pixel *src = data + localOffset(0, ly, local);
+                        copy(src, src + current.size[0], axial.ptr<Pixel>(current.origin[1] + ly) + current.origin[0]);
+                    }
+                }
+            }
+            return axial;
+        }
+
+        case SliceAxis::Coronal: {
+            Mat coronal(dims[2], dims[0], type);
+            for (int bz = 0; bz < grid[2]; bz++) {
+                for (int bx = 0; bx < grid[0]; bx++) {
+                    Brick current = brickAt(bx, layer, bz);
+                    const Pixel *data = voxels + offsetOf(current);
+                    for (int lz = 0; lz < current.size[2]; lz++) {
+                        const Pixel *src = data + localOffset(0, local, lz);
+                        Pixel *dst = coronal.ptr<Pixel>(current.origin[2] + lz) + current.origin[0];
+                        copy(src, src + current.size[0], dst);
+                    }
+                }
+            }
+            return coronal;
+        }
+
+        case SliceAxis::Sagittal:
+            break;
+        }
+
+        Mat sagittal(dims[2], dims[1], type);
+        for (int bz = 0; bz < grid[2]; bz++) {
+            for (int by = 0; by < grid[1]; by++) {
+                Brick current = brickAt(layer, by, bz);
+                const Pixel *data = voxels + offsetOf(current);
+                for (int lz = 0; lz < current.size[2]; lz++) {
+                    const Pixel *src = data + localOffset(local, 0, lz);
+                    Pixel *dst = sagittal.ptr<Pixel>(current.origin[2] + lz) + current.origin[1];
+                    for (int ly = 0; ly < current.size[1]; ly++) {
+                        dst[ly] = src[ly * edge];
+                    }
+                }
+            }
+        }
+        return sagittal;
+    });
+}
+
+/**
+ * @brief Copia a float un bloque cualquiera del volumen, x-más-rápido
+ * @details Las posiciones fuera del volumen se reflejan como BORDER_REFLECT_101; así un brick
+ * con un halo alrededor se puede filtrar solo y da lo mismo que filtrar todo el volumen
+ * @param origin Primer vóxel del bloque (puede ser negativo)
+ * @param size Vóxeles del bloque en cada eje
+ * @param dst Destino de size[0] * size[1] * size[2] floats
+ */
+void BrickedVolume::gather(const Vec3i &origin, const Vec3i &size, float *dst) const {
+    if (!storage) {
+        return;
+    }
+
+    // Brick y posición local de cada columna del bloque, una sola vez
+    vector<int> columnBrick(size[0]);
+    vector<int> columnLocal(size[0]);
+    for (int i = 0; i < size[0]; i++) {
+        int x = reflect101(origin[0] + i, dims[0]);
+        columnBrick[i] = x / edge;
+        columnLocal[i] = x % edge;
+    }
+
+    visit([&](const auto *voxels) {
+        using Pixel = PixelOf<decltype(voxels)>;
+        vector<const Pixel *> rowOf(grid[0]); // La fila (y, z) dentro de cada brick de la rejilla en X
+
+        for (int k = 0; k < size[2]; k++) {
+            int z = reflect101(origin[2] + k, dims[2]);
+            for (int j = 0; j < size[1]; j++) {
+                int y = reflect101(origin[1] + j, dims[1]);
+                for (int bx = 0; bx < grid[0]; bx++) {
+                    rowOf[bx] = voxels + offsetOf(brickAt(bx, y / edge, z / edge)) + localOffset(0, y % edge, z % edge);
+                }
+
+                float *out = dst + (static_cast<size_t>(k) * size[1] + j) * size[0];
+                for (int i = 0; i < size[0]; i++) {
+                    out[i] = static_cast<float>(rowOf[columnBrick[i]][columnLocal[i]]);
+                }
+            }
+        }
+    });
+}
@@ -0,0 +1,52 @@
+#include "helpers/EffectChain.h"
+
+#include <sstream>
+
+using namespace cv;
+using namespace std;
+
+namespace EffectChain {
+
+/**
+ * @brief Aplica varios efectos en orden, cada uno sobre el resultado del anterior
+ * @param volumetrics Objeto Volumetrics con el slice y la máscara actuales
+ * @param processedSlice Imagen de entrada de la cadena
+ * @param effectIds Efectos, en el orden en que se aplican
+ * @param params Parámetros compartidos por los efectos de la cadena
+ * @return Imagen con todos los efectos aplicados
+ */
+Mat applyChain(Volumetrics &volumetrics, Mat processedSlice, const vector<EffectId> &effectIds, const EffectParams &params) {
+    for (EffectId effectId : effectIds) {
+        processedSlice = EffectRegistry::apply(effectId, volumetrics, processedSlice, params);
+    }
+    return processedSlice;
+}
+
+/**
+ * @brief Resuelve una cadena de efectos "GaussianFilter,Threshold,Closing" a sus ids
+ * @param chain Texto con los nombres de los efectos
+ * @param effectIds Ids resueltos, en orden (sin entradas vacías)
+ * @param unknownName Primer nombre que no corresponde a ningún efecto, si lo hay
+ * @param separator Separador entre efectos
+ * @return false si algún nombre no es un efecto registrado
+ */
+bool parseChain(const string &chain, vector<EffectId> &effectIds, string &unknownName, char separator) {
+    stringstream stream(chain);
+    string effectName;
+
+    while (getline(stream, effectName, separator)) {
+        if (effectName.empty()) {
+            continue;
+        }
+
+        EffectId effectId = EffectRegistry::idFromName(effectName);
+        if (effectId == EffectId::None && effectName != EffectRegistry::get(EffectId::None).name) {
+            unknownName = effectName;
+            return false;
+        }
+        effectIds.push_back(effectId);
+    }
+    return true;
+}
+
+} // namespace EffectChain
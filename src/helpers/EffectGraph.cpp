@@ -0,0 +1,185 @@
+#include "helpers/EffectGraph.h"
+#include "helpers/Trace.h"
+#include "helpers/Volumetrics.h"
+
+#include <opencv2/imgproc.hpp>
+
+using namespace cv;
+using namespace std;
+
+/**
+ * @brief Añade un efecto al final de la cadena, con sus propios parámetros
+ */
+EffectGraph &EffectGraph::addEffect(EffectId id, const EffectParams &params) {
+    Node node{false, id, params};
+    nodes.push_back(node);
+    return *this;
+}
+
+/**
+ * @brief Añade el resaltado de la máscara (processSlice) al final de la cadena
+ */
+EffectGraph &EffectGraph::addOverlay() {
+    Node node{true, EffectId::None};
+    nodes.push_back(node);
+    return *this;
+}
+
+/**
+ * @brief Vacía la cadena
+ */
+void EffectGraph::clear() {
+    nodes.clear();
+    firstDirty = 0;
+}
+
+/**
+ * @brief Número de etapas
+ */
+size_t EffectGraph::size() const {
+    return nodes.size();
+}
+
+/**
+ * @brief Cambia la imagen de entrada (p. ej. otro slice): invalida todas las etapas
+ * @details El resaltado depende además de la máscara del slice actual de volumetrics, que
+ * debe corresponder a la nueva entrada
+ */
+void EffectGraph::setInput(const Mat &input) {
+    this->input = input;
+    invalidate(0);
+}
+
+/**
+ * @brief Cambia los parámetros de una etapa
+ * @details Solo se invalida si cambió alguno de los parámetros que el efecto usa: mover el
+ * umbral no rehace un filtro gaussiano anterior ni posterior que no lo usa
+ * @return true si la etapa quedó invalidada
+ */
+bool EffectGraph::setParams(size_t stage, const EffectParams &params) {
+    if (stage >= nodes.size() || nodes[stage].overlay) {
+        return false;
+    }
+
+    Node &node = nodes[stage];
+    bool changed = false;
+    for (EffectParamId id : EffectRegistry::paramsOf(node.id)) {
+        changed = changed || EffectRegistry::getParam(node.params, id) != EffectRegistry::getParam(params, id);
+    }
+    node.params = params;
+    if (changed) {
+        node.lutValid = false;
+        invalidate(stage);
+    }
+    return changed;
+}
+
+/**
+ * @brief Cambia un parámetro de una etapa (ajustado a su rango y paso)
+ * @return true si la etapa quedó invalidada
+ */
+bool EffectGraph::setParam(size_t stage, EffectParamId id, double value) {
+    if (stage >= nodes.size()) {
+        return false;
+    }
+    EffectParams params = nodes[stage].params;
+    EffectRegistry::setParam(params, id, value);
+    return setParams(stage, params);
+}
+
+/**
+ * @brief Parámetros de una etapa
+ */
+const EffectParams &EffectGraph::params(size_t stage) const {
+    static const EffectParams defaults;
+    return stage < nodes.size() ? nodes[stage].params : defaults;
+}
+
+/**
+ * @brief Marca como no válidos los resultados desde una etapa en adelante
+ * @details Necesario si cambia algo que el grafo no ve, como las etiquetas visibles del
+ * resaltado
+ */
+void EffectGraph::invalidate(size_t fromStage) {
+    firstDirty = min(firstDirty, fromStage);
+}
+
+/**
+ * @brief Ejecuta las etapas invalidadas, cada una sobre el resultado guardado de la anterior
+ * @param volumetrics Objeto Volumetrics con la máscara del slice de entrada
+ * @return Resultado de la última etapa; apunta a un buffer interno que se sobrescribe en la
+ * siguiente ejecución que la recalcule (clonarlo para conservarlo)
+ */
+const Mat &EffectGraph::run(Volumetrics &volumetrics) {
+    recomputed = 0;
+    if (nodes.empty() || input.empty()) {
+        return input;
+    }
+
+    for (size_t i = firstDirty; i < nodes.size(); i++) {
+        const Mat &src = (i == 0) ? input : nodes[i - 1].output;
+        evaluate(nodes[i], volumetrics, src);
+        recomputed++;
+
+        // Error en la etapa: se reintenta desde aquí en la próxima ejecución
+        if (nodes[i].output.empty()) {
+            firstDirty = i;
+            return nodes[i].output;
+        }
+    }
+
+    firstDirty = nodes.size();
+    return nodes.back().output;
+}
+
+/**
+ * @brief Cuántas etapas se recalcularon en la última ejecución
+ */
+size_t EffectGraph::lastRecomputed() const {
+    return recomputed;
+}
+
+/**
+ * @brief Calcula una etapa sobre su buffer propio
+ * @details Los efectos punto a punto usan su tabla de consulta (una pasada, y rehacer la
+ * tabla al mover el parámetro cuesta 256 entradas); el resto usa applyInto si lo tiene
+ */
+void EffectGraph::evaluate(Node &node, Volumetrics &volumetrics, const Mat &src) {
+    const EffectDescriptor &descriptor = EffectRegistry::get(node.id);
+    bool writesInPlace = node.overlay || descriptor.buildLut || descriptor.applyInto;
+
+    // Nunca escribir sobre memoria que devolvió un efecto sin variante applyInto
+    if (writesInPlace && !node.ownsOutput) {
+        node.output.release();
+        node.ownsOutput = true;
+    }
+
+    if (node.overlay) {
+        volumetrics.processSliceInto(src, node.output);
+        return;
+    }
+
+    TRACE_SCOPE(descriptor.name);
+    if (descriptor.buildLut) {
+        if (!node.lutValid) {
+            node.lut.create(1, 256, CV_8UC1);
+            descriptor.buildLut(node.lut.ptr<uchar>(), node.params);
+            node.lutValid = true;
+        }
+        if (descriptor.needsGray && src.channels() == 3) {
+            cvtColor(src, node.scratch, COLOR_BGR2GRAY);
+            LUT(node.scratch, node.lut, node.output);
+        } else {
+            LUT(src, node.lut, node.output);
+        }
+        return;
+    }
+
+    if (descriptor.applyInto) {
+        descriptor.applyInto(volumetrics, src, node.output, node.params, node.scratch);
+        return;
+    }
+
+    node.output = descriptor.apply(volumetrics, src, node.params);
+    node.ownsOutput = false;
+}
@@ -0,0 +1,186 @@
+#include "helpers/EffectPipeline.h"
+#include "helpers/Trace.h"
+#include "helpers/Volumetrics.h"
+
+#include <opencv2/imgproc.hpp>
+
+using namespace cv;
+using namespace std;
+
+/**
+ * @brief Añade un efecto al final de la cadena
+ */
+EffectPipeline &EffectPipeline::addEffect(EffectId id) {
+    steps.push_back({false, id});
+    compiled = false;
+    return *this;
+}
+
+/**
+ * @brief Añade el resaltado de la máscara (processSlice) al final de la cadena
+ */
+EffectPipeline &EffectPipeline::addOverlay() {
+    steps.push_back({true, EffectId::None});
+    compiled = false;
+    return *this;
+}
+
+/**
+ * @brief Cambia los parámetros de los efectos (las tablas fusionadas se recalculan)
+ */
+void EffectPipeline::setParams(const EffectParams &params) {
+    this->params = params;
+    compiled = false;
+}
+
+/**
+ * @brief Vacía la cadena (los buffers se conservan para la siguiente)
+ */
+void EffectPipeline::clear() {
+    steps.clear();
+    compiled = false;
+}
+
+/**
+ * @brief Indica si la cadena no tiene etapas
+ */
+bool EffectPipeline::empty() const {
+    return steps.empty();
+}
+
+/**
+ * @brief Convierte la cadena pedida en etapas ejecutables, fusionando las punto a punto
+ * @details Un efecto que pasa a grises (Threshold) solo se fusiona si abre el grupo o si el
+ * grupo ya trabaja en grises; así el resultado es idéntico a aplicarlos uno por uno
+ */
+void EffectPipeline::compile() {
+    stages.clear();
+    uchar effectLut[256];
+
+    for (const Step &step : steps) {
+        if (step.overlay) {
+            stages.push_back({StageKind::Overlay});
+            continue;
+        }
+        if (step.id == EffectId::None) {
+            continue;
+        }
+
+        const EffectDescriptor &descriptor = EffectRegistry::get(step.id);
+        if (!descriptor.buildLut) {
+            Stage stage{StageKind::Effect};
+            stage.id = step.id;
+            stages.push_back(stage);
+            continue;
+        }
+
+        descriptor.buildLut(effectLut, params);
+
+        Stage *group = stages.empty() ? nullptr : &stages.back();
+        bool canFuse = group && group->kind == StageKind::PointLut && (!descriptor.needsGray || group->needsGray);
+
+        if (canFuse) {
+            // Composición de tablas: lut'[v] = efecto(lut[v])
+            uchar *lut = group->lut.ptr<uchar>();
+            for (int value = 0; value < 256; value++) {
+                lut[value] = effectLut[lut[value]];
+            }
+            continue;
+        }
+
+        Stage stage{StageKind::PointLut};
+        stage.needsGray = descriptor.needsGray;
+        stage.lut = Mat(1, 256, CV_8UC1, effectLut).clone();
+        stages.push_back(stage);
+    }
+
+    compiled = true;
+}
+
+/**
+ * @brief Ejecuta la cadena sobre un slice
+ * @param volumetrics Objeto Volumetrics con la máscara del slice actual
+ * @param input Imagen de entrada (no se modifica)
+ * @return Resultado; apunta a un buffer interno que se sobrescribe en la siguiente llamada
+ */
+const Mat &EffectPipeline::run(Volumetrics &volumetrics, const Mat &input) {
+    if (!compiled) {
+        compile();
+    }
+    // Sin etapas se devuelve una copia en el buffer propio, nunca la entrada: quien llama puede
+    // pasar un temporal (p. ej. getSliceAsMat()) y quedarse con la referencia
+    if (stages.empty() || input.empty()) {
+        if (!ownsBuffer[0]) {
+            buffers[0].release();
+            ownsBuffer[0] = true;
+        }
+        if (input.empty()) {
+            buffers[0].release();
+        } else if (input.datastart != buffers[0].datastart) {
+            input.copyTo(buffers[0]);
+        }
+        return buffers[0];
+    }
+
+    // Si la entrada es el resultado anterior, empezar por el otro buffer
+    const Mat *current = &input;
+    int next = (!buffers[0].empty() && input.datastart == buffers[0].datastart) ? 1 : 0;
+
+    for (Stage &stage : stages) {
+        Mat &output = buffers[next];
+        const EffectDescriptor &descriptor = EffectRegistry::get(stage.id);
+        bool writesInPlace = (stage.kind != StageKind::Effect) || descriptor.applyInto;
+
+        // Nunca escribir sobre memoria que devolvió un efecto sin variante applyInto
+        if (writesInPlace && !ownsBuffer[next]) {
+            output.release();
+            ownsBuffer[next] = true;
+        }
+
+        switch (stage.kind) {
+        case StageKind::Overlay:
+            volumetrics.processSliceInto(*current, output);
+            break;
+
+        case StageKind::PointLut: {
+            TRACE_SCOPE("EffectPipeline::lut");
+            if (stage.needsGray && current->channels() == 3) {
+                cvtColor(*current, output, COLOR_BGR2GRAY);
+                LUT(output, stage.lut, output);
+            } else {
+                LUT(*current, stage.lut, output);
+            }
+            break;
+        }
+
+        case StageKind::Effect: {
+            TRACE_SCOPE(descriptor.name);
+            if (descriptor.applyInto) {
+                descriptor.applyInto(volumetrics, *current, output, params, stage.scratch);
+                break;
+            }
+
+            // Algunos efectos devuelven su entrada tal cual (p. ej. el estiramiento de contraste
+            // de un slice constante). Si es memoria de la etapa anterior se copia al buffer
+            // propio: si no, la etapa siguiente escribiría sobre lo que está leyendo
+            Mat result = descriptor.apply(volumetrics, *current, params);
+            if (!result.empty() && result.datastart == current->datastart) {
+                if (!ownsBuffer[next]) {
+                    output.release();
+                    ownsBuffer[next] = true;
+                }
+                result.copyTo(output);
+            } else {
+                output = result;
+                ownsBuffer[next] = false;
+            }
+            break;
+        }
+        }
+
+        current = &output;
+        next ^= 1;
+    }
+
+    return *current;
+}
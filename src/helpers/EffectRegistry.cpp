@@ -0,0 +1,419 @@
+#include "helpers/EffectRegistry.h"
+#include "helpers/Trace.h"
+#include "helpers/Volumetrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <opencv2/imgproc.hpp>
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+//* |------------| | Adaptadores tabla → Volumetrics | |------------|
+
+Mat applyNone(Volumetrics &, const Mat &slice, const EffectParams &) { return slice; }
+
+Mat applyThreshold(Volumetrics &volumetrics, const Mat &slice, const EffectParams &params) {
+    return volumetrics.aplyThreshold(slice, params.threshold);
+}
+
+Mat applyContrastStretch(Volumetrics &volumetrics, const Mat &slice, const EffectParams &) {
+    return volumetrics.aplyContratstStreching(slice);
+}
+
+Mat applyUmbralBinary(Volumetrics &volumetrics, const Mat &, const EffectParams &) {
+    return volumetrics.aplyUmbralBinary();
+}
+
+Mat applyBitwiseAnd(Volumetrics &volumetrics, const Mat &slice, const EffectParams &) {
+    return volumetrics.aplyBitWiseOperation(slice, "AND");
+}
+
+Mat applyBitwiseOr(Volumetrics &volumetrics, const Mat &slice, const EffectParams &) {
+    return volumetrics.aplyBitWiseOperation(slice, "OR");
+}
+
+Mat applyBitwiseXor(Volumetrics &volumetrics, const Mat &slice, const EffectParams &) {
+    return volumetrics.aplyBitWiseOperation(slice, "XOR");
+}
+
+Mat applyCanny(Volumetrics &volumetrics, const Mat &slice, const EffectParams &params) {
+    return volumetrics.aplyCanny(slice, params.cannyLower, params.cannyUpper);
+}
+
+Mat applyBrightness(Volumetrics &volumetrics, const Mat &slice, const EffectParams &params) {
+    return volumetrics.adjustBrightness(slice, params.brightness);
+}
+
+Mat applyMeanFilter(Volumetrics &volumetrics, const Mat &slice, const EffectParams &params) {
+    return volumetrics.aplyMeanFilter(slice, params.smoothKernelSize);
+}
+
+Mat applyGaussianFilter(Volumetrics &volumetrics, const Mat &slice, const EffectParams &params) {
+    return volumetrics.aplyGaussianFilter(slice, params.smoothKernelSize, params.gaussianSigma);
+}
+
+Mat applyMedianFilter(Volumetrics &volumetrics, const Mat &slice, const EffectParams &params) {
+    return volumetrics.aplyMedianFilter(slice, params.smoothKernelSize);
+}
+
+Mat applyBilateralFilter(Volumetrics &volumetrics, const Mat &slice, const EffectParams &params) {
+    return volumetrics.aplyBilateralFilter(slice, params.bilateralDiameter, params.bilateralSigmaColor, params.bilateralSigmaSpace);
+}
+
+Mat applyErosion(Volumetrics &volumetrics, const Mat &slice, const EffectParams &params) {
+    return volumetrics.aplyErosion(slice, params.morphKernelSize);
+}
+
+Mat applyDilation(Volumetrics &volumetrics, const Mat &slice, const EffectParams &params) {
+    return volumetrics.aplyDilation(slice, params.morphKernelSize);
+}
+
+Mat applyOpening(Volumetrics &volumetrics, const Mat &slice, const EffectParams &params) {
+    return volumetrics.aplyOpening(slice, params.morphKernelSize);
+}
+
+Mat applyClosing(Volumetrics &volumetrics, const Mat &slice, const EffectParams &params) {
+    return volumetrics.aplyClosing(slice, params.morphKernelSize);
+}
+
+Mat applyHistogramEqualization(Volumetrics &volumetrics, const Mat &slice, const EffectParams &) {
+    return volumetrics.aplyHistogramEqualization(slice);
+}
+
+Mat applyEmboss(Volumetrics &volumetrics, const Mat &slice, const EffectParams &) {
+    return volumetrics.aplyEmbossFilter(slice);
+}
+
+//* |------------| | Variantes sobre destino reutilizable | |------------|
+
+// Mismas reglas de tamaño de kernel que los métodos de Volumetrics
+int oddKernelSize(int kernelSize, int minimum) {
+    kernelSize = std::max(kernelSize, minimum);
+    return (kernelSize % 2 == 0) ? kernelSize + 1 : kernelSize;
+}
+
+// El elemento estructurante se guarda en scratch y solo se rehace si cambia el tamaño
+const Mat &rectKernel(Mat &scratch, int kernelSize) {
+    if (scratch.rows != kernelSize || scratch.cols != kernelSize) {
+        scratch = getStructuringElement(MORPH_RECT, Size(kernelSize, kernelSize));
+    }
+    return scratch;
+}
+
+void thresholdInto(Volumetrics &, const Mat &src, Mat &dst, const EffectParams &params, Mat &scratch) {
+    if (src.channels() == 3) {
+        cvtColor(src, scratch, COLOR_BGR2GRAY);
+        threshold(scratch, dst, params.threshold, 255, THRESH_BINARY);
+        return;
+    }
+    threshold(src, dst, params.threshold, 255, THRESH_BINARY);
+}
+
+void cannyInto(Volumetrics &, const Mat &src, Mat &dst, const EffectParams &params, Mat &scratch) {
+    // Canny toma el máximo gradiente entre canales: gris o BGR con canales iguales es lo mismo
+    GaussianBlur(src, scratch, Size(5, 5), 1.5);
+    Canny(scratch, dst, params.cannyLower, params.cannyUpper);
+}
+
+void brightnessInto(Volumetrics &, const Mat &src, Mat &dst, const EffectParams &params, Mat &) {
+    add(src, Scalar::all(params.brightness), dst);
+}
+
+void meanFilterInto(Volumetrics &, const Mat &src, Mat &dst, const EffectParams &params, Mat &) {
+    int kernelSize = oddKernelSize(params.smoothKernelSize, 1);
+    blur(src, dst, Size(kernelSize, kernelSize));
+}
+
+void gaussianFilterInto(Volumetrics &, const Mat &src, Mat &dst, const EffectParams &params, Mat &) {
+    int kernelSize = oddKernelSize(params.smoothKernelSize, 1);
+    GaussianBlur(src, dst, Size(kernelSize, kernelSize), params.gaussianSigma);
+}
+
+void medianFilterInto(Volumetrics &, const Mat &src, Mat &dst, const EffectParams &params, Mat &) {
+    medianBlur(src, dst, oddKernelSize(params.smoothKernelSize, 3));
+}
+
+void bilateralFilterInto(Volumetrics &, const Mat &src, Mat &dst, const EffectParams &params, Mat &) {
+    bilateralFilter(src, dst, std::max(params.bilateralDiameter, 1), params.bilateralSigmaColor, params.bilateralSigmaSpace);
+}
+
+void erosionInto(Volumetrics &, const Mat &src, Mat &dst, const EffectParams &params, Mat &scratch) {
+    erode(src, dst, rectKernel(scratch, oddKernelSize(params.morphKernelSize, 1)));
+}
+
+void dilationInto(Volumetrics &, const Mat &src, Mat &dst, const EffectParams &params, Mat &scratch) {
+    dilate(src, dst, rectKernel(scratch, oddKernelSize(params.morphKernelSize, 1)));
+}
+
+void openingInto(Volumetrics &, const Mat &src, Mat &dst, const EffectParams &params, Mat &scratch) {
+    morphologyEx(src, dst, MORPH_OPEN, rectKernel(scratch, oddKernelSize(params.morphKernelSize, 1)));
+}
+
+void closingInto(Volumetrics &, const Mat &src, Mat &dst, const EffectParams &params, Mat &scratch) {
+    morphologyEx(src, dst, MORPH_CLOSE, rectKernel(scratch, oddKernelSize(params.morphKernelSize, 1)));
+}
+
+//* |------------| | Tablas de consulta (efectos punto a punto) | |------------|
+
+void thresholdLut(uchar *lut, const EffectParams &params) {
+    // THRESH_BINARY sobre 8-bit compara contra floor(umbral)
+    int threshold = cvFloor(params.threshold);
+    for (int value = 0; value < 256; value++) {
+        lut[value] = (value > threshold) ? 255 : 0;
+    }
+}
+
+void brightnessLut(uchar *lut, const EffectParams &params) {
+    for (int value = 0; value < 256; value++) {
+        lut[value] = saturate_cast<uchar>(value + params.brightness);
+    }
+}
+
+//* |------------| | Tabla | |------------|
+
+constexpr unsigned smoothParams = paramBit(EffectParamId::SmoothKernelSize);
+constexpr unsigned morphParams = paramBit(EffectParamId::MorphKernelSize);
+
+constexpr array<EffectDescriptor, EffectCount> effectTable{{
+    {EffectId::None, "Ninguno", applyNone, nullptr, nullptr, false, 0},
+    {EffectId::Threshold, "Threshold", applyThreshold, thresholdInto, thresholdLut, true, paramBit(EffectParamId::Threshold)},
+    {EffectId::ContrastStretch, "ContrastStretch", applyContrastStretch, nullptr, nullptr, false, 0},
+    {EffectId::UmbralBinary, "UmbralBinary", applyUmbralBinary, nullptr, nullptr, false, 0},
+    {EffectId::BitwiseAND, "BitwiseAND", applyBitwiseAnd, nullptr, nullptr, false, 0},
+    {EffectId::BitwiseOR, "BitwiseOR", applyBitwiseOr, nullptr, nullptr, false, 0},
+    {EffectId::BitwiseXOR, "BitwiseXOR", applyBitwiseXor, nullptr, nullptr, false, 0},
+    {EffectId::Canny, "Canny", applyCanny, cannyInto, nullptr, false,
+     paramBit(EffectParamId::CannyLower) | paramBit(EffectParamId::CannyUpper)},
+    {EffectId::Brightness, "Brightness", applyBrightness, brightnessInto, brightnessLut, false, paramBit(EffectParamId::Brightness)},
+    {EffectId::MeanFilter, "MeanFilter", applyMeanFilter, meanFilterInto, nullptr, false, smoothParams},
+    {EffectId::GaussianFilter, "GaussianFilter", applyGaussianFilter, gaussianFilterInto, nullptr, false,
+     smoothParams | paramBit(EffectParamId::GaussianSigma)},
+    {EffectId::MedianFilter, "MedianFilter", applyMedianFilter, medianFilterInto, nullptr, false, smoothParams},
+    {EffectId::BilateralFilter, "BilateralFilter", applyBilateralFilter, bilateralFilterInto, nullptr, false,
+     paramBit(EffectParamId::BilateralDiameter) | paramBit(EffectParamId::BilateralSigmaColor) |
+         paramBit(EffectParamId::BilateralSigmaSpace)},
+    {EffectId::Erosion, "Erosion", applyErosion, erosionInto, nullptr, false, morphParams},
+    {EffectId::Dilation, "Dilation", applyDilation, dilationInto, nullptr, false, morphParams},
+    {EffectId::Opening, "Opening", applyOpening, openingInto, nullptr, false, morphParams},
+    {EffectId::Closing, "Closing", applyClosing, closingInto, nullptr, false, morphParams},
+    {EffectId::HistogramEqualization, "HistogramEqualization", applyHistogramEqualization, nullptr, nullptr, false, 0},
+    {EffectId::Emboss, "Emboss", applyEmboss, nullptr, nullptr, false, 0},
+}};
+
+// get() indexa la tabla directamente con el id: las entradas deben seguir el orden del enum
+constexpr bool isTableOrdered() {
+    for (size_t i = 0; i < effectTable.size(); i++) {
+        if (effectTable[i].id != static_cast<EffectId>(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(isTableOrdered(), "effectTable debe seguir el orden de EffectId");
+
+//* |------------| | Parámetros | |------------|
+
+// Rangos de los controles de la interfaz; los valores por defecto son los de EffectParams
+constexpr array<EffectParamSpec, EffectParamCount> paramTable{{
+    {EffectParamId::Threshold, "threshold", "Umbral", 0.0, 255.0, 1.0, false},
+    {EffectParamId::CannyLower, "canny-lower", "Canny inferior", 0.0, 255.0, 1.0, false},
+    {EffectParamId::CannyUpper, "canny-upper", "Canny superior", 0.0, 510.0, 1.0, false},
+    {EffectParamId::Brightness, "brightness", "Brillo", -255.0, 255.0, 1.0, true},
+    {EffectParamId::SmoothKernelSize, "smooth-kernel", "Kernel de suavizado", 1.0, 31.0, 2.0, true},
+    {EffectParamId::GaussianSigma, "gaussian-sigma", "Sigma gaussiano", 0.1, 10.0, 0.1, false},
+    {EffectParamId::BilateralDiameter, "bilateral-diameter", "Diámetro bilateral", 1.0, 25.0, 1.0, true},
+    {EffectParamId::BilateralSigmaColor, "bilateral-sigma-color", "Sigma color", 1.0, 200.0, 1.0, false},
+    {EffectParamId::BilateralSigmaSpace, "bilateral-sigma-space", "Sigma espacio", 1.0, 200.0, 1.0, false},
+    {EffectParamId::MorphKernelSize, "morph-kernel", "Kernel morfológico", 1.0, 21.0, 2.0, true},
+}};
+
+constexpr bool isParamTableOrdered() {
+    for (size_t i = 0; i < paramTable.size(); i++) {
+        if (paramTable[i].id != static_cast<EffectParamId>(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(isParamTableOrdered(), "paramTable debe seguir el orden de EffectParamId");
+
+} // namespace
+
+bool EffectParams::operator==(const EffectParams &other) const {
+    return threshold == other.threshold && cannyLower == other.cannyLower && cannyUpper == other.cannyUpper &&
+           brightness == other.brightness && smoothKernelSize == other.smoothKernelSize &&
+           gaussianSigma == other.gaussianSigma && bilateralDiameter == other.bilateralDiameter &&
+           bilateralSigmaColor == other.bilateralSigmaColor && bilateralSigmaSpace == other.bilateralSigmaSpace &&
+           morphKernelSize == other.morphKernelSize;
+}
+
+namespace EffectRegistry {
+
+/**
+ * @brief Devuelve la tabla completa de efectos (en el orden del combo)
+ */
+const array<EffectDescriptor, EffectCount> &all() {
+    return effectTable;
+}
+
+/**
+ * @brief Devuelve la entrada de un efecto
+ */
+const EffectDescriptor &get(EffectId id) {
+    size_t index = static_cast<size_t>(id);
+    return effectTable[index < effectTable.size() ? index : 0];
+}
+
+/**
+ * @brief Resuelve el nombre de un efecto a su id (búsqueda lineal, solo al cambiar la selección)
+ * @return EffectId::None si el nombre no corresponde a ningún efecto
+ */
+EffectId idFromName(const string &name) {
+    for (const EffectDescriptor &descriptor : effectTable) {
+        if (name == descriptor.name) {
+            return descriptor.id;
+        }
+    }
+    return EffectId::None;
+}
+
+/**
+ * @brief Aplica un efecto: una sola llamada indirecta a través de la tabla
+ * @param id Efecto a aplicar
+ * @param volumetrics Objeto Volumetrics con el slice y la máscara actuales
+ * @param slice Imagen de entrada
+ * @param params Parámetros del efecto
+ * @return Imagen con el efecto aplicado
+ */
+Mat apply(EffectId id, Volumetrics &volumetrics, const Mat &slice, const EffectParams &params) {
+    const EffectDescriptor &descriptor = get(id);
+    TRACE_SCOPE(descriptor.name); // Los nombres de la tabla son literales
+    return descriptor.apply(volumetrics, slice, params);
+}
+
+/**
+ * @brief Devuelve la tabla de parámetros ajustables (en el orden de EffectParamId)
+ */
+const array<EffectParamSpec, EffectParamCount> &paramSpecs() {
+    return paramTable;
+}
+
+/**
+ * @brief Devuelve la descripción de un parámetro
+ */
+const EffectParamSpec &paramSpec(EffectParamId id) {
+    size_t index = static_cast<size_t>(id);
+    return paramTable[index < paramTable.size() ? index : 0];
+}
+
+/**
+ * @brief Resuelve el nombre de línea de comandos de un parámetro ("threshold", "morph-kernel"...)
+ * @return false si no corresponde a ningún parámetro
+ */
+bool paramFromKey(const string &key, EffectParamId &id) {
+    for (const EffectParamSpec &spec : paramTable) {
+        if (key == spec.key) {
+            id = spec.id;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Parámetros que usa un efecto, en el orden de la tabla
+ */
+vector<EffectParamId> paramsOf(EffectId id) {
+    vector<EffectParamId> params;
+    unsigned bits = get(id).params;
+    for (const EffectParamSpec &spec : paramTable) {
+        if (bits & paramBit(spec.id)) {
+            params.push_back(spec.id);
+        }
+    }
+    return params;
+}
+
+/**
+ * @brief Lee un parámetro de EffectParams
+ */
+double getParam(const EffectParams &params, EffectParamId id) {
+    switch (id) {
+    case EffectParamId::Threshold:
+        return params.threshold;
+    case EffectParamId::CannyLower:
+        return params.cannyLower;
+    case EffectParamId::CannyUpper:
+        return params.cannyUpper;
+    case EffectParamId::Brightness:
+        return params.brightness;
+    case EffectParamId::SmoothKernelSize:
+        return params.smoothKernelSize;
+    case EffectParamId::GaussianSigma:
+        return params.gaussianSigma;
+    case EffectParamId::BilateralDiameter:
+        return params.bilateralDiameter;
+    case EffectParamId::BilateralSigmaColor:
+        return params.bilateralSigmaColor;
+    case EffectParamId::BilateralSigmaSpace:
+        return params.bilateralSigmaSpace;
+    case EffectParamId::MorphKernelSize:
+        return params.morphKernelSize;
+    case EffectParamId::Count:
+        break;
+    }
+    return 0.0;
+}
+
+/**
+ * @brief Escribe un parámetro de EffectParams, ajustado a su rango y a su paso
+ * @return Valor realmente guardado
+ */
+double setParam(EffectParams &params, EffectParamId id, double value) {
+    const EffectParamSpec &spec = paramSpec(id);
+    value = std::clamp(value, spec.minimum, spec.maximum);
+    value = spec.minimum + std::round((value - spec.minimum) / spec.step) * spec.step;
+    value = std::min(value, spec.maximum);
+    int integer = static_cast<int>(std::lround(value));
+
+    switch (id) {
+    case EffectParamId::Threshold:
+        params.threshold = value;
+        break;
+    case EffectParamId::CannyLower:
+        params.cannyLower = value;
+        break;
+    case EffectParamId::CannyUpper:
+        params.cannyUpper = value;
+        break;
+    case EffectParamId::Brightness:
+        params.brightness = integer;
+        break;
+    case EffectParamId::SmoothKernelSize:
+        params.smoothKernelSize = integer;
+        break;
+    case EffectParamId::GaussianSigma:
+        params.gaussianSigma = value;
+        break;
+    case EffectParamId::BilateralDiameter:
+        params.bilateralDiameter = integer;
+        break;
+    case EffectParamId::BilateralSigmaColor:
+        params.bilateralSigmaColor = value;
+        break;
+    case EffectParamId::BilateralSigmaSpace:
+        params.bilateralSigmaSpace = value;
+        break;
+    case EffectParamId::MorphKernelSize:
+        params.morphKernelSize = integer;
+        break;
+    case EffectParamId::Count:
+        break;
+    }
+    return getParam(params, id);
+}
+
+} // namespace EffectRegistry
@@ -0,0 +1,142 @@
+#include "helpers/FrameSink.h"
+#include "helpers/Trace.h"
+
+#include <filesystem>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+using namespace cv;
+using namespace std;
+namespace fs = std::filesystem;
+
+//* |------------| | Formatos | |------------|
+
+namespace VideoFormats {
+
+const vector<VideoFormat> &all() {
+    static const vector<VideoFormat> formats = {
+        {"mp4", "MP4 (mp4v)", ".mp4", "mp4v", false, false},
+        {"avi", "AVI (Motion JPEG)", ".avi", "MJPG", false, false},
+        {"ffv1", "MKV sin pérdida (FFV1)", ".mkv", "FFV1", true, false},
+        {"png", "Secuencia de PNG", "", "", true, true},
+    };
+    return formats;
+}
+
+/**
+ * @return nullptr si no hay un formato con ese nombre
+ */
+const VideoFormat *find(const string &name) {
+    for (const VideoFormat &format : all()) {
+        if (name == format.name) {
+            return &format;
+        }
+    }
+    return nullptr;
+}
+
+const VideoFormat &defaultFormat() {
+    return all().front();
+}
+
+string names() {
+    string text;
+    for (const VideoFormat &format : all()) {
+        text += (text.empty() ? "" : ", ") + string(format.name);
+    }
+    return text;
+}
+
+} // namespace VideoFormats
+
+//* |------------| | FrameSink | |------------|
+
+/**
+ * @param format Formato de salida
+ * @param fps Frames por segundo (se ignora en las secuencias de imágenes)
+ * @param basePath Ruta sin extensión: se le añade la del formato, o es la carpeta de la secuencia
+ */
+FrameSink::FrameSink(const VideoFormat &format, double fps, const string &basePath)
+    : format(format), fps(fps), outputPath(basePath + format.extension) {
+    // Compresión PNG rápida: sigue siendo sin pérdida y exportar no espera al compresor
+    pngParams = {IMWRITE_PNG_COMPRESSION, 1};
+}
+
+FrameSink::~FrameSink() {
+    close();
+}
+
+/**
+ * @brief Crea el archivo de video (o la carpeta de la secuencia) con el tamaño del primer frame
+ */
+bool FrameSink::open(const Mat &frame, string &error) {
+    size = frame.size();
+    if (format.imageSequence) {
+        std::error_code fsError;
+        fs::create_directories(outputPath, fsError);
+        if (fsError) {
+            error = "no se pudo crear la carpeta " + outputPath + ": " + fsError.message();
+            return false;
+        }
+    } else {
+        const char *codec = format.fourcc;
+        writer.open(outputPath, VideoWriter::fourcc(codec[0], codec[1], codec[2], codec[3]), fps, size,
+                    /*isColor=*/true);
+        if (!writer.isOpened()) {
+            error = "no se pudo crear el archivo de video " + outputPath + " (codec " + codec + ")";
+            return false;
+        }
+    }
+    opened = true;
+    return true;
+}
+
+/**
+ * @brief Escribe un frame; el primero fija el tamaño y los demás se reescalan a él
+ * @param frame Frame CV_8UC1 o CV_8UC3 (BGR); los vacíos se ignoran
+ * @param number Número del frame en el nombre de la secuencia (slice_<number>.png)
+ * @param error Mensaje si no se pudo escribir
+ * @return false si no se pudo abrir la salida o escribir el frame
+ */
+bool FrameSink::write(const Mat &frame, int number, string &error) {
+    TRACE_SCOPE("FrameSink::write");
+    if (frame.empty()) {
+        return true;
+    }
+    if (!opened && !open(frame, error)) {
+        return false;
+    }
+
+    const Mat *out = &frame;
+    if (out->size() != size) {
+        resize(*out, resizedFrame, size);
+        out = &resizedFrame;
+    }
+
+    if (format.imageSequence) {
+        // PNG admite grises: la secuencia se escribe tal cual, sin triplicar el canal
+        string framePath = (fs::path(outputPath) / ("slice_" + to_string(number) + ".png")).string();
+        if (!imwrite(framePath, *out, pngParams)) {
+            error = "no se pudo escribir " + framePath;
+            return false;
+        }
+    } else {
+        // VideoWriter espera color
+        if (out->channels() == 1) {
+            cvtColor(*out, colorFrame, COLOR_GRAY2BGR);
+            out = &colorFrame;
+        }
+        writer.write(*out);
+    }
+    written++;
+    return true;
+}
+
+/**
+ * @brief Cierra el archivo de video (la secuencia no necesita cerrarse)
+ */
+void FrameSink::close() {
+    if (writer.isOpened()) {
+        writer.release();
+    }
+}
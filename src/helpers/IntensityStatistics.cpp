@@ -0,0 +1,274 @@
+#include "helpers/IntensityStatistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <opencv2/imgproc.hpp>
+
+using namespace cv;
+using namespace std;
+
+namespace IntensityStatistics {
+
+namespace {
+
+// Valor en la posición rank (desde 0) de los datos ya ordenados
+int valueAtRank(const IntensityHistogram &histogram, uint64_t rank) {
+    uint64_t cumulative = 0;
+    for (int value = 0; value < 256; value++) {
+        cumulative += histogram[value];
+        if (cumulative > rank) {
+            return value;
+        }
+    }
+    return 255;
+}
+
+// Cuantil con interpolación lineal entre rangos: posición (n - 1) * q
+double quantile(const IntensityHistogram &histogram, uint64_t count, double q) {
+    double position = static_cast<double>(count - 1) * q;
+    uint64_t lower = static_cast<uint64_t>(floor(position));
+    double fraction = position - static_cast<double>(lower);
+
+    int lowerValue = valueAtRank(histogram, lower);
+    int upperValue = (fraction > 0.0) ? valueAtRank(histogram, lower + 1) : lowerValue;
+    return lowerValue + fraction * (upperValue - lowerValue);
+}
+
+string formatNumber(double value, int decimals = 0) {
+    char text[32];
+    snprintf(text, sizeof(text), "%.*f", decimals, value);
+    return text;
+}
+
+//* |------------| | Marco común de los gráficos | |------------|
+
+const Scalar black(0, 0, 0);
+const Scalar white(255, 255, 255);
+const Scalar gridGray(220, 220, 220);
+
+/**
+ * @brief Zona de dibujo con eje Y lineal entre yMin e yMax
+ */
+struct PlotArea {
+    Rect frame;
+    double yMin;
+    double yMax;
+
+    int toY(double value) const {
+        double t = (yMax > yMin) ? (value - yMin) / (yMax - yMin) : 0.0;
+        return frame.y + frame.height - cvRound(t * frame.height);
+    }
+};
+
+/**
+ * @brief Crea el lienzo con título, eje Y (5 marcas con su valor) y eje X
+ * @details Hershey solo dibuja ASCII: los textos de los gráficos van sin tildes
+ */
+PlotArea startPlot(Mat &canvas, Size size, const string &title, const string &yLabel, double yMin, double yMax) {
+    canvas.create(size, CV_8UC3);
+    canvas.setTo(white);
+
+    PlotArea area{Rect(70, 50, size.width - 90, size.height - 100), yMin, yMax};
+
+    int baseline = 0;
+    Size titleSize = getTextSize(title, FONT_HERSHEY_SIMPLEX, 0.6, 1, &baseline);
+    putText(canvas, title, Point((size.width - titleSize.width) / 2, 25), FONT_HERSHEY_SIMPLEX, 0.6, black, 1, LINE_AA);
+    putText(canvas, yLabel, Point(5, 42), FONT_HERSHEY_SIMPLEX, 0.4, black, 1, LINE_AA);
+
+    for (int tick = 0; tick <= 4; tick++) {
+        double value = yMin + (yMax - yMin) * tick / 4.0;
+        int y = area.toY(value);
+        line(canvas, Point(area.frame.x, y), Point(area.frame.br().x, y), gridGray, 1);
+        putText(canvas, formatNumber(value, (yMax - yMin) < 10 ? 1 : 0), Point(5, y + 4), FONT_HERSHEY_SIMPLEX, 0.4, black, 1,
+                LINE_AA);
+    }
+
+    line(canvas, Point(area.frame.x, area.frame.y), Point(area.frame.x, area.frame.br().y), black, 1);
+    line(canvas, Point(area.frame.x, area.frame.br().y), area.frame.br(), black, 1);
+    return area;
+}
+
+} // namespace
+
+bool computeMasked(const Mat &slice, const Mat &mask, IntensityStats &stats) {
+    if (slice.empty() || mask.empty() || slice.size() != mask.size() || mask.type() != CV_8UC1) {
+        return false;
+    }
+
+    Mat graySlice;
+    if (slice.channels() == 3) {
+        cvtColor(slice, graySlice, COLOR_BGR2GRAY);
+    } else {
+        graySlice = slice;
+    }
+    if (graySlice.type() != CV_8UC1) {
+        return false;
+    }
+
+    // Una pasada: cada píxel suma 1 a su bin si está dentro de la máscara (sin saltos)
+    IntensityHistogram histogram{};
+    for (int y = 0; y < graySlice.rows; y++) {
+        const uchar *ptrGray = graySlice.ptr<uchar>(y);
+        const uchar *ptrMask = mask.ptr<uchar>(y);
+        for (int x = 0; x < graySlice.cols; x++) {
+            histogram[ptrGray[x]] += (ptrMask[x] != 0);
+        }
+    }
+
+    stats = fromHistogram(histogram);
+    return stats.count > 0;
+}
+
+IntensityStats fromHistogram(const IntensityHistogram &histogram) {
+    IntensityStats stats;
+    stats.histogram = histogram;
+
+    double sum = 0.0;
+    for (int value = 0; value < 256; value++) {
+        stats.count += histogram[value];
+        sum += static_cast<double>(histogram[value]) * value;
+    }
+    if (stats.count == 0) {
+        return stats;
+    }
+
+    stats.minimum = 0;
+    while (histogram[stats.minimum] == 0) {
+        stats.minimum++;
+    }
+    stats.maximum = 255;
+    while (histogram[stats.maximum] == 0) {
+        stats.maximum--;
+    }
+
+    stats.mean = sum / static_cast<double>(stats.count);
+    stats.q1 = quantile(histogram, stats.count, 0.25);
+    stats.median = quantile(histogram, stats.count, 0.50);
+    stats.q3 = quantile(histogram, stats.count, 0.75);
+    stats.iqr = stats.q3 - stats.q1;
+    stats.lowerFence = stats.q1 - 1.5 * stats.iqr;
+    stats.upperFence = stats.q3 + 1.5 * stats.iqr;
+
+    for (int value = stats.minimum; value <= stats.maximum; value++) {
+        if (value < stats.lowerFence || value > stats.upperFence) {
+            stats.outliers += histogram[value];
+        }
+    }
+    return stats;
+}
+
+string report(const IntensityStats &stats) {
+    string text;
+    text += "Minimo: " + formatNumber(stats.minimum, 2) + "\n";
+    text += "Q1 (25%): " + formatNumber(stats.q1, 2) + "\n";
+    text += "Mediana (50%): " + formatNumber(stats.median, 2) + "\n";
+    text += "Q3 (75%): " + formatNumber(stats.q3, 2) + "\n";
+    text += "Maximo: " + formatNumber(stats.maximum, 2) + "\n";
+    text += "Media: " + formatNumber(stats.mean, 2) + "\n";
+    text += "IQR: " + formatNumber(stats.iqr, 2) + "\n";
+    text += "Outliers (1.5×IQR): " + to_string(stats.outliers) + "\n";
+    text += "Pixeles: " + to_string(stats.count) + "\n";
+    return text;
+}
+
+Mat drawHistogram(const IntensityStats &stats, Size size) {
+    uint64_t maxCount = *max_element(stats.histogram.begin(), stats.histogram.end());
+
+    Mat canvas;
+    PlotArea area = startPlot(canvas, size, "Histograma de intensidades", "Frecuencia", 0.0,
+                              static_cast<double>(max<uint64_t>(maxCount, 1)));
+
+    // Un bin por intensidad, repartidos a lo ancho del eje X
+    for (int value = 0; value < 256; value++) {
+        if (stats.histogram[value] == 0) {
+            continue;
+        }
+        int x0 = area.frame.x + value * area.frame.width / 256;
+        int x1 = area.frame.x + (value + 1) * area.frame.width / 256;
+        rectangle(canvas, Point(x0, area.toY(static_cast<double>(stats.histogram[value]))), Point(max(x0, x1 - 1), area.frame.br().y),
+                  Scalar(128, 128, 128), FILLED);
+    }
+
+    for (int value : {0, 64, 128, 192, 255}) {
+        int x = area.frame.x + value * area.frame.width / 256;
+        line(canvas, Point(x, area.frame.br().y), Point(x, area.frame.br().y + 5), black, 1);
+        putText(canvas, to_string(value), Point(x - 8, area.frame.br().y + 20), FONT_HERSHEY_SIMPLEX, 0.4, black, 1, LINE_AA);
+    }
+    putText(canvas, "Intensidad pixel", Point(area.frame.x + area.frame.width / 2 - 50, size.height - 15), FONT_HERSHEY_SIMPLEX,
+            0.45, black, 1, LINE_AA);
+    return canvas;
+}
+
+Mat drawBoxplot(const IntensityStats &stats, Size size) {
+    double yMin = max(0, stats.minimum - 5);
+    double yMax = min(255, stats.maximum + 5);
+
+    Mat canvas;
+    PlotArea area = startPlot(canvas, size, "Diagrama de caja y bigotes", "Intensidad pixel", yMin, yMax);
+    if (stats.count == 0) {
+        return canvas;
+    }
+
+    // Bigotes: el dato más extremo que sigue dentro de las vallas
+    int whiskerLow = stats.minimum;
+    while (whiskerLow < stats.lowerFence) {
+        whiskerLow++;
+    }
+    while (stats.histogram[whiskerLow] == 0) {
+        whiskerLow++;
+    }
+    int whiskerHigh = stats.maximum;
+    while (whiskerHigh > stats.upperFence) {
+        whiskerHigh--;
+    }
+    while (stats.histogram[whiskerHigh] == 0) {
+        whiskerHigh--;
+    }
+
+    int centerX = area.frame.x + area.frame.width / 2;
+    int halfWidth = area.frame.width / 6;
+
+    line(canvas, Point(centerX, area.toY(whiskerLow)), Point(centerX, area.toY(stats.q1)), black, 1);
+    line(canvas, Point(centerX, area.toY(stats.q3)), Point(centerX, area.toY(whiskerHigh)), black, 1);
+    line(canvas, Point(centerX - halfWidth / 2, area.toY(whiskerLow)), Point(centerX + halfWidth / 2, area.toY(whiskerLow)), black, 1);
+    line(canvas, Point(centerX - halfWidth / 2, area.toY(whiskerHigh)), Point(centerX + halfWidth / 2, area.toY(whiskerHigh)), black, 1);
+
+    Rect box(Point(centerX - halfWidth, area.toY(stats.q3)), Point(centerX + halfWidth, area.toY(stats.q1)));
+    rectangle(canvas, box, Scalar(230, 216, 173), FILLED);
+    rectangle(canvas, box, Scalar(255, 0, 0), 1);
+    line(canvas, Point(centerX - halfWidth, area.toY(stats.median)), Point(centerX + halfWidth, area.toY(stats.median)),
+         Scalar(0, 0, 255), 2);
+
+    // Outliers: un punto por cada intensidad distinta fuera de las vallas
+    for (int value = stats.minimum; value <= stats.maximum; value++) {
+        if (stats.histogram[value] > 0 && (value < stats.lowerFence || value > stats.upperFence)) {
+            circle(canvas, Point(centerX, area.toY(value)), 3, Scalar(0, 0, 255), FILLED, LINE_AA);
+        }
+    }
+    return canvas;
+}
+
+Mat drawSummary(const IntensityStats &stats, Size size) {
+    const char *names[] = {"Min", "Q1", "Med", "Q3", "Max"};
+    double values[] = {static_cast<double>(stats.minimum), stats.q1, stats.median, stats.q3, static_cast<double>(stats.maximum)};
+
+    Mat canvas;
+    PlotArea area = startPlot(canvas, size, "Resumen de estadisticos basicos", "Valor", 0.0, max(1.0, values[4]));
+
+    int slotWidth = area.frame.width / 5;
+    for (int i = 0; i < 5; i++) {
+        int x0 = area.frame.x + i * slotWidth + slotWidth / 5;
+        int x1 = area.frame.x + (i + 1) * slotWidth - slotWidth / 5;
+        Rect bar(Point(x0, area.toY(values[i])), Point(x1, area.frame.br().y));
+        rectangle(canvas, bar, Scalar(235, 206, 135), FILLED);
+        rectangle(canvas, bar, black, 1);
+
+        putText(canvas, formatNumber(values[i], 1), Point(x0, bar.y - 5), FONT_HERSHEY_SIMPLEX, 0.4, black, 1, LINE_AA);
+        putText(canvas, names[i], Point(x0 + (x1 - x0) / 2 - 12, area.frame.br().y + 20), FONT_HERSHEY_SIMPLEX, 0.45, black, 1,
+                LINE_AA);
+    }
+    return canvas;
+}
+
+} // namespace IntensityStatistics
@@ -0,0 +1,217 @@
+#include "helpers/IntensityWindow.h"
+#include "helpers/SlabParallel.h"
+#include "helpers/Trace.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <type_traits>
+#include <utility>
+
+using namespace cv;
+using namespace std;
+
+namespace IntensityWindowing {
+
+namespace {
+
+template <typename Pixel>
+void quantizeVoxels(const Pixel *voxels, int width, int height, int depth, QuantizedVolume &volume, bool keepLevels,
+                    size_t threads) {
+    constexpr bool integral = is_integral<Pixel>::value;
+    const size_t sliceVoxels = static_cast<size_t>(width) * height;
+
+    // 1) Rango de intensidades (los NaN no cuentan: ninguna comparación con ellos es cierta)
+    using Range = pair<float, float>;
+    vector<Range> ranges = forEachSlab<Range>(depth, threads, [&](int zBegin, int zEnd) {
+        Range range(FLT_MAX, -FLT_MAX);
+        const Pixel *end = voxels + sliceVoxels * zEnd;
+        for (const Pixel *voxel = voxels + sliceVoxels * zBegin; voxel != end; ++voxel) {
+            range.first = min(range.first, static_cast<float>(*voxel));
+            range.second = max(range.second, static_cast<float>(*voxel));
+        }
+        return range;
+    });
+    Range range(FLT_MAX, -FLT_MAX);
+    for (const Range &slab : ranges) {
+        range.first = min(range.first, slab.first);
+        range.second = max(range.second, slab.second);
+    }
+    if (range.first > range.second) {
+        range = Range(0.0f, 0.0f); // Todo NaN
+    }
+    volume.minimum = range.first;
+    volume.maximum = range.second;
+    volume.voxels = sliceVoxels * depth;
+    volume.integral = integral;
+
+    // Entero: un nivel por valor. Float: floatLevels niveles entre mínimo y máximo
+    if (integral) {
+        volume.levelCount = static_cast<int>(volume.maximum - volume.minimum) + 1;
+        volume.levelWidth = 1.0;
+    } else {
+        volume.levelCount = QuantizedVolume::floatLevels;
+        volume.levelWidth = (volume.maximum - volume.minimum) / double(QuantizedVolume::floatLevels);
+    }
+    const int levelCount = volume.levelCount;
+    const float lower = volume.minimum;
+    const float scale = (volume.maximum > lower) ? levelCount / (volume.maximum - lower) : 0.0f;
+
+    // 2) Histograma (y niveles de un volumen float); cada bloque escribe solo las filas de sus slices
+    const bool writeLevels = !integral && keepLevels;
+    if (writeLevels) {
+        volume.levels.create(depth * height, width, CV_16UC1);
+    }
+    Mat &levels = volume.levels;
+
+    vector<vector<uint64_t>> histograms = forEachSlab<vector<uint64_t>>(depth, threads, [&](int zBegin, int zEnd) {
+        vector<uint64_t> histogram(levelCount, 0);
+        for (int z = zBegin; z < zEnd; z++) {
+            for (int y = 0; y < height; y++) {
+                const Pixel *src = voxels + sliceVoxels * z + static_cast<size_t>(y) * width;
+                if (integral) {
+                    const int offset = static_cast<int>(lower);
+                    for (int x = 0; x < width; x++) {
+                        histogram[static_cast<int>(src[x]) - offset]++;
+                    }
+                    continue;
+                }
+
+                uint16_t *dst = writeLevels ? levels.ptr<uint16_t>(z * height + y) : nullptr;
+                for (int x = 0; x < width; x++) {
+                    float value = static_cast<float>(src[x]);
+                    int level = (value > lower) ? min(levelCount - 1, static_cast<int>((value - lower) * scale)) : 0;
+                    histogram[level]++;
+                    if (dst) {
+                        dst[x] = static_cast<uint16_t>(level);
+                    }
+                }
+            }
+        }
+        return histogram;
+    });
+
+    // 3) Fusionar los histogramas de los bloques
+    volume.histogram.assign(levelCount, 0);
+    for (const vector<uint64_t> &histogram : histograms) {
+        for (int level = 0; level < levelCount; level++) {
+            volume.histogram[level] += histogram[level];
+        }
+    }
+}
+
+} // namespace
+
+bool quantize(const VolumeImage &image, QuantizedVolume &volume, bool keepLevels, size_t threads) {
+    TRACE_SCOPE("IntensityWindowing::quantize");
+    volume = QuantizedVolume();
+    if (!image || image.voxelCount() == 0) {
+        return false;
+    }
+
+    image.visit([&](const auto *voxels) {
+        quantizeVoxels(voxels, image.width(), image.height(), image.depth(), volume, keepLevels, threads);
+    });
+    return true;
+}
+
+IntensityWindow percentileWindow(const QuantizedVolume &volume, double lowPercentile, double highPercentile) {
+    const vector<uint64_t> &histogram = volume.histogram;
+    if (histogram.empty() || !(volume.maximum > volume.minimum)) {
+        return IntensityWindow();
+    }
+
+    int first = 1;
+    uint64_t total = 0;
+    for (size_t level = 1; level < histogram.size(); level++) {
+        total += histogram[level];
+    }
+    if (total == 0) {
+        first = 0;
+        total = histogram[0];
+    }
+
+    // Primer nivel en el que el acumulado alcanza el percentil
+    auto levelAt = [&](double percentile) {
+        double fraction = min(max(percentile / 100.0, 0.0), 1.0);
+        uint64_t target = max<uint64_t>(1, static_cast<uint64_t>(ceil(fraction * total)));
+        uint64_t seen = 0;
+        for (int level = first; level < static_cast<int>(histogram.size()); level++) {
+            seen += histogram[level];
+            if (seen >= target) {
+                return level;
+            }
+        }
+        return static_cast<int>(histogram.size()) - 1;
+    };
+
+    // Borde inferior del nivel bajo y borde superior del alto
+    IntensityWindow window;
+    window.low = volume.levelValue(levelAt(lowPercentile)) - 0.5 * volume.levelWidth;
+    window.high = volume.levelValue(levelAt(highPercentile)) + 0.5 * volume.levelWidth;
+    return window;
+}
+
+bool apply(const VolumeImage &image, const QuantizedVolume &volume, const IntensityWindow &window, Mat &dst,
+           size_t threads) {
+    TRACE_SCOPE("IntensityWindowing::apply");
+    if (!image || volume.levelCount == 0 || !volume.hasLevels(image)) {
+        return false;
+    }
+
+    // Tabla nivel → gris, con el centro de cada nivel (igual que convert sobre los vóxeles)
+    vector<uchar> lut(volume.levelCount, 0);
+    if (window.isValid()) {
+        double scale = 255.0 / window.width();
+        for (int level = 0; level < volume.levelCount; level++) {
+            lut[level] = saturate_cast<uchar>((volume.levelValue(level) - window.low) * scale);
+        }
+    }
+
+    // Reparto por filas de la caché (depth * height), cada bloque escribe solo las suyas
+    const int rows = image.depth() * image.height();
+    const int cols = image.width();
+    const uchar *table = lut.data();
+    dst.create(rows, cols, CV_8UC1);
+
+    auto applyRows = [&](const auto *source, int offset) {
+        forEachSlab<int>(rows, threads, [&](int rowBegin, int rowEnd) {
+            for (int row = rowBegin; row < rowEnd; row++) {
+                const auto *src = source + static_cast<size_t>(row) * cols;
+                uchar *out = dst.ptr<uchar>(row);
+                for (int x = 0; x < cols; x++) {
+                    out[x] = table[static_cast<int>(src[x]) - offset];
+                }
+            }
+            return 0;
+        });
+    };
+
+    if (volume.integral) {
+        // El buffer nativo es el índice: nivel = valor - mínimo
+        image.visit([&](const auto *voxels) { applyRows(voxels, static_cast<int>(volume.minimum)); });
+    } else {
+        applyRows(volume.levels.ptr<uint16_t>(), 0);
+    }
+    return true;
+}
+
+void convert(const Mat &src, const IntensityWindow &window, Mat &dst) {
+    TRACE_SCOPE("IntensityWindowing::convert");
+    if (src.empty()) {
+        dst = Mat();
+        return;
+    }
+
+    if (!window.isValid()) {
+        // Volumen constante o sin ventana: llenamos con ceros
+        dst.create(src.rows, src.cols, CV_8UC1);
+        dst.setTo(Scalar(0));
+        return;
+    }
+
+    double scale = 255.0 / window.width();
+    src.convertTo(dst, CV_8UC1, scale, -window.low * scale);
+}
+
+} // namespace IntensityWindowing
@@ -0,0 +1,285 @@
+#include "helpers/OverlayKernels.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define OVERLAY_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace OverlayKernels {
+
+namespace {
+
+using BlendRowFunction = void (*)(const uint8_t *, const uint8_t *, uint8_t *, int, OverlayColor);
+using BlendLabelRowFunction = void (*)(const uint8_t *, const uint8_t *, uint8_t *, int, const LabelPalette &);
+
+// Mismo cálculo que los caminos SIMD, un píxel a la vez
+inline uint8_t blendChannel(unsigned base, unsigned color, unsigned alpha) {
+    unsigned t = base + color * alpha;
+    return static_cast<uint8_t>((t + (t >> 8)) >> 8);
+}
+
+inline void blendPixel(uint8_t gray, unsigned alpha, uint8_t b, uint8_t g, uint8_t r, uint8_t *bgr) {
+    unsigned base = gray * (255u - alpha) + 128u;
+    bgr[0] = blendChannel(base, b, alpha);
+    bgr[1] = blendChannel(base, g, alpha);
+    bgr[2] = blendChannel(base, r, alpha);
+}
+
+#ifdef OVERLAY_KERNELS_X86
+
+/**
+ * @brief Máscaras de pshufb para intercalar 16 B, 16 G y 16 R en 48 bytes BGR
+ * @details mask[k][c][i] es el píxel del canal c que va en el byte i del bloque k
+ * (0x80 = poner un cero, lo aporta otro canal)
+ */
+struct InterleaveMasks {
+    alignas(16) uint8_t mask[3][3][16];
+
+    constexpr InterleaveMasks() : mask{} {
+        for (int block = 0; block < 3; block++) {
+            for (int channel = 0; channel < 3; channel++) {
+                for (int i = 0; i < 16; i++) {
+                    int position = 16 * block + i;
+                    mask[block][channel][i] = (position % 3 == channel) ? static_cast<uint8_t>(position / 3) : 0x80;
+                }
+            }
+        }
+    }
+};
+
+constexpr InterleaveMasks interleaveMasks;
+
+__attribute__((target("ssse3"))) inline void storeInterleaved(uint8_t *bgr, __m128i b, __m128i g, __m128i r) {
+    for (int block = 0; block < 3; block++) {
+        const __m128i *masks = reinterpret_cast<const __m128i *>(interleaveMasks.mask[block]);
+        __m128i out = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(b, _mm_load_si128(masks + 0)),
+                                                _mm_shuffle_epi8(g, _mm_load_si128(masks + 1))),
+                                   _mm_shuffle_epi8(r, _mm_load_si128(masks + 2)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(bgr + 16 * block), out);
+    }
+}
+
+// (t + (t >> 8)) >> 8 sobre carriles de 16 bits
+__attribute__((target("ssse3"))) inline __m128i divide255(__m128i t) {
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+__attribute__((target("avx2"))) inline __m256i divide255(__m256i t) {
+    return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+}
+
+// Un canal de 16 píxeles; base (gris * (255 - alfa) + 128) ya viene calculada en dos mitades
+__attribute__((target("ssse3"))) inline __m128i blendChannel16(__m128i baseLo, __m128i baseHi, __m128i aLo,
+                                                                __m128i aHi, __m128i color8) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i cLo = _mm_unpacklo_epi8(color8, zero), cHi = _mm_unpackhi_epi8(color8, zero);
+    return _mm_packus_epi16(divide255(_mm_add_epi16(baseLo, _mm_mullo_epi16(aLo, cLo))),
+                            divide255(_mm_add_epi16(baseHi, _mm_mullo_epi16(aHi, cHi))));
+}
+
+/**
+ * @brief Mezcla 16 píxeles con alfa y color por píxel (8 por registro en carriles de 16 bits)
+ */
+__attribute__((target("ssse3"))) inline void blend16(const uint8_t *gray, __m128i a8, __m128i b8, __m128i g8,
+                                                      __m128i r8, uint8_t *bgr) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i v255 = _mm_set1_epi16(255);
+    const __m128i v128 = _mm_set1_epi16(128);
+
+    __m128i gray8 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(gray));
+    __m128i grayLo = _mm_unpacklo_epi8(gray8, zero), grayHi = _mm_unpackhi_epi8(gray8, zero);
+    __m128i aLo = _mm_unpacklo_epi8(a8, zero), aHi = _mm_unpackhi_epi8(a8, zero);
+
+    // Parte común a los tres canales: gris * (255 - alfa) + 128
+    __m128i baseLo = _mm_add_epi16(_mm_mullo_epi16(grayLo, _mm_sub_epi16(v255, aLo)), v128);
+    __m128i baseHi = _mm_add_epi16(_mm_mullo_epi16(grayHi, _mm_sub_epi16(v255, aHi)), v128);
+
+    storeInterleaved(bgr, blendChannel16(baseLo, baseHi, aLo, aHi, b8), blendChannel16(baseLo, baseHi, aLo, aHi, g8),
+                     blendChannel16(baseLo, baseHi, aLo, aHi, r8));
+}
+
+// packus trabaja por mitades de 128 bits: reordenar los cuartos para recuperar el orden
+__attribute__((target("avx2"))) inline __m256i packOrdered(__m256i lo, __m256i hi) {
+    return _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xD8);
+}
+
+__attribute__((target("avx2"))) inline __m256i blendChannel32(__m256i baseLo, __m256i baseHi, __m256i aLo,
+                                                               __m256i aHi, __m256i color8) {
+    __m256i cLo = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(color8));
+    __m256i cHi = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(color8, 1));
+    return packOrdered(divide255(_mm256_add_epi16(baseLo, _mm256_mullo_epi16(aLo, cLo))),
+                       divide255(_mm256_add_epi16(baseHi, _mm256_mullo_epi16(aHi, cHi))));
+}
+
+/**
+ * @brief Mezcla 32 píxeles con alfa y color por píxel (16 por registro en carriles de 16 bits)
+ */
+__attribute__((target("avx2"))) inline void blend32(const uint8_t *gray, __m256i a8, __m256i b8, __m256i g8,
+                                                     __m256i r8, uint8_t *bgr) {
+    const __m256i v255 = _mm256_set1_epi16(255);
+    const __m256i v128 = _mm256_set1_epi16(128);
+
+    __m256i gray8 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(gray));
+    __m256i grayLo = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(gray8));
+    __m256i grayHi = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(gray8, 1));
+    __m256i aLo = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(a8));
+    __m256i aHi = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(a8, 1));
+
+    __m256i baseLo = _mm256_add_epi16(_mm256_mullo_epi16(grayLo, _mm256_sub_epi16(v255, aLo)), v128);
+    __m256i baseHi = _mm256_add_epi16(_mm256_mullo_epi16(grayHi, _mm256_sub_epi16(v255, aHi)), v128);
+
+    __m256i b = blendChannel32(baseLo, baseHi, aLo, aHi, b8);
+    __m256i g = blendChannel32(baseLo, baseHi, aLo, aHi, g8);
+    __m256i r = blendChannel32(baseLo, baseHi, aLo, aHi, r8);
+
+    storeInterleaved(bgr, _mm256_castsi256_si128(b), _mm256_castsi256_si128(g), _mm256_castsi256_si128(r));
+    storeInterleaved(bgr + 48, _mm256_extracti128_si256(b, 1), _mm256_extracti128_si256(g, 1),
+                     _mm256_extracti128_si256(r, 1));
+}
+
+//* |------------| | Un solo color | |------------|
+
+__attribute__((target("ssse3"))) void blendGrayRowSsse3(const uint8_t *gray, const uint8_t *alpha, uint8_t *bgr,
+                                                          int count, OverlayColor color) {
+    const __m128i colorB = _mm_set1_epi8(static_cast<char>(color.b));
+    const __m128i colorG = _mm_set1_epi8(static_cast<char>(color.g));
+    const __m128i colorR = _mm_set1_epi8(static_cast<char>(color.r));
+
+    int x = 0;
+    for (; x + 16 <= count; x += 16) {
+        __m128i a8 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(alpha + x));
+        blend16(gray + x, a8, colorB, colorG, colorR, bgr + 3 * x);
+    }
+
+    blendGrayRowScalar(gray + x, alpha + x, bgr + 3 * x, count - x, color);
+}
+
+__attribute__((target("avx2"))) void blendGrayRowAvx2(const uint8_t *gray, const uint8_t *alpha, uint8_t *bgr,
+                                                        int count, OverlayColor color) {
+    const __m256i colorB = _mm256_set1_epi8(static_cast<char>(color.b));
+    const __m256i colorG = _mm256_set1_epi8(static_cast<char>(color.g));
+    const __m256i colorR = _mm256_set1_epi8(static_cast<char>(color.r));
+
+    int x = 0;
+    for (; x + 32 <= count; x += 32) {
+        __m256i a8 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(alpha + x));
+        blend32(gray + x, a8, colorB, colorG, colorR, bgr + 3 * x);
+    }
+
+    blendGrayRowSsse3(gray + x, alpha + x, bgr + 3 * x, count - x, color);
+}
+
+//* |------------| | Paleta por etiqueta | |------------|
+
+/**
+ * @details Las etiquetas < 16 se traducen con pshufb sobre las 16 primeras entradas de la
+ * paleta (una instrucción por tabla); un bloque con alguna etiqueta mayor va por la paleta
+ * completa, píxel a píxel
+ */
+__attribute__((target("ssse3"))) void blendLabelRowSsse3(const uint8_t *gray, const uint8_t *labels, uint8_t *bgr,
+                                                           int count, const LabelPalette &palette) {
+    const __m128i tableAlpha = _mm_loadu_si128(reinterpret_cast<const __m128i *>(palette.alpha));
+    const __m128i tableB = _mm_loadu_si128(reinterpret_cast<const __m128i *>(palette.b));
+    const __m128i tableG = _mm_loadu_si128(reinterpret_cast<const __m128i *>(palette.g));
+    const __m128i tableR = _mm_loadu_si128(reinterpret_cast<const __m128i *>(palette.r));
+    const __m128i v15 = _mm_set1_epi8(15);
+
+    int x = 0;
+    for (; x + 16 <= count; x += 16) {
+        __m128i label8 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(labels + x));
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(label8, v15), v15)) != 0xFFFF) {
+            blendLabelRowScalar(gray + x, labels + x, bgr + 3 * x, 16, palette);
+            continue;
+        }
+
+        blend16(gray + x, _mm_shuffle_epi8(tableAlpha, label8), _mm_shuffle_epi8(tableB, label8),
+                _mm_shuffle_epi8(tableG, label8), _mm_shuffle_epi8(tableR, label8), bgr + 3 * x);
+    }
+
+    blendLabelRowScalar(gray + x, labels + x, bgr + 3 * x, count - x, palette);
+}
+
+// vpshufb busca dentro de cada mitad de 128 bits: la tabla va repetida en ambas
+__attribute__((target("avx2"))) inline __m256i lookupTable32(const uint8_t *entries) {
+    return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(entries)));
+}
+
+__attribute__((target("avx2"))) void blendLabelRowAvx2(const uint8_t *gray, const uint8_t *labels, uint8_t *bgr,
+                                                         int count, const LabelPalette &palette) {
+    const __m256i tableAlpha = lookupTable32(palette.alpha);
+    const __m256i tableB = lookupTable32(palette.b);
+    const __m256i tableG = lookupTable32(palette.g);
+    const __m256i tableR = lookupTable32(palette.r);
+    const __m256i v15 = _mm256_set1_epi8(15);
+
+    int x = 0;
+    for (; x + 32 <= count; x += 32) {
+        __m256i label8 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(labels + x));
+
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(label8, v15), v15)) != -1) {
+            blendLabelRowScalar(gray + x, labels + x, bgr + 3 * x, 32, palette);
+            continue;
+        }
+
+        blend32(gray + x, _mm256_shuffle_epi8(tableAlpha, label8), _mm256_shuffle_epi8(tableB, label8),
+                _mm256_shuffle_epi8(tableG, label8), _mm256_shuffle_epi8(tableR, label8), bgr + 3 * x);
+    }
+
+    blendLabelRowSsse3(gray + x, labels + x, bgr + 3 * x, count - x, palette);
+}
+
+#endif // OVERLAY_KERNELS_X86
+
+struct Dispatch {
+    BlendRowFunction blendRow;
+    BlendLabelRowFunction blendLabelRow;
+    const char *name;
+};
+
+// Se resuelve una sola vez (la primera llamada), según lo que soporte la CPU
+const Dispatch &dispatch() {
+    static const Dispatch selected = [] {
+#ifdef OVERLAY_KERNELS_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return Dispatch{blendGrayRowAvx2, blendLabelRowAvx2, "avx2"};
+        }
+        if (__builtin_cpu_supports("ssse3")) {
+            return Dispatch{blendGrayRowSsse3, blendLabelRowSsse3, "ssse3"};
+        }
+#endif
+        return Dispatch{blendGrayRowScalar, blendLabelRowScalar, "scalar"};
+    }();
+    return selected;
+}
+
+} // namespace
+
+void blendGrayRowScalar(const uint8_t *gray, const uint8_t *alpha, uint8_t *bgr, int count, OverlayColor color) {
+    for (int x = 0; x < count; x++) {
+        blendPixel(gray[x], alpha[x], color.b, color.g, color.r, bgr + 3 * x);
+    }
+}
+
+void blendLabelRowScalar(const uint8_t *gray, const uint8_t *labels, uint8_t *bgr, int count,
+                         const LabelPalette &palette) {
+    for (int x = 0; x < count; x++) {
+        uint8_t label = labels[x];
+        blendPixel(gray[x], palette.alpha[label], palette.b[label], palette.g[label], palette.r[label], bgr + 3 * x);
+    }
+}
+
+void blendGrayRow(const uint8_t *gray, const uint8_t *alpha, uint8_t *bgr, int count, OverlayColor color) {
+    dispatch().blendRow(gray, alpha, bgr, count, color);
+}
+
+void blendLabelRow(const uint8_t *gray, const uint8_t *labels, uint8_t *bgr, int count, const LabelPalette &palette) {
+    dispatch().blendLabelRow(gray, labels, bgr, count, palette);
+}
+
+const char *activePath() {
+    return dispatch().name;
+}
+
+} // namespace OverlayKernels
@@ -0,0 +1,75 @@
+#include "helpers/SliceRenderer.h"
+
+using namespace cv;
+using namespace std;
+
+/**
+ * @brief Deja el estado actual para los hilos de trabajo (llamar desde la interfaz)
+ * @details Solo copia si cambió lo que se muestra desde la última vez
+ */
+void VolumetricsSnapshot::publish(const Volumetrics &volumetrics) {
+    lock_guard<std::mutex> lock(mutex);
+    if (version != volumetrics.getContentVersion() || serial == 0) {
+        snapshot = volumetrics;
+        version = volumetrics.getContentVersion();
+        serial++;
+    }
+}
+
+/**
+ * @brief Renueva la copia propia si la interfaz publicó una más reciente (hilo de trabajo)
+ * @details Llamar después de sacar la petición de la cola: la copia es al menos tan nueva
+ * como la que había cuando se hizo la petición
+ */
+void SliceRenderer::sync(VolumetricsSnapshot &source) {
+    lock_guard<std::mutex> lock(source.mutex);
+    if (serial != source.serial) {
+        volumetrics = source.snapshot;
+        serial = source.serial;
+        originalIndex = -1;
+        graphValid = false;
+    }
+}
+
+/**
+ * @brief Extrae un slice (y su máscara, si hay) de la copia propia
+ * @return El slice original 8-bit
+ */
+Mat SliceRenderer::extract(int sliceIndex) {
+    volumetrics.setSliceIndex(sliceIndex);
+    volumetrics.setSliceAsMat();
+    if (volumetrics.hasMask()) {
+        volumetrics.setSliceMaskAsMat();
+    }
+    original = volumetrics.getSliceAsMat();
+    originalIndex = sliceIndex;
+    return original;
+}
+
+/**
+ * @brief Resaltado + efecto del slice de key
+ * @details Si el slice no es el último extraído, lo extrae antes
+ * @return Copia propia del resultado, lista para guardarse en la caché de resultados
+ */
+Mat SliceRenderer::process(const SliceResultKey &key) {
+    if (originalIndex != key.sliceIndex) {
+        extract(key.sliceIndex);
+    }
+
+    if (!graphValid || graphKey.effectId != key.effectId || graphKey.overlay != key.overlay) {
+        graph.clear();
+        if (key.overlay) {
+            graph.addOverlay();
+        }
+        graph.addEffect(key.effectId, key.params);
+        graph.setInput(original);
+    } else if (graphKey.sliceIndex != key.sliceIndex || graphKey.contentVersion != key.contentVersion) {
+        graph.setInput(original);
+    }
+    graph.setParams(graph.size() - 1, key.params);
+    graphKey = key;
+    graphValid = true;
+
+    // El grafo reutiliza sus buffers: la caché necesita su propia copia
+    return graph.run(volumetrics).clone();
+}
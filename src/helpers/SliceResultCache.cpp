@@ -0,0 +1,147 @@
+#include "helpers/SliceResultCache.h"
+
+#include <functional>
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+inline void hashCombine(size_t &seed, size_t value) {
+    seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+}
+
+} // namespace
+
+bool SliceResultKey::operator==(const SliceResultKey &other) const {
+    return contentVersion == other.contentVersion && sliceIndex == other.sliceIndex && effectId == other.effectId &&
+           overlay == other.overlay && params == other.params;
+}
+
+size_t SliceResultKeyHash::operator()(const SliceResultKey &key) const {
+    const EffectParams &params = key.params;
+    size_t seed = hash<uint64_t>{}(key.contentVersion);
+    hashCombine(seed, hash<int>{}(key.sliceIndex));
+    hashCombine(seed, hash<int>{}(static_cast<int>(key.effectId)));
+    hashCombine(seed, hash<bool>{}(key.overlay));
+    for (double value : {params.threshold, params.cannyLower, params.cannyUpper, params.gaussianSigma, params.bilateralSigmaColor,
+                         params.bilateralSigmaSpace}) {
+        hashCombine(seed, hash<double>{}(value));
+    }
+    for (int value : {params.brightness, params.smoothKernelSize, params.bilateralDiameter, params.morphKernelSize}) {
+        hashCombine(seed, hash<int>{}(value));
+    }
+    return seed;
+}
+
+SliceResultCache::SliceResultCache(size_t budgetBytes) : budgetBytes(budgetBytes) {}
+
+/**
+ * @brief Busca un slice procesado y lo marca como el más reciente
+ * @return false si no está guardado
+ */
+bool SliceResultCache::find(const SliceResultKey &key, Mat &result) {
+    lock_guard<std::mutex> lock(mutex);
+    auto found = index.find(key);
+    if (found == index.end()) {
+        missCount++;
+        return false;
+    }
+
+    entries.splice(entries.begin(), entries, found->second);
+    result = found->second->result;
+    hitCount++;
+    return true;
+}
+
+/**
+ * @brief Indica si un slice ya está guardado, sin cambiar su posición en la LRU
+ */
+bool SliceResultCache::contains(const SliceResultKey &key) const {
+    lock_guard<std::mutex> lock(mutex);
+    return index.count(key) > 0;
+}
+
+/**
+ * @brief Guarda un slice procesado (los vacíos no se guardan)
+ * @details Si result es una vista sobre un buffer mayor (p. ej. la caché 8-bit del volumen)
+ * o sobre memoria ajena se copia: así no se retiene el buffer entero y el presupuesto cuenta
+ * exactamente lo que ocupa cada entrada
+ */
+void SliceResultCache::insert(const SliceResultKey &key, const Mat &result) {
+    if (result.empty()) {
+        return;
+    }
+
+    size_t bytes = result.total() * result.elemSize();
+    if (bytes > budget()) {
+        return;
+    }
+    Mat stored = (result.u && result.u->size == bytes) ? result : result.clone();
+
+    lock_guard<std::mutex> lock(mutex);
+    auto found = index.find(key);
+    if (found != index.end()) {
+        used -= found->second->bytes;
+        entries.erase(found->second);
+        index.erase(found);
+    }
+
+    entries.push_front(Entry{key, stored, bytes});
+    index[key] = entries.begin();
+    used += bytes;
+    evictToBudget();
+}
+
+/**
+ * @brief Descarta todos los resultados guardados
+ */
+void SliceResultCache::clear() {
+    lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    index.clear();
+    used = 0;
+}
+
+/**
+ * @brief Cambia el presupuesto de memoria (en bytes); descarta lo que sobre
+ */
+void SliceResultCache::setBudget(size_t budgetBytes) {
+    lock_guard<std::mutex> lock(mutex);
+    this->budgetBytes = budgetBytes;
+    evictToBudget();
+}
+
+size_t SliceResultCache::budget() const {
+    lock_guard<std::mutex> lock(mutex);
+    return budgetBytes;
+}
+
+size_t SliceResultCache::usedBytes() const {
+    lock_guard<std::mutex> lock(mutex);
+    return used;
+}
+
+size_t SliceResultCache::size() const {
+    lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+uint64_t SliceResultCache::hits() const {
+    lock_guard<std::mutex> lock(mutex);
+    return hitCount;
+}
+
+uint64_t SliceResultCache::misses() const {
+    lock_guard<std::mutex> lock(mutex);
+    return missCount;
+}
+
+// Llamar con mutex tomado
+void SliceResultCache::evictToBudget() {
+    while (used > budgetBytes && !entries.empty()) {
+        used -= entries.back().bytes;
+        index.erase(entries.back().key);
+        entries.pop_back();
+    }
+}
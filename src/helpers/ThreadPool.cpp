@@ -0,0 +1,79 @@
+#include "helpers/ThreadPool.h"
+
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * @brief Crea el pool
+ * @param numThreads Número de hilos; 0 usa todos los núcleos disponibles
+ */
+ThreadPool::ThreadPool(size_t numThreads) {
+    if (numThreads == 0) {
+        numThreads = max(1u, thread::hardware_concurrency());
+    }
+
+    threads.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; i++) {
+        threads.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+/**
+ * @brief Termina las tareas pendientes y espera a todos los hilos
+ */
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+
+    for (thread &worker : threads) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Bloquea hasta que la cola esté vacía y no quede ninguna tarea en ejecución
+ */
+void ThreadPool::waitAll() {
+    unique_lock<std::mutex> lock(mutex);
+    allDone.wait(lock, [this] { return tasks.empty() && activeTasks == 0; });
+}
+
+/**
+ * @brief Devuelve el número de hilos del pool
+ */
+size_t ThreadPool::size() const {
+    return threads.size();
+}
+
+/**
+ * @brief Bucle de cada hilo: toma tareas de la cola hasta que se destruya el pool
+ */
+void ThreadPool::workerLoop() {
+    while (true) {
+        function<void()> task;
+        {
+            unique_lock<std::mutex> lock(mutex);
+            taskAvailable.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                return; // stopping y sin trabajo pendiente
+            }
+            task = std::move(tasks.front());
+            tasks.pop();
+            activeTasks++;
+        }
+
+        task(); // Las excepciones quedan guardadas en el future de la tarea
+
+        {
+            lock_guard<std::mutex> lock(mutex);
+            activeTasks--;
+            if (tasks.empty() && activeTasks == 0) {
+                allDone.notify_all();
+            }
+        }
+    }
+}
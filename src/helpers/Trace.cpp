@@ -0,0 +1,257 @@
+#include "helpers/Trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+namespace {
+
+//* |------------| | Histograma logarítmico | |------------|
+
+// 16 subcubos por potencia de 2 (en ns): cada cubo abarca menos del 7 % de su valor
+constexpr int subBits = 4;
+constexpr int subBuckets = 1 << subBits;
+constexpr int bucketCount = (64 - subBits + 1) * subBuckets;
+
+int bucketOf(uint64_t ns) {
+    if (ns < static_cast<uint64_t>(subBuckets)) {
+        return static_cast<int>(ns);
+    }
+    int msb = 63 - __builtin_clzll(ns);
+    int shift = msb - subBits;
+    return (shift + 1) * subBuckets + static_cast<int>((ns >> shift) & (subBuckets - 1));
+}
+
+// Punto medio del cubo, en ns
+double bucketValue(int bucket) {
+    if (bucket < subBuckets) {
+        return bucket;
+    }
+    int shift = bucket / subBuckets - 1;
+    uint64_t low = (static_cast<uint64_t>(subBuckets) + bucket % subBuckets) << shift;
+    return low + ((uint64_t(1) << shift) - 1) * 0.5;
+}
+
+struct Stage {
+    string name;
+    uint64_t count = 0;
+    uint64_t totalNs = 0;
+    uint64_t maxNs = 0;
+    uint64_t lastNs = 0;
+    vector<uint64_t> histogram = vector<uint64_t>(bucketCount, 0);
+
+    double percentileMs(double q) const {
+        uint64_t target = static_cast<uint64_t>(q * (count - 1)) + 1;
+        uint64_t seen = 0;
+        for (int bucket = 0; bucket < bucketCount; bucket++) {
+            seen += histogram[bucket];
+            if (seen >= target) {
+                return min(bucketValue(bucket), double(maxNs)) / 1e6;
+            }
+        }
+        return maxNs / 1e6;
+    }
+};
+
+struct Event {
+    const char *name;
+    int thread;
+    int64_t startUs;
+    int64_t durationUs;
+};
+
+//* |------------| | Estado global | |------------|
+
+atomic<bool> enabled{Trace::compiledIn};
+mutex stateMutex;
+vector<Stage> stages;
+unordered_map<const char *, size_t> stageByName; // Mismo literal → mismo puntero casi siempre
+deque<Event> events;
+const Clock::time_point origin = Clock::now();
+
+// Número corto y estable por hilo para la traza
+int currentThread() {
+    static atomic<int> nextThread{1};
+    thread_local int thread = nextThread++;
+    return thread;
+}
+
+// Llamar con stateMutex tomado
+Stage &stageFor(const char *name) {
+    auto found = stageByName.find(name);
+    if (found != stageByName.end()) {
+        return stages[found->second];
+    }
+
+    // Otro puntero con el mismo texto (literal repetido en otra unidad de compilación)
+    size_t index = 0;
+    while (index < stages.size() && stages[index].name != name) {
+        index++;
+    }
+    if (index == stages.size()) {
+        stages.emplace_back();
+        stages.back().name = name;
+    }
+    stageByName[name] = index;
+    return stages[index];
+}
+
+// Llamar con stateMutex tomado
+Trace::StageStats statsOf(const Stage &stage) {
+    Trace::StageStats stats;
+    stats.name = stage.name;
+    stats.count = stage.count;
+    stats.totalMs = stage.totalNs / 1e6;
+    stats.meanMs = stats.totalMs / stage.count;
+    stats.p50Ms = stage.percentileMs(0.50);
+    stats.p95Ms = stage.percentileMs(0.95);
+    stats.p99Ms = stage.percentileMs(0.99);
+    stats.maxMs = stage.maxNs / 1e6;
+    stats.lastMs = stage.lastNs / 1e6;
+    return stats;
+}
+
+string jsonEscape(const string &text) {
+    string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+} // namespace
+
+namespace Trace {
+
+/**
+ * @brief Enciende o apaga las medidas en ejecución (sin ENABLE_TRACE no hay nada que medir)
+ */
+void setEnabled(bool value) {
+    enabled = value && compiledIn;
+}
+
+bool isEnabled() {
+    return enabled.load(memory_order_relaxed);
+}
+
+/**
+ * @brief Descarta todas las medidas y eventos
+ */
+void reset() {
+    lock_guard<mutex> lock(stateMutex);
+    stages.clear();
+    stageByName.clear();
+    events.clear();
+}
+
+/**
+ * @brief Registra una medida (normalmente desde ScopedTimer)
+ * @param name Etapa; debe ser un literal (se guarda el puntero)
+ */
+void record(const char *name, Clock::time_point start, Clock::time_point end) {
+    uint64_t ns = static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(end - start).count());
+    Event event{name, currentThread(), chrono::duration_cast<chrono::microseconds>(start - origin).count(),
+                static_cast<int64_t>(ns / 1000)};
+
+    lock_guard<mutex> lock(stateMutex);
+    Stage &stage = stageFor(name);
+    stage.count++;
+    stage.totalNs += ns;
+    stage.maxNs = max(stage.maxNs, ns);
+    stage.lastNs = ns;
+    stage.histogram[bucketOf(ns)]++;
+
+    events.push_back(event);
+    if (events.size() > maxEvents) {
+        events.pop_front();
+    }
+}
+
+/**
+ * @brief Estadísticos de cada etapa medida, de la que más tiempo acumula a la que menos
+ */
+vector<StageStats> summary() {
+    lock_guard<mutex> lock(stateMutex);
+    vector<StageStats> result;
+    for (const Stage &stage : stages) {
+        if (stage.count > 0) {
+            result.push_back(statsOf(stage));
+        }
+    }
+    sort(result.begin(), result.end(), [](const StageStats &a, const StageStats &b) { return a.totalMs > b.totalMs; });
+    return result;
+}
+
+/**
+ * @brief Estadísticos de una sola etapa (p. ej. para la barra de estado)
+ * @return false si la etapa no se midió todavía
+ */
+bool stageSummary(const string &name, StageStats &stats) {
+    lock_guard<mutex> lock(stateMutex);
+    for (const Stage &stage : stages) {
+        if (stage.name == name && stage.count > 0) {
+            stats = statsOf(stage);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Tabla de texto con los estadísticos de summary() (para un diálogo o la consola)
+ */
+string summaryText() {
+    vector<StageStats> stats = summary();
+    if (stats.empty()) {
+        return compiledIn ? "Sin medidas todavía.\n" : "Compilado sin trazas (make TRACE=1).\n";
+    }
+
+    ostringstream text;
+    char line[256];
+    snprintf(line, sizeof(line), "%-32s %8s %10s %9s %9s %9s %9s\n", "Etapa", "N", "Total ms", "p50 ms", "p95 ms",
+             "p99 ms", "Max ms");
+    text << line;
+    for (const StageStats &stage : stats) {
+        snprintf(line, sizeof(line), "%-32s %8llu %10.1f %9.3f %9.3f %9.3f %9.3f\n", stage.name.c_str(),
+                 static_cast<unsigned long long>(stage.count), stage.totalMs, stage.p50Ms, stage.p95Ms, stage.p99Ms,
+                 stage.maxMs);
+        text << line;
+    }
+    return text.str();
+}
+
+/**
+ * @brief Escribe los últimos eventos en formato Chrome trace (chrome://tracing o Perfetto)
+ * @return false si no se pudo escribir el archivo
+ */
+bool writeChromeTrace(const string &path) {
+    ofstream file(path);
+    if (!file) {
+        return false;
+    }
+
+    lock_guard<mutex> lock(stateMutex);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const Event &event : events) {
+        file << (first ? "\n" : ",\n") << "{\"name\":\"" << jsonEscape(event.name) << "\",\"cat\":\"stage\",\"ph\":\"X\""
+             << ",\"ts\":" << event.startUs << ",\"dur\":" << event.durationUs << ",\"pid\":1,\"tid\":" << event.thread
+             << "}";
+        first = false;
+    }
+    file << "\n]}\n";
+    return static_cast<bool>(file);
+}
+
+} // namespace Trace
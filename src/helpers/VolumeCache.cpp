@@ -0,0 +1,298 @@
+#include "helpers/VolumeCache.h"
+
+#include <itkImportImageFilter.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace VolumeCache {
+
+namespace {
+
+constexpr char cacheMagic[8] = {'V', 'O', 'L', 'C', 'A', 'C', 'H', 'E'};
+constexpr uint32_t cacheVersion = 2; // 2: vóxeles en su tipo nativo (antes siempre float)
+constexpr uint64_t dataOffset = 4096; // Los vóxeles empiezan en su propia página
+constexpr uint64_t maxDimension = 1 << 16;
+
+/**
+ * @brief Cabecera del archivo de caché (little-endian, igual que los vóxeles)
+ */
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t voxelBytes;
+    uint32_t voxelType; // VoxelType
+    uint32_t reserved;
+    uint64_t dataOffset;
+    uint64_t sourceSize;  // Tamaño del .nii.gz original
+    int64_t sourceMtime;  // Fecha de modificación del original
+    uint64_t size[3];
+    double spacing[3];
+    double origin[3];
+    double direction[9]; // Fila a fila
+};
+static_assert(sizeof(CacheHeader) <= dataOffset, "La cabecera debe caber antes de los vóxeles");
+
+mutex directoryMutex;
+string cacheDirectory = [] {
+    const char *fromEnvironment = getenv("VOLUME_CACHE_DIR");
+    return string((fromEnvironment && *fromEnvironment) ? fromEnvironment : "cache/volumes");
+}();
+atomic<bool> cacheEnabled{true};
+atomic<unsigned> tempCounter{0};
+
+bool isLittleEndian() {
+    const uint16_t probe = 1;
+    return *reinterpret_cast<const uint8_t *>(&probe) == 1;
+}
+
+// Tamaño y fecha del original: si cambian, la entrada deja de ser válida
+bool sourceStamp(const string &sourcePath, uint64_t &size, int64_t &mtime) {
+    error_code error;
+    size = fs::file_size(sourcePath, error);
+    if (error) {
+        return false;
+    }
+    auto writeTime = fs::last_write_time(sourcePath, error);
+    if (error) {
+        return false;
+    }
+    mtime = static_cast<int64_t>(writeTime.time_since_epoch().count());
+    return true;
+}
+
+// <carpeta>/<nombre sin extensión>_<hash de la ruta absoluta>.vol
+string entryPath(const string &sourcePath) {
+    error_code error;
+    fs::path absolutePath = fs::absolute(sourcePath, error);
+    string key = error ? sourcePath : absolutePath.lexically_normal().string();
+
+    string name = fs::path(sourcePath).filename().string();
+    for (const string extension : {".nii.gz", ".nii"}) {
+        if (name.size() > extension.size() && name.compare(name.size() - extension.size(), extension.size(), extension) == 0) {
+            name.erase(name.size() - extension.size());
+            break;
+        }
+    }
+
+    char hash[17];
+    snprintf(hash, sizeof(hash), "%016zx", std::hash<string>{}(key));
+    return (fs::path(directory()) / (name + "_" + hash + ".vol")).string();
+}
+
+// Envuelve la memoria mapeada en un itk::Image del tipo de la entrada, sin copiar
+template <typename Pixel> VolumeImage importVoxels(const CacheHeader &header, void *voxelData, uint64_t voxels) {
+    using ImportFilterType = itk::ImportImageFilter<Pixel, 3>;
+    typename ImportFilterType::Pointer importer = ImportFilterType::New();
+
+    typename ImportFilterType::SizeType size;
+    typename ImportFilterType::IndexType start;
+    typename ImportFilterType::SpacingType spacing;
+    typename ImportFilterType::OriginType origin;
+    typename ImportFilterType::DirectionType direction;
+    start.Fill(0);
+    for (int axis = 0; axis < 3; axis++) {
+        size[axis] = header.size[axis];
+        spacing[axis] = header.spacing[axis];
+        origin[axis] = header.origin[axis];
+        for (int column = 0; column < 3; column++) {
+            direction[axis][column] = header.direction[3 * axis + column];
+        }
+    }
+
+    typename ImportFilterType::RegionType region;
+    region.SetIndex(start);
+    region.SetSize(size);
+
+    importer->SetRegion(region);
+    importer->SetSpacing(spacing);
+    importer->SetOrigin(origin);
+    importer->SetDirection(direction);
+
+    // La memoria es del mmap: ITK no debe liberarla
+    importer->SetImportPointer(static_cast<Pixel *>(voxelData), voxels, /*LetImportFilterManageMemory=*/false);
+    importer->Update();
+
+    typename itk::Image<Pixel, 3>::Pointer image = importer->GetOutput();
+    image->DisconnectPipeline();
+    return VolumeImage(image);
+}
+
+} // namespace
+
+bool load(const string &sourcePath, VolumeImage &image, shared_ptr<const void> &mapping) {
+    if (!isEnabled() || !isLittleEndian()) {
+        return false;
+    }
+
+    uint64_t sourceSize = 0;
+    int64_t sourceMtime = 0;
+    if (!sourceStamp(sourcePath, sourceSize, sourceMtime)) {
+        return false;
+    }
+
+    string path = entryPath(sourcePath);
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<uint64_t>(info.st_size) < dataOffset) {
+        close(fd);
+        return false;
+    }
+
+    // MAP_PRIVATE: si algo escribe en el buffer ITK se copia solo esa página, el archivo no cambia
+    size_t length = static_cast<size_t>(info.st_size);
+    void *address = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED) {
+        cerr << "VolumeCache::load: no se pudo mapear " << path << ": " << strerror(errno) << "\n";
+        return false;
+    }
+    shared_ptr<const void> mapped(address, [length](const void *pointer) { munmap(const_cast<void *>(pointer), length); });
+
+    CacheHeader header;
+    memcpy(&header, address, sizeof(header));
+
+    VoxelType voxelType = static_cast<VoxelType>(header.voxelType);
+    bool valid = memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) == 0 && header.version == cacheVersion &&
+                 header.voxelType <= static_cast<uint32_t>(VoxelType::Float32) &&
+                 header.voxelBytes == voxelBytes(voxelType) && header.dataOffset == dataOffset &&
+                 header.sourceSize == sourceSize && header.sourceMtime == sourceMtime;
+    for (int axis = 0; valid && axis < 3; axis++) {
+        valid = header.size[axis] > 0 && header.size[axis] <= maxDimension;
+    }
+
+    uint64_t voxels = valid ? header.size[0] * header.size[1] * header.size[2] : 0;
+    if (!valid || length != dataOffset + voxels * header.voxelBytes) {
+        return false;
+    }
+
+    // El slice cache recorre el volumen entero justo después: pedir la lectura por adelantado
+    madvise(address, length, MADV_WILLNEED);
+
+    void *voxelData = static_cast<char *>(address) + dataOffset;
+    switch (voxelType) {
+    case VoxelType::UInt8:
+        image = importVoxels<uint8_t>(header, voxelData, voxels);
+        break;
+    case VoxelType::Int16:
+        image = importVoxels<int16_t>(header, voxelData, voxels);
+        break;
+    case VoxelType::UInt16:
+        image = importVoxels<uint16_t>(header, voxelData, voxels);
+        break;
+    case VoxelType::Float32:
+        image = importVoxels<float>(header, voxelData, voxels);
+        break;
+    }
+    mapping = mapped;
+    return true;
+}
+
+bool store(const string &sourcePath, const VolumeImage &image) {
+    if (!isEnabled() || !isLittleEndian() || !image) {
+        return false;
+    }
+
+    CacheHeader header{};
+    memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+    header.version = cacheVersion;
+    header.voxelBytes = static_cast<uint32_t>(voxelBytes(image.type()));
+    header.voxelType = static_cast<uint32_t>(image.type());
+    header.dataOffset = dataOffset;
+    if (!sourceStamp(sourcePath, header.sourceSize, header.sourceMtime)) {
+        return false;
+    }
+
+    const itk::ImageBase<3> *itkImage = image.itkImage();
+    auto size3D = itkImage->GetBufferedRegion().GetSize();
+    auto spacing = itkImage->GetSpacing();
+    auto origin = itkImage->GetOrigin();
+    auto direction = itkImage->GetDirection();
+    for (int axis = 0; axis < 3; axis++) {
+        header.size[axis] = size3D[axis];
+        header.spacing[axis] = spacing[axis];
+        header.origin[axis] = origin[axis];
+        for (int column = 0; column < 3; column++) {
+            header.direction[3 * axis + column] = direction[axis][column];
+        }
+    }
+    uint64_t voxels = header.size[0] * header.size[1] * header.size[2];
+    if (voxels == 0) {
+        return false;
+    }
+
+    string path = entryPath(sourcePath);
+    error_code error;
+    fs::create_directories(fs::path(path).parent_path(), error);
+    if (error) {
+        cerr << "VolumeCache::store: no se pudo crear " << fs::path(path).parent_path() << ": " << error.message() << "\n";
+        return false;
+    }
+
+    // Temporal + rename: otro proceso nunca ve un archivo a medio escribir
+    string tempPath = path + ".tmp" + to_string(getpid()) + "_" + to_string(tempCounter++);
+    {
+        ofstream file(tempPath, ios::binary | ios::trunc);
+        vector<char> headerBlock(dataOffset, 0);
+        memcpy(headerBlock.data(), &header, sizeof(header));
+        file.write(headerBlock.data(), headerBlock.size());
+        file.write(static_cast<const char *>(image.data()), voxels * header.voxelBytes);
+
+        if (!file) {
+            cerr << "VolumeCache::store: error al escribir " << tempPath << "\n";
+            file.close();
+            fs::remove(tempPath, error);
+            return false;
+        }
+    }
+
+    fs::rename(tempPath, path, error);
+    if (error) {
+        cerr << "VolumeCache::store: no se pudo renombrar a " << path << ": " << error.message() << "\n";
+        fs::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
+
+void setDirectory(const string &directory) {
+    lock_guard<mutex> lock(directoryMutex);
+    cacheDirectory = directory;
+}
+
+string directory() {
+    lock_guard<mutex> lock(directoryMutex);
+    return cacheDirectory;
+}
+
+void setEnabled(bool enabled) {
+    cacheEnabled = enabled;
+}
+
+bool isEnabled() {
+    return cacheEnabled;
+}
+
+} // namespace VolumeCache
@@ -0,0 +1,362 @@
+#include "helpers/VolumeFilters.h"
+#include "helpers/SlabParallel.h"
+#include "helpers/Trace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace std;
+
+namespace VolumeFilters {
+
+namespace {
+
+// Índice reflejado sin repetir el borde: ... 2 1 | 0 1 2 ... n-1 | n-2 n-3 ...
+inline int reflect101(int index, int size) {
+    if (size == 1) {
+        return 0;
+    }
+    while (index < 0 || index >= size) {
+        index = (index < 0) ? -index : 2 * size - 2 - index;
+    }
+    return index;
+}
+
+// Reductores de una pasada 1D: combinan el valor del tap k con lo acumulado
+struct WeightedSum {
+    const float *weights;
+    float first(float value, int tap) const { return weights[tap] * value; }
+    float next(float accumulated, float value, int tap) const { return accumulated + weights[tap] * value; }
+};
+
+struct Minimum {
+    float first(float value, int) const { return value; }
+    float next(float accumulated, float value, int) const { return min(accumulated, value); }
+};
+
+struct Maximum {
+    float first(float value, int) const { return value; }
+    float next(float accumulated, float value, int) const { return max(accumulated, value); }
+};
+
+/**
+ * @brief out[i] = reduce_k(rows[k][i]): una fila de salida a partir de las filas de cada tap
+ * @details El tap va por fuera y el índice por dentro: cada pasada lee una fila contigua
+ * y la fila de salida se queda en L1 mientras se acumulan todos los taps
+ */
+template <typename Reducer>
+void combineRows(float *out, const float *const *rows, int taps, int count, const Reducer &reducer) {
+    const float *row = rows[0];
+    for (int i = 0; i < count; i++) {
+        out[i] = reducer.first(row[i], 0);
+    }
+    for (int tap = 1; tap < taps; tap++) {
+        row = rows[tap];
+        for (int i = 0; i < count; i++) {
+            out[i] = reducer.next(out[i], row[i], tap);
+        }
+    }
+}
+
+/**
+ * @brief Pasada 1D a lo largo de un eje (0 = X, 1 = Y, 2 = Z) con radio radius
+ * @details En X la fila se copia primero con sus bordes reflejados (por eso src puede ser
+ * dst); en Y y Z los taps son filas enteras de otras filas u otros slices
+ */
+template <typename Reducer>
+void separablePass(int axis, const float *src, float *dst, Dimensions dims, int radius, const Reducer &reducer,
+                   size_t threads) {
+    const int taps = 2 * radius + 1;
+    const size_t sliceSize = dims.sliceSize();
+
+    forEachSlab<int>(dims.depth, threads, [&](int zBegin, int zEnd) {
+        vector<const float *> rows(taps);
+        vector<float> padded(axis == 0 ? dims.width + 2 * radius : 0);
+
+        for (int z = zBegin; z < zEnd; z++) {
+            for (int y = 0; y < dims.height; y++) {
+                size_t offset = sliceSize * z + static_cast<size_t>(y) * dims.width;
+
+                for (int tap = 0; tap < taps; tap++) {
+                    if (axis == 0) {
+                        rows[tap] = padded.data() + tap;
+                    } else if (axis == 1) {
+                        rows[tap] = src + sliceSize * z + static_cast<size_t>(reflect101(y + tap - radius, dims.height)) * dims.width;
+                    } else {
+                        rows[tap] = src + sliceSize * reflect101(z + tap - radius, dims.depth) + static_cast<size_t>(y) * dims.width;
+                    }
+                }
+                if (axis == 0) {
+                    for (int i = 0; i < static_cast<int>(padded.size()); i++) {
+                        padded[i] = src[offset + reflect101(i - radius, dims.width)];
+                    }
+                }
+
+                combineRows(dst + offset, rows.data(), taps, dims.width, reducer);
+            }
+        }
+        return 0;
+    });
+}
+
+/**
+ * @brief Las tres pasadas X, Y, Z: src → dst → scratch → dst
+ */
+template <typename Reducer>
+void separable3D(const float *src, float *dst, float *scratch, Dimensions dims, int radius, const Reducer &reducer,
+                 size_t threads) {
+    separablePass(0, src, dst, dims, radius, reducer, threads);
+    separablePass(1, dst, scratch, dims, radius, reducer, threads);
+    separablePass(2, scratch, dst, dims, radius, reducer, threads);
+}
+
+// Igual que cv::getGaussianKernel: si sigma <= 0 se deriva del tamaño del kernel
+vector<float> gaussianKernel(int kernelSize, double sigma) {
+    if (sigma <= 0.0) {
+        sigma = 0.3 * ((kernelSize - 1) * 0.5 - 1.0) + 0.8;
+    }
+
+    vector<float> weights(kernelSize);
+    int radius = kernelSize / 2;
+    double sum = 0.0;
+    for (int tap = 0; tap < kernelSize; tap++) {
+        double x = tap - radius;
+        weights[tap] = static_cast<float>(exp(-(x * x) / (2.0 * sigma * sigma)));
+        sum += weights[tap];
+    }
+    for (float &weight : weights) {
+        weight = static_cast<float>(weight / sum);
+    }
+    return weights;
+}
+
+/**
+ * @brief Mediana sobre el cubo (2 * radius + 1)³ de cada vóxel
+ * @details Para cada fila se ordena una vez cada "columna" (los taps² vóxeles de una misma
+ * X en las filas y slices vecinos); la ventana de un vóxel son taps columnas consecutivas ya
+ * ordenadas, y la mediana sale de mezclarlas hasta la posición central. Cada columna se
+ * reutiliza en taps ventanas en lugar de volver a ordenar taps³ valores por vóxel
+ */
+void median3D(const float *src, float *dst, Dimensions dims, int radius, size_t threads) {
+    const int taps = 2 * radius + 1;
+    const int columnSize = taps * taps;
+    const int medianRank = taps * columnSize / 2;
+    const size_t sliceSize = dims.sliceSize();
+
+    forEachSlab<int>(dims.depth, threads, [&](int zBegin, int zEnd) {
+        const int paddedWidth = dims.width + 2 * radius;
+        vector<float> columns(static_cast<size_t>(paddedWidth) * columnSize);
+        vector<const float *> rows(columnSize);
+        vector<int> heads(taps);
+
+        for (int z = zBegin; z < zEnd; z++) {
+            for (int y = 0; y < dims.height; y++) {
+                // Filas que forman las columnas de esta fila de salida
+                for (int tz = 0; tz < taps; tz++) {
+                    const float *slice = src + sliceSize * reflect101(z + tz - radius, dims.depth);
+                    for (int ty = 0; ty < taps; ty++) {
+                        rows[tz * taps + ty] = slice + static_cast<size_t>(reflect101(y + ty - radius, dims.height)) * dims.width;
+                    }
+                }
+
+                for (int px = 0; px < paddedWidth; px++) {
+                    int x = reflect101(px - radius, dims.width);
+                    float *column = &columns[static_cast<size_t>(px) * columnSize];
+                    for (int i = 0; i < columnSize; i++) {
+                        column[i] = rows[i][x];
+                    }
+                    sort(column, column + columnSize);
+                }
+
+                float *out = dst + sliceSize * z + static_cast<size_t>(y) * dims.width;
+                for (int x = 0; x < dims.width; x++) {
+                    const float *window = &columns[static_cast<size_t>(x) * columnSize];
+
+                    // Ventana constante (el fondo, casi todo el volumen): no hace falta mezclar
+                    float lowest = window[0];
+                    float highest = window[columnSize - 1];
+                    for (int list = 1; list < taps; list++) {
+                        lowest = min(lowest, window[list * columnSize]);
+                        highest = max(highest, window[list * columnSize + columnSize - 1]);
+                    }
+                    if (lowest == highest) {
+                        out[x] = lowest;
+                        continue;
+                    }
+
+                    fill(heads.begin(), heads.end(), 0);
+
+                    float value = 0.0f;
+                    for (int rank = 0; rank <= medianRank; rank++) {
+                        int best = -1;
+                        for (int list = 0; list < taps; list++) {
+                            if (heads[list] < columnSize &&
+                                (best < 0 || window[list * columnSize + heads[list]] < window[best * columnSize + heads[best]])) {
+                                best = list;
+                            }
+                        }
+                        value = window[best * columnSize + heads[best]++];
+                    }
+                    out[x] = value;
+                }
+            }
+        }
+        return 0;
+    });
+}
+
+// Tamaño impar y >= minimum, como en los efectos 2D
+int oddKernel(int kernelSize, int minimum) {
+    kernelSize = max(kernelSize, minimum);
+    return (kernelSize % 2 == 0) ? kernelSize + 1 : kernelSize;
+}
+
+// Alcance del filtro en vóxeles: el halo que necesita un brick para filtrarse solo
+int haloOf(EffectId id, const EffectParams &params) {
+    switch (id) {
+    case EffectId::MedianFilter:
+        return oddKernel(params.smoothKernelSize, 3) / 2;
+    case EffectId::Opening:
+    case EffectId::Closing:
+        return 2 * (oddKernel(params.morphKernelSize, 1) / 2); // Dos pasadas encadenadas
+    case EffectId::Erosion:
+    case EffectId::Dilation:
+        return oddKernel(params.morphKernelSize, 1) / 2;
+    default:
+        return oddKernel(params.smoothKernelSize, 1) / 2;
+    }
+}
+
+} // namespace
+
+bool supports(EffectId id) {
+    switch (id) {
+    case EffectId::MeanFilter:
+    case EffectId::GaussianFilter:
+    case EffectId::MedianFilter:
+    case EffectId::Erosion:
+    case EffectId::Dilation:
+    case EffectId::Opening:
+    case EffectId::Closing:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool filter(EffectId id, const float *src, float *dst, Dimensions dims, const EffectParams &params, size_t threads) {
+    if (!supports(id)) {
+        return false;
+    }
+    if (dims.voxels() == 0) {
+        return true;
+    }
+
+    vector<float> scratch(id == EffectId::MedianFilter ? 0 : dims.voxels());
+
+    switch (id) {
+    case EffectId::MeanFilter: {
+        int kernelSize = oddKernel(params.smoothKernelSize, 1);
+        vector<float> weights(kernelSize, 1.0f / kernelSize);
+        separable3D(src, dst, scratch.data(), dims, kernelSize / 2, WeightedSum{weights.data()}, threads);
+        break;
+    }
+    case EffectId::GaussianFilter: {
+        int kernelSize = oddKernel(params.smoothKernelSize, 1);
+        vector<float> weights = gaussianKernel(kernelSize, params.gaussianSigma);
+        separable3D(src, dst, scratch.data(), dims, kernelSize / 2, WeightedSum{weights.data()}, threads);
+        break;
+    }
+    case EffectId::MedianFilter:
+        median3D(src, dst, dims, oddKernel(params.smoothKernelSize, 3) / 2, threads);
+        break;
+    case EffectId::Erosion:
+        separable3D(src, dst, scratch.data(), dims, oddKernel(params.morphKernelSize, 1) / 2, Minimum{}, threads);
+        break;
+    case EffectId::Dilation:
+        separable3D(src, dst, scratch.data(), dims, oddKernel(params.morphKernelSize, 1) / 2, Maximum{}, threads);
+        break;
+    case EffectId::Opening: {
+        int radius = oddKernel(params.morphKernelSize, 1) / 2;
+        separable3D(src, dst, scratch.data(), dims, radius, Minimum{}, threads);
+        separable3D(dst, dst, scratch.data(), dims, radius, Maximum{}, threads);
+        break;
+    }
+    case EffectId::Closing: {
+        int radius = oddKernel(params.morphKernelSize, 1) / 2;
+        separable3D(src, dst, scratch.data(), dims, radius, Maximum{}, threads);
+        separable3D(dst, dst, scratch.data(), dims, radius, Minimum{}, threads);
+        break;
+    }
+    default:
+        return false;
+    }
+    return true;
+}
+
+VolumetricImagePointer apply(EffectId id, const VolumeImage &image, const EffectParams &params, size_t threads) {
+    if (!image || !supports(id)) {
+        return nullptr;
+    }
+
+    Dimensions dims{image.width(), image.height(), image.depth()};
+    VolumetricImagePointer input = image.toFloat(); // El mismo volumen si ya es float
+
+    // Mismo origen, spacing y dirección que el original; buffer propio
+    VolumetricImagePointer filtered = VolumetricImageType::New();
+    filtered->CopyInformation(input);
+    filtered->SetRegions(input->GetBufferedRegion());
+    filtered->Allocate();
+
+    if (!filter(id, input->GetBufferPointer(), filtered->GetBufferPointer(), dims, params, threads)) {
+        return nullptr;
+    }
+    return filtered;
+}
+
+VolumetricImagePointer apply(EffectId id, const BrickedVolume &volume, const EffectParams &params, size_t threads) {
+    TRACE_SCOPE("VolumeFilters::apply/bricked");
+    if (!volume || !supports(id)) {
+        return nullptr;
+    }
+
+    VolumetricImagePointer filtered = VolumetricImageType::New();
+    filtered->CopyInformation(volume.geometry());
+    filtered->SetRegions(volume.geometry()->GetLargestPossibleRegion());
+    filtered->Allocate();
+
+    float *out = filtered->GetBufferPointer();
+    const int halo = haloOf(id, params);
+    const size_t rowSize = volume.width();
+    const size_t sliceSize = rowSize * volume.height();
+
+    // Cada brick escribe solo sus vóxeles del resultado; los bloques se reutilizan entre bricks
+    forEachSlab<int>(volume.brickCount(), threads, [&](int first, int last) {
+        vector<float> block;
+        vector<float> result;
+        for (int index = first; index < last; index++) {
+            BrickedVolume::Brick brick = volume.brick(index);
+            Dimensions dims{brick.size[0] + 2 * halo, brick.size[1] + 2 * halo, brick.size[2] + 2 * halo};
+            block.resize(dims.voxels());
+            result.resize(dims.voxels());
+            volume.gather(brick.origin - cv::Vec3i(halo, halo, halo), cv::Vec3i(dims.width, dims.height, dims.depth),
+                          block.data());
+            filter(id, block.data(), result.data(), dims, params, 1);
+
+            for (int z = 0; z < brick.size[2]; z++) {
+                for (int y = 0; y < brick.size[1]; y++) {
+                    const size_t row = (static_cast<size_t>(z + halo) * dims.height + y + halo) * dims.width;
+                    const float *src = &result[row + halo];
+                    float *dst = out + sliceSize * (brick.origin[2] + z) + rowSize * (brick.origin[1] + y) +
+                                 brick.origin[0];
+                    copy(src, src + brick.size[0], dst);
+                }
+            }
+        }
+        return 0;
+    });
+    return filtered;
+}
+
+} // namespace VolumeFilters
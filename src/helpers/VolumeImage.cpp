@@ -0,0 +1,96 @@
+#include "helpers/VolumeImage.h"
+
+#include <algorithm>
+
+using namespace std;
+
+size_t voxelBytes(VoxelType type) {
+    switch (type) {
+    case VoxelType::UInt8:
+        return 1;
+    case VoxelType::Int16:
+    case VoxelType::UInt16:
+        return 2;
+    case VoxelType::Float32:
+        break;
+    }
+    return 4;
+}
+
+const char *voxelTypeName(VoxelType type) {
+    switch (type) {
+    case VoxelType::UInt8:
+        return "uint8";
+    case VoxelType::Int16:
+        return "int16";
+    case VoxelType::UInt16:
+        return "uint16";
+    case VoxelType::Float32:
+        break;
+    }
+    return "float32";
+}
+
+/**
+ * @brief Profundidad OpenCV del tipo de vóxel (CV_8U, CV_16S, CV_16U o CV_32F)
+ */
+int VolumeImage::cvDepth() const {
+    switch (voxelType) {
+    case VoxelType::UInt8:
+        return CV_8U;
+    case VoxelType::Int16:
+        return CV_16S;
+    case VoxelType::UInt16:
+        return CV_16U;
+    case VoxelType::Float32:
+        break;
+    }
+    return CV_32F;
+}
+
+/**
+ * @brief Copia float del volumen, con la misma geometría, para los kernels que la necesitan
+ * @details Si el volumen ya es float se devuelve el mismo (sin copiar): no escribir en él
+ * @return nullptr si el volumen está vacío
+ */
+VolumetricImagePointer VolumeImage::toFloat() const {
+    if (!pixels) {
+        return nullptr;
+    }
+
+    if (voxelType == VoxelType::Float32) {
+        const VolumetricImageType *floatImage = static_cast<const VolumetricImageType *>(image.GetPointer());
+        return const_cast<VolumetricImageType *>(floatImage);
+    }
+
+    VolumetricImagePointer promoted = VolumetricImageType::New();
+    promoted->CopyInformation(image.GetPointer());
+    promoted->SetRegions(image->GetBufferedRegion());
+    promoted->Allocate();
+    float *dst = promoted->GetBufferPointer();
+    visit([&](const auto *src) { copy(src, src + voxelCount(), dst); });
+    return promoted;
+}
+
+/**
+ * @brief Máscara de etiquetas uint8 (redondeo y saturación a [0, 255]; NaN = fondo)
+ * @details Si ya es uint8 se devuelve la misma
+ */
+VolumeImage VolumeImage::toLabels() const {
+    if (!pixels || voxelType == VoxelType::UInt8) {
+        return *this;
+    }
+
+    LabelImagePointer labels = LabelImageType::New();
+    labels->CopyInformation(image.GetPointer());
+    labels->SetRegions(image->GetBufferedRegion());
+    labels->Allocate();
+    uint8_t *dst = labels->GetBufferPointer();
+    visit([&](const auto *src) {
+        for (size_t i = 0; i < voxelCount(); i++) {
+            double value = src[i];
+            dst[i] = !(value > 0.5) ? 0 : (value >= 255.0 ? 255 : static_cast<uint8_t>(value + 0.5));
+        }
+    });
+    return VolumeImage(labels);
+}
@@ -0,0 +1,434 @@
+#include "helpers/VolumeStatistics.h"
+#include "helpers/SegmentationLabels.h"
+#include "helpers/SlabParallel.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+
+using namespace std;
+
+namespace VolumeStatistics {
+
+namespace {
+
+/**
+ * @brief Acumulador de una etiqueta: conteo, momentos centrales, histograma, caja envolvente
+ * y área en cada slice
+ * @details Los momentos se actualizan de forma incremental y se fusionan entre bloques con
+ * las fórmulas de Pébay, así no se pierde precisión sumando potencias de floats grandes
+ */
+struct LabelAccumulator {
+    uint64_t count = 0;
+    double mean = 0.0;
+    double m2 = 0.0;
+    double m3 = 0.0;
+    double m4 = 0.0;
+    float minimum = FLT_MAX;
+    float maximum = -FLT_MAX;
+    array<uint64_t, 256> histogram{};
+    array<int, 3> boundsMin{INT_MAX, INT_MAX, INT_MAX};
+    array<int, 3> boundsMax{-1, -1, -1};
+    vector<uint32_t> sliceArea; // Vóxeles en cada slice Z (depth entradas)
+
+    void add(float value, int bin, int x, int y, int z) {
+        uint64_t previous = count++;
+        double n = static_cast<double>(count);
+        double delta = value - mean;
+        double deltaN = delta / n;
+        double deltaN2 = deltaN * deltaN;
+        double term = delta * deltaN * static_cast<double>(previous);
+
+        mean += deltaN;
+        m4 += term * deltaN2 * (n * n - 3.0 * n + 3.0) + 6.0 * deltaN2 * m2 - 4.0 * deltaN * m3;
+        m3 += term * deltaN * (n - 2.0) - 3.0 * deltaN * m2;
+        m2 += term;
+
+        minimum = min(minimum, value);
+        maximum = max(maximum, value);
+        histogram[bin]++;
+        sliceArea[z]++;
+
+        const int position[3] = {x, y, z};
+        for (int axis = 0; axis < 3; axis++) {
+            boundsMin[axis] = min(boundsMin[axis], position[axis]);
+            boundsMax[axis] = max(boundsMax[axis], position[axis]);
+        }
+    }
+
+    void merge(const LabelAccumulator &other) {
+        if (other.count == 0) {
+            return;
+        }
+        if (count == 0) {
+            *this = other;
+            return;
+        }
+
+        double na = static_cast<double>(count);
+        double nb = static_cast<double>(other.count);
+        double n = na + nb;
+        double delta = other.mean - mean;
+        double delta2 = delta * delta;
+
+        double mergedM4 = m4 + other.m4 + delta2 * delta2 * na * nb * (na * na - na * nb + nb * nb) / (n * n * n) +
+                          6.0 * delta2 * (na * na * other.m2 + nb * nb * m2) / (n * n) +
+                          4.0 * delta * (na * other.m3 - nb * m3) / n;
+        double mergedM3 = m3 + other.m3 + delta2 * delta * na * nb * (na - nb) / (n * n) + 3.0 * delta * (na * other.m2 - nb * m2) / n;
+        m2 += other.m2 + delta2 * na * nb / n;
+        m3 = mergedM3;
+        m4 = mergedM4;
+        mean += delta * nb / n;
+        count += other.count;
+
+        minimum = min(minimum, other.minimum);
+        maximum = max(maximum, other.maximum);
+        for (int bin = 0; bin < 256; bin++) {
+            histogram[bin] += other.histogram[bin];
+        }
+        sliceArea.resize(max(sliceArea.size(), other.sliceArea.size()), 0);
+        for (size_t z = 0; z < other.sliceArea.size(); z++) {
+            sliceArea[z] += other.sliceArea[z];
+        }
+        for (int axis = 0; axis < 3; axis++) {
+            boundsMin[axis] = min(boundsMin[axis], other.boundsMin[axis]);
+            boundsMax[axis] = max(boundsMax[axis], other.boundsMax[axis]);
+        }
+    }
+};
+
+/**
+ * @brief Acumuladores de un bloque (de slices o de bricks); solo se crean para las etiquetas
+ * que aparecen
+ */
+struct SlabAccumulator {
+    explicit SlabAccumulator(int depth) : depth(depth) {}
+
+    int depth;
+    array<LabelAccumulator *, 256> byLabel{};
+    vector<unique_ptr<LabelAccumulator>> storage;
+
+    LabelAccumulator &at(int label) {
+        if (!byLabel[label]) {
+            storage.push_back(make_unique<LabelAccumulator>());
+            storage.back()->sliceArea.assign(depth, 0);
+            byLabel[label] = storage.back().get();
+        }
+        return *byLabel[label];
+    }
+};
+
+void finalize(const LabelAccumulator &accumulator, double voxelVolumeMm3, LabelVolumeStats &stats) {
+    stats.voxels = accumulator.count;
+    stats.volumeMm3 = static_cast<double>(accumulator.count) * voxelVolumeMm3;
+    stats.histogram = accumulator.histogram;
+    if (accumulator.count == 0) {
+        return;
+    }
+
+    double n = static_cast<double>(accumulator.count);
+    stats.minimum = accumulator.minimum;
+    stats.maximum = accumulator.maximum;
+    stats.mean = accumulator.mean;
+    stats.stdDev = sqrt(accumulator.m2 / n);
+    if (accumulator.m2 > 0.0) {
+        stats.skewness = sqrt(n) * accumulator.m3 / pow(accumulator.m2, 1.5);
+        stats.kurtosis = n * accumulator.m4 / (accumulator.m2 * accumulator.m2) - 3.0;
+    }
+    stats.boundsMin = accumulator.boundsMin;
+    stats.boundsMax = accumulator.boundsMax;
+    for (size_t z = 0; z < accumulator.sliceArea.size(); z++) {
+        if (accumulator.sliceArea[z] > stats.largestSliceArea) {
+            stats.largestSliceArea = accumulator.sliceArea[z];
+            stats.largestSlice = static_cast<int>(z);
+        }
+    }
+}
+
+/**
+ * @brief Tamaño y spacing del volumen en stats
+ */
+void setGeometry(const itk::ImageBase<3> *geometry, int width, int height, int depth, VolumeStats &stats) {
+    auto spacing = geometry->GetSpacing();
+    stats.size = {static_cast<size_t>(width), static_cast<size_t>(height), static_cast<size_t>(depth)};
+    for (int axis = 0; axis < 3; axis++) {
+        stats.spacing[axis] = spacing[axis];
+    }
+    stats.voxelVolumeMm3 = spacing[0] * spacing[1] * spacing[2];
+}
+
+/**
+ * @brief Fusiona los acumuladores de todos los bloques y rellena las etiquetas y el tumor
+ */
+void mergeSlabs(const vector<shared_ptr<SlabAccumulator>> &slabs, int depth, VolumeStats &stats) {
+    vector<LabelAccumulator> merged(256);
+    LabelAccumulator tumor;
+    tumor.sliceArea.assign(depth, 0);
+    for (const shared_ptr<SlabAccumulator> &slab : slabs) {
+        for (int label = 1; label < 256; label++) {
+            if (slab->byLabel[label]) {
+                merged[label].merge(*slab->byLabel[label]);
+            }
+        }
+    }
+
+    for (int label = 1; label < 256; label++) {
+        if (merged[label].count == 0) {
+            continue;
+        }
+        tumor.merge(merged[label]);
+
+        LabelVolumeStats labelStats;
+        labelStats.label = label;
+        finalize(merged[label], stats.voxelVolumeMm3, labelStats);
+        stats.labels.push_back(labelStats);
+    }
+
+    finalize(tumor, stats.voxelVolumeMm3, stats.tumor);
+    stats.tumorAreaPerSlice.assign(tumor.sliceArea.begin(), tumor.sliceArea.end());
+}
+
+string formatNumber(double value, int decimals) {
+    char text[32];
+    snprintf(text, sizeof(text), "%.*f", decimals, value);
+    return text;
+}
+
+string csvRow(const string &caseName, const string &label, const string &name, const LabelVolumeStats &stats) {
+    string row = caseName + "," + label + "," + name + "," + to_string(stats.voxels) + "," + formatNumber(stats.volumeMm3, 3) +
+                 "," + formatNumber(stats.minimum, 4) + "," + formatNumber(stats.maximum, 4) + "," +
+                 formatNumber(stats.mean, 4) + "," + formatNumber(stats.stdDev, 4) + "," + formatNumber(stats.skewness, 4) +
+                 "," + formatNumber(stats.kurtosis, 4);
+    for (int axis = 0; axis < 3; axis++) {
+        row += "," + to_string(stats.boundsMin[axis]) + "," + to_string(stats.boundsMax[axis]);
+    }
+    return row + "," + to_string(stats.largestSlice) + "," + to_string(stats.largestSliceArea) + "\n";
+}
+
+string histogramRows(const string &caseName, const string &label, const LabelVolumeStats &stats, float lower, float binWidth) {
+    string rows;
+    for (int bin = 0; bin < 256; bin++) {
+        if (stats.histogram[bin] > 0) {
+            rows += caseName + "," + label + "," + to_string(bin) + "," + formatNumber(lower + bin * binWidth, 4) + "," +
+                    to_string(stats.histogram[bin]) + "\n";
+        }
+    }
+    return rows;
+}
+
+} // namespace
+
+bool compute(const VolumeImage &image, const VolumeImage &mask, VolumeStats &stats, size_t threads) {
+    if (!image || !mask) {
+        cerr << "VolumeStatistics::compute: volumen o máscara no cargados.\n";
+        return false;
+    }
+
+    if (image.width() != mask.width() || image.height() != mask.height() || image.depth() != mask.depth()) {
+        cerr << "VolumeStatistics::compute: el volumen y la máscara tienen tamaños distintos.\n";
+        return false;
+    }
+
+    const int width = image.width();
+    const int height = image.height();
+    const int depth = image.depth();
+    const size_t sliceVoxels = static_cast<size_t>(width) * height;
+    VolumeImage labelImage = mask.toLabels();
+    const uint8_t *labels = labelImage.buffer<uint8_t>();
+
+    stats = VolumeStats();
+    setGeometry(image.itkImage(), width, height, depth, stats);
+    if (sliceVoxels == 0 || depth == 0) {
+        return true;
+    }
+
+    // Las dos pasadas leen las intensidades en su tipo nativo (una instancia por tipo)
+    vector<shared_ptr<SlabAccumulator>> slabs;
+    image.visit([&](const auto *voxels) {
+        using Pixel = PixelOf<decltype(voxels)>;
+
+        // 1) Rango de intensidades de todo el volumen: fija los bins de los histogramas
+        using Range = pair<float, float>;
+        vector<Range> ranges = forEachSlab<Range>(depth, threads, [&](int zBegin, int zEnd) {
+            Range range(FLT_MAX, -FLT_MAX);
+            const Pixel *end = voxels + sliceVoxels * zEnd;
+            for (const Pixel *voxel = voxels + sliceVoxels * zBegin; voxel != end; ++voxel) {
+                range.first = min(range.first, static_cast<float>(*voxel));
+                range.second = max(range.second, static_cast<float>(*voxel));
+            }
+            return range;
+        });
+        stats.histogramMin = FLT_MAX;
+        stats.histogramMax = -FLT_MAX;
+        for (const Range &range : ranges) {
+            stats.histogramMin = min(stats.histogramMin, range.first);
+            stats.histogramMax = max(stats.histogramMax, range.second);
+        }
+        const float lower = stats.histogramMin;
+        const float binScale = (stats.histogramMax > lower) ? 256.0f / (stats.histogramMax - lower) : 0.0f;
+
+        // 2) Pasada principal: cada bloque acumula en lo suyo
+        slabs = forEachSlab<shared_ptr<SlabAccumulator>>(depth, threads, [&](int zBegin, int zEnd) {
+            auto slab = make_shared<SlabAccumulator>(depth);
+            for (int z = zBegin; z < zEnd; z++) {
+                for (int y = 0; y < height; y++) {
+                    size_t row = sliceVoxels * z + static_cast<size_t>(y) * width;
+                    for (int x = 0; x < width; x++) {
+                        int label = labels[row + x];
+                        if (label == 0) {
+                            continue;
+                        }
+                        float value = static_cast<float>(voxels[row + x]);
+                        int bin = min(255, static_cast<int>((value - lower) * binScale));
+                        slab->at(label).add(value, max(0, bin), x, y, z);
+                    }
+                }
+            }
+            return slab;
+        });
+    });
+
+    // 3) Fusionar los bloques
+    mergeSlabs(slabs, depth, stats);
+    return true;
+}
+
+bool compute(const BrickedVolume &image, const BrickedVolume &mask, VolumeStats &stats, size_t threads) {
+    if (!image || !mask) {
+        cerr << "VolumeStatistics::compute: volumen o máscara no cargados.\n";
+        return false;
+    }
+
+    if (image.width() != mask.width() || image.height() != mask.height() || image.depth() != mask.depth() ||
+        image.brickSize() != mask.brickSize() || mask.type() != VoxelType::UInt8) {
+        cerr << "VolumeStatistics::compute: el volumen y la máscara (uint8) deben tener el mismo tamaño y brick.\n";
+        return false;
+    }
+
+    const int depth = image.depth();
+    const uint8_t *labels = mask.buffer<uint8_t>();
+    stats = VolumeStats();
+    setGeometry(image.geometry(), image.width(), image.height(), depth, stats);
+
+    // Las mismas dos pasadas, repartiendo bricks: máscara y volumen comparten la misma rejilla
+    vector<shared_ptr<SlabAccumulator>> slabs;
+    image.visit([&](const auto *voxels) {
+        using Pixel = PixelOf<decltype(voxels)>;
+
+        // 1) Rango de intensidades (solo los vóxeles válidos de cada brick, no el relleno)
+        using Range = pair<float, float>;
+        vector<Range> ranges = forEachSlab<Range>(image.brickCount(), threads, [&](int first, int last) {
+            Range range(FLT_MAX, -FLT_MAX);
+            for (int index = first; index < last; index++) {
+                BrickedVolume::Brick brick = image.brick(index);
+                const Pixel *data = voxels + image.offsetOf(brick);
+                for (int lz = 0; lz < brick.size[2]; lz++) {
+                    for (int ly = 0; ly < brick.size[1]; ly++) {
+                        const Pixel *row = data + image.localOffset(0, ly, lz);
+                        for (int lx = 0; lx < brick.size[0]; lx++) {
+                            range.first = min(range.first, static_cast<float>(row[lx]));
+                            range.second = max(range.second, static_cast<float>(row[lx]));
+                        }
+                    }
+                }
+            }
+            return range;
+        });
+        stats.histogramMin = FLT_MAX;
+        stats.histogramMax = -FLT_MAX;
+        for (const Range &range : ranges) {
+            stats.histogramMin = min(stats.histogramMin, range.first);
+            stats.histogramMax = max(stats.histogramMax, range.second);
+        }
+        const float lower = stats.histogramMin;
+        const float binScale = (stats.histogramMax > lower) ? 256.0f / (stats.histogramMax - lower) : 0.0f;
+
+        // 2) Pasada principal
+        slabs = forEachSlab<shared_ptr<SlabAccumulator>>(image.brickCount(), threads, [&](int first, int last) {
+            auto slab = make_shared<SlabAccumulator>(depth);
+            for (int index = first; index < last; index++) {
+                BrickedVolume::Brick brick = image.brick(index);
+                const size_t offset = image.offsetOf(brick);
+                for (int lz = 0; lz < brick.size[2]; lz++) {
+                    for (int ly = 0; ly < brick.size[1]; ly++) {
+                        const size_t row = offset + image.localOffset(0, ly, lz);
+                        for (int lx = 0; lx < brick.size[0]; lx++) {
+                            int label = labels[row + lx];
+                            if (label == 0) {
+                                continue;
+                            }
+                            float value = static_cast<float>(voxels[row + lx]);
+                            int bin = min(255, static_cast<int>((value - lower) * binScale));
+                            slab->at(label).add(value, max(0, bin), brick.origin[0] + lx, brick.origin[1] + ly,
+                                                brick.origin[2] + lz);
+                        }
+                    }
+                }
+            }
+            return slab;
+        });
+    });
+
+    // 3) Fusionar los bloques
+    mergeSlabs(slabs, depth, stats);
+    return true;
+}
+
+string report(const VolumeStats &stats) {
+    auto describe = [](const string &title, const LabelVolumeStats &label) {
+        string text = title + ": " + to_string(label.voxels) + " vóxeles, " + formatNumber(label.volumeMm3, 1) + " mm³ (" +
+                      formatNumber(label.volumeMm3 / 1000.0, 2) + " cm³)\n";
+        if (label.voxels == 0) {
+            return text;
+        }
+        text += "    Intensidad: min " + formatNumber(label.minimum, 2) + ", max " + formatNumber(label.maximum, 2) + ", media " +
+                formatNumber(label.mean, 2) + ", desv. " + formatNumber(label.stdDev, 2) + ", asimetría " +
+                formatNumber(label.skewness, 3) + ", curtosis " + formatNumber(label.kurtosis, 3) + "\n";
+        text += "    Caja: x [" + to_string(label.boundsMin[0]) + ", " + to_string(label.boundsMax[0]) + "], y [" +
+                to_string(label.boundsMin[1]) + ", " + to_string(label.boundsMax[1]) + "], z [" + to_string(label.boundsMin[2]) +
+                ", " + to_string(label.boundsMax[2]) + "]\n";
+        text += "    Slice con más área: " + to_string(label.largestSlice) + " (" + to_string(label.largestSliceArea) + " vóxeles)\n";
+        return text;
+    };
+
+    string text = "Volumen: " + to_string(stats.size[0]) + " x " + to_string(stats.size[1]) + " x " + to_string(stats.size[2]) +
+                  " vóxeles, spacing " + formatNumber(stats.spacing[0], 3) + " x " + formatNumber(stats.spacing[1], 3) + " x " +
+                  formatNumber(stats.spacing[2], 3) + " mm\n";
+    text += describe("Tumor completo", stats.tumor);
+    for (const LabelVolumeStats &label : stats.labels) {
+        text += describe("[" + to_string(label.label) + "] " + labelName(label.label), label);
+    }
+    return text;
+}
+
+string csvHeader() {
+    return "case,label,name,voxels,volume_mm3,min,max,mean,std,skewness,kurtosis,"
+           "x_min,x_max,y_min,y_max,z_min,z_max,largest_slice,largest_slice_voxels\n";
+}
+
+string csvRows(const string &caseName, const VolumeStats &stats) {
+    string rows = csvRow(caseName, "total", "Tumor completo", stats.tumor);
+    for (const LabelVolumeStats &label : stats.labels) {
+        rows += csvRow(caseName, to_string(label.label), labelName(label.label), label);
+    }
+    return rows;
+}
+
+string histogramCsvHeader() {
+    return "case,label,bin,lower,voxels\n";
+}
+
+string histogramCsvRows(const string &caseName, const VolumeStats &stats) {
+    float binWidth = (stats.histogramMax - stats.histogramMin) / 256.0f;
+    string rows = histogramRows(caseName, "total", stats.tumor, stats.histogramMin, binWidth);
+    for (const LabelVolumeStats &label : stats.labels) {
+        rows += histogramRows(caseName, to_string(label.label), label, stats.histogramMin, binWidth);
+    }
+    return rows;
+}
+
+} // namespace VolumeStatistics
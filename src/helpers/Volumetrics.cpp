@@ -1,30 +1,53 @@
 #include <iostream>
-#include <itkExtractImageFilter.h>
-#include <itkImageRegionConstIterator.h>
+#include <itkImageIOFactory.h>
 #include <itkNiftiImageIOFactory.h>
+#include <mutex>
 #include <opencv2/imgproc.hpp>
 
+#include "helpers/OverlayKernels.h"
+#include "helpers/SlabParallel.h"
+#include "helpers/Trace.h"
+#include "helpers/VolumeCache.h"
+#include "helpers/VolumeFilters.h"
+#include "helpers/VolumeStatistics.h"
 #include "helpers/Volumetrics.h"
 
 using namespace std;
 using namespace itk;
 using namespace cv;
 
-Volumetrics::Volumetrics() {}
-Volumetrics::~Volumetrics() {}
+namespace {
 
-/**
- * @brief Cargar un volumen NIfTI
- * @param path Ruta del volumen NIfTI
- * @param type Tipo de volumen a cargar
- * @return true si se pudo cargar el volumen, false si no
- */
-bool Volumetrics::loadVolumetric(string path, string type) {
-    NiftiImageIOFactory::RegisterOneFactory();
+// Tipo en memoria de una modalidad: los enteros de 8 y 16 bits del archivo se conservan, el resto pasa a float
+VoxelType nativeVoxelType(const string &path) {
+    ImageIOBase::Pointer io = ImageIOFactory::CreateImageIO(path.c_str(), ImageIOFactory::IOFileModeEnum::ReadMode);
+    if (!io) {
+        return VoxelType::Float32;
+    }
+    try {
+        io->SetFileName(path);
+        io->ReadImageInformation();
+    } catch (ExceptionObject &) {
+        return VoxelType::Float32;
+    }
 
-    // Definir el tipo de lector (imagen 3D float)
-    using ReaderType = ImageFileReader<VolumetricImageType>;
-    ReaderType::Pointer reader = ReaderType::New();
+    switch (io->GetComponentType()) {
+    case IOComponentEnum::UCHAR:
+        return VoxelType::UInt8;
+    case IOComponentEnum::CHAR:
+    case IOComponentEnum::SHORT:
+        return VoxelType::Int16;
+    case IOComponentEnum::USHORT:
+        return VoxelType::UInt16;
+    default:
+        return VoxelType::Float32;
+    }
+}
+
+// Lee un NIfTI como itk::Image<Pixel, 3>; ITK convierte desde el tipo del archivo
+template <typename Pixel> bool readAs(const string &path, VolumeImage &image) {
+    using ReaderType = ImageFileReader<itk::Image<Pixel, 3>>;
+    typename ReaderType::Pointer reader = ReaderType::New();
 
     reader->SetFileName(path);
 
@@ -36,58 +59,358 @@ bool Volumetrics::loadVolumetric(string path, string type) {
         return false;
     }
 
+    image = VolumeImage(typename itk::Image<Pixel, 3>::Pointer(reader->GetOutput()));
+    return true;
+}
+
+} // namespace
+
+Volumetrics::Volumetrics() {
+    // Paleta por defecto: etiquetas de BraTS con su color, el resto con defaultLabelColor
+    labelColors.fill(Vec4b(defaultLabelColor.b, defaultLabelColor.g, defaultLabelColor.r, defaultLabelColor.alpha));
+    labelColors[0] = Vec4b(0, 0, 0, 0);
+    for (const SegmentationLabel &label : bratsLabels) {
+        labelColors[label.value] = Vec4b(label.b, label.g, label.r, label.alpha);
+    }
+    labelVisible.fill(true);
+    rebuildLabelPalette();
+}
+Volumetrics::~Volumetrics() {}
+
+/**
+ * @brief Cargar un volumen NIfTI
+ * @param path Ruta del volumen NIfTI
+ * @param type Tipo de volumen a cargar ("mask" o una modalidad, que pasa a ser la activa)
+ * @return true si se pudo cargar el volumen, false si no
+ */
+bool Volumetrics::loadVolumetric(string path, string type) {
+    LoadedVolume volume;
+    if (!readVolume(path, type == "mask", volume, sliceCacheEnabled)) {
+        return false;
+    }
+
+    if (type != "mask") {
+        activeModality = type;
+    }
+    setVolume(type, volume);
+    return true;
+}
+
+/**
+ * @brief Lee un volumen sin tocar ningún objeto: se puede llamar desde varios hilos a la vez
+ * @param path Ruta del volumen NIfTI
+ * @param isMask true si son etiquetas (la caché 8-bit no se normaliza)
+ * @details La máscara se guarda en uint8 y cada modalidad en el tipo de su archivo (int16,
+ * uint16 o uint8; float si es otro), no siempre en float. Para una modalidad se calcula además
+ * el histograma del volumen y la ventana por percentiles con que se construye su caché 8-bit
+ * (si buildCache)
+ * @param volume Volumen leído
+ * @param buildCache Construir también la caché 8-bit de slices
+ * @return true si se pudo leer el volumen, false si no
+ */
+bool Volumetrics::readVolume(const string &path, bool isMask, LoadedVolume &volume, bool buildCache) {
+    // Reabrir un volumen ya visto: mmap del archivo de caché, sin descomprimir
+    if (!VolumeCache::load(path, volume.image, volume.mapping)) {
+        // Registrar el lector NIfTI una sola vez, aunque se carguen volúmenes desde varios hilos
+        static once_flag niftiFactoryRegistered;
+        call_once(niftiFactoryRegistered, [] { NiftiImageIOFactory::RegisterOneFactory(); });
+
+        // Lector del tipo en que se guardará en memoria
+        bool ok = false;
+        switch (isMask ? VoxelType::UInt8 : nativeVoxelType(path)) {
+        case VoxelType::UInt8:
+            ok = readAs<uint8_t>(path, volume.image);
+            break;
+        case VoxelType::Int16:
+            ok = readAs<int16_t>(path, volume.image);
+            break;
+        case VoxelType::UInt16:
+            ok = readAs<uint16_t>(path, volume.image);
+            break;
+        case VoxelType::Float32:
+            ok = readAs<float>(path, volume.image);
+            break;
+        }
+        if (!ok) {
+            return false;
+        }
+        volume.mapping.reset();
+
+        // Si no se puede escribir la caché se sigue igual: solo la próxima carga será lenta
+        VolumeCache::store(path, volume.image);
+    }
+
+    if (isMask) {
+        volume.image = volume.image.toLabels(); // Por si la caché lo guardó al leerlo como modalidad
+        volume.sliceCache = buildCache ? buildLabelCache(volume.image) : Mat();
+    } else if (buildCache) {
+        prepareIntensity(volume, buildCache); // Sin caché se prepara al activarse la modalidad
+    }
+    return true;
+}
+
+/**
+ * @brief Instala un volumen ya leído (p. ej. por VolumeLoader en otro hilo)
+ * @param type "mask" o el nombre de la modalidad; si es la activa, pasa a mostrarse
+ * @param volume Volumen leído con readVolume
+ */
+void Volumetrics::setVolume(const string &type, const LoadedVolume &volume) {
     if (type == "mask") {
-        volumetricImageMask = reader->GetOutput();
-        return true;
+        volumeMaskMapping = volume.mapping;
+        volumetricImageMask = volume.image.toLabels();
+        if (!sliceCacheEnabled) {
+            sliceMaskCache = Mat();
+        } else if (!volume.sliceCache.empty()) {
+            sliceMaskCache = volume.sliceCache;
+        } else {
+            sliceMaskCache = buildLabelCache(volumetricImageMask);
+        }
+        rebuildSagittalCaches(false, true);
+        rebuildBrickedVolumes(false, true);
+        contentVersion++;
+        return;
+    }
+
+    modalities[type] = volume;
+    if (type == activeModality) {
+        setActiveModality(type);
     }
+}
 
-    volumetricImage = reader->GetOutput();
+/**
+ * @brief Cambia la modalidad que se muestra (FLAIR, T1, T1c, T2)
+ * @details La caché 8-bit de cada modalidad se construye una vez y se conserva, así que volver
+ * a una modalidad ya vista solo cambia punteros; hay que volver a llamar a setSliceAsMat
+ * @return false si esa modalidad no está cargada
+ */
+bool Volumetrics::setActiveModality(const string &type) {
+    auto found = modalities.find(type);
+    if (found == modalities.end()) {
+        return false;
+    }
+
+    LoadedVolume &volume = found->second;
+    prepareIntensity(volume, sliceCacheEnabled);
+
+    activeModality = type;
+    volumeMapping = volume.mapping;
+    volumetricImage = volume.image;
+    intensity = volume.intensity;
+    intensityWindow = volume.window;
+    sliceCache = sliceCacheEnabled ? volume.sliceCache : Mat();
+    volumeFiltered = false;
+    rebuildSagittalCaches(true, false);
+    rebuildBrickedVolumes(true, false);
+    contentVersion++;
     return true;
 }
 
 /**
- * @brief Procesar un slice resaltando en color la zona afectada, metodo principal
- * @return Mat con el slice resaltado
+ * @brief Filtra en 3D el volumen que se muestra (suavizado o morfología a través de Z)
+ * @details El resultado (float) reemplaza al volumen activo y se vuelve a construir su caché
+ * 8-bit con la misma ventana, así que navegar por los slices después no vuelve a filtrar nada.
+ * Se puede encadenar: cada llamada filtra lo que ya se muestra. La modalidad original se
+ * conserva y vuelve con clearVolumeFilters o al cambiar de modalidad; hay que volver a llamar
+ * a setSliceAsMat. Con el almacenamiento por bloques activo se filtra brick a brick
+ * @param effectId Efecto con versión 3D (ver VolumeFilters::supports)
+ * @param params Tamaños de kernel y sigma
+ * @param threads Hilos a usar; 0 = todos los núcleos
+ * @return false si no hay volumen o el efecto no tiene versión 3D
  */
-Mat Volumetrics::processSlice(Mat sliceToProcess) {
-    if (slice.empty() || sliceMask.empty()) {
-        cerr << "Volumetrics::processSlice: slice o sliceMask vacíos.\n";
+bool Volumetrics::applyVolumeFilter(EffectId effectId, const EffectParams &params, size_t threads) {
+    LoadedVolume filtered;
+    if (!filterVolume(effectId, params, filtered, threads)) {
+        return false;
+    }
+    installFilteredVolume(filtered);
+    return true;
+}
+
+/**
+ * @brief Calcula el filtro 3D sin tocar lo que se muestra
+ * @details Solo lee el volumen activo, así que puede correr en otro hilo sobre una copia de
+ * este objeto; el resultado lleva ya su caché 8-bit con la ventana actual
+ * @param effectId Efecto con versión 3D (ver VolumeFilters::supports)
+ * @param params Tamaños de kernel y sigma
+ * @param filtered Volumen filtrado, listo para installFilteredVolume
+ * @param threads Hilos a usar; 0 = todos los núcleos
+ * @return false si no hay volumen o el efecto no tiene versión 3D
+ */
+bool Volumetrics::filterVolume(EffectId effectId, const EffectParams &params, LoadedVolume &filtered,
+                               size_t threads) const {
+    if (!volumetricImage) {
+        cerr << "Volumetrics::filterVolume: volumetricImage no está cargado.\n";
+        return false;
+    }
+
+    VolumetricImagePointer image = brickedImage ? VolumeFilters::apply(effectId, brickedImage, params, threads)
+                                                : VolumeFilters::apply(effectId, volumetricImage, params, threads);
+    if (!image) {
+        cerr << "Volumetrics::filterVolume: el efecto no tiene versión 3D.\n";
+        return false;
+    }
+
+    filtered = LoadedVolume();
+    filtered.image = image;
+    filtered.window = intensityWindow;
+    prepareIntensity(filtered, sliceCacheEnabled);
+    return true;
+}
+
+/**
+ * @brief Muestra un volumen calculado con filterVolume en lugar del activo
+ * @details Rehace las cachés que dependen del volumen y cambia contentVersion; hay que volver
+ * a llamar a setSliceAsMat
+ */
+void Volumetrics::installFilteredVolume(const LoadedVolume &filtered) {
+    volumetricImage = filtered.image;
+    intensity = filtered.intensity;
+    sliceCache = filtered.sliceCache;
+    volumeFiltered = true;
+    rebuildSagittalCaches(true, false);
+    rebuildBrickedVolumes(true, false);
+    contentVersion++;
+}
+
+/**
+ * @brief Vuelve a mostrar la modalidad activa sin filtros 3D
+ */
+void Volumetrics::clearVolumeFilters() {
+    if (volumeFiltered) {
+        setActiveModality(activeModality);
+    }
+}
+
+/**
+ * @brief Descarta todos los volúmenes cargados (antes de abrir otro paciente)
+ */
+void Volumetrics::clearVolumes() {
+    modalities.clear();
+    slice.release();
+    sliceMask.release();
+    sliceCache.release();
+    sliceMaskCache.release();
+    sagittalCache.release();
+    sagittalMaskCache.release();
+    brickedImage = BrickedVolume();
+    brickedMask = BrickedVolume();
+    intensity.reset();
+    intensityWindow = IntensityWindow();
+    volumetricImage = VolumeImage();
+    volumetricImageMask = VolumeImage();
+    volumeMapping.reset();
+    volumeMaskMapping.reset();
+    volumeFiltered = false;
+    contentVersion++;
+}
+
+/**
+ * @brief Prepara la normalización de una modalidad: niveles, histograma, ventana y caché 8-bit
+ * @details Todo el volumen usa una sola ventana (por defecto entre percentiles), en lugar del
+ * min/max de cada slice: el brillo no salta entre slices y un umbral fijo vale igual en todos.
+ * Lo que ya esté calculado se conserva; la caché se construye desde los niveles cuantizados
+ * con una tabla, en paralelo
+ * @param volume Volumen con image; si window ya es válida se respeta
+ * @param buildCache Construir también los niveles y la caché 8-bit de slices
+ */
+void Volumetrics::prepareIntensity(LoadedVolume &volume, bool buildCache) {
+    TRACE_SCOPE("Volumetrics::prepareIntensity");
+    if (!volume.image) {
+        return;
+    }
+
+    if (!volume.intensity || (buildCache && !volume.intensity->hasLevels(volume.image))) {
+        auto quantized = make_shared<QuantizedVolume>();
+        IntensityWindowing::quantize(volume.image, *quantized, buildCache);
+        volume.intensity = quantized;
+        volume.sliceCache.release();
+    }
+
+    if (!volume.window.isValid()) {
+        volume.window = IntensityWindowing::percentileWindow(*volume.intensity);
+    }
+    if (buildCache && volume.sliceCache.empty()) {
+        IntensityWindowing::apply(volume.image, *volume.intensity, volume.window, volume.sliceCache);
+    }
+}
+
+/**
+ * @brief Construye la caché 8-bit de las etiquetas de una máscara
+ * @details La máscara ya es uint8 con el mismo layout que la caché, así que es una sola copia
+ * contigua; cambiar de slice solo crea una cabecera Mat. Se copia (en lugar de envolver el
+ * buffer ITK) para que los slices entregados sigan siendo válidos si se cambia de máscara
+ * @param image Máscara a cachear (uint8)
+ * @return Mat CV_8UC1 de (depth * height) x width, vacío si el volumen no es válido
+ */
+Mat Volumetrics::buildLabelCache(const VolumeImage &image) {
+    TRACE_SCOPE("Volumetrics::buildLabelCache");
+    if (!image || image.type() != VoxelType::UInt8 || image.voxelCount() == 0) {
         return Mat();
     }
 
-    Mat sliceProcessed = (sliceToProcess.empty()) ? slice.clone() : sliceToProcess.clone();
+    void *labels = const_cast<void *>(image.data());
+    return Mat(image.depth() * image.height(), image.width(), CV_8UC1, labels).clone();
+}
 
+/**
+ * @brief Procesar un slice resaltando en color la zona afectada, metodo principal
+ * @return Mat con el slice resaltado
+ */
+Mat Volumetrics::processSlice(Mat sliceToProcess) {
     Mat colorSlice;
-    cvtColor(sliceProcessed, colorSlice, COLOR_GRAY2BGR);
+    processSliceInto(sliceToProcess.empty() ? slice : sliceToProcess, colorSlice);
+    return colorSlice;
+}
 
-    Mat maksFloat;
-    sliceMask.convertTo(maksFloat, CV_32F, 1.0f / 255.0f);
+/**
+ * @brief Igual que processSlice, pero escribe en un Mat de destino reutilizable
+ * @details Si dst ya es CV_8UC3 del tamaño correcto no se reserva memoria
+ * @param src Slice en grises (CV_8UC1)
+ * @param dst Destino BGR; no debe compartir memoria con src
+ */
+void Volumetrics::processSliceInto(const Mat &src, Mat &dst) const {
+    processSliceInto(src, sliceMask, dst);
+}
 
-    const int rows = colorSlice.rows;
-    const int cols = colorSlice.cols;
-    Vec3b color;
+/**
+ * @brief Resalta un slice con su propia máscara (p. ej. un corte coronal o sagital)
+ * @param src Slice en grises (CV_8UC1) o BGR
+ * @param mask Etiquetas del mismo corte (CV_8UC1, mismo tamaño que src)
+ * @param dst Destino BGR; no debe compartir memoria con src
+ */
+void Volumetrics::processSliceInto(const Mat &src, const Mat &mask, Mat &dst) const {
+    TRACE_SCOPE("Volumetrics::processSlice");
+    if (src.empty() || mask.empty()) {
+        cerr << "Volumetrics::processSlice: slice o sliceMask vacíos.\n";
+        dst = Mat();
+        return;
+    }
 
-    for (int y = 0; y < rows; y++) {
-        for (int x = 0; x < cols; x++) {
-            float alpha = maksFloat.at<float>(y, x);
+    if (src.size() != mask.size()) {
+        cerr << "Volumetrics::processSlice: el slice y la máscara no tienen el mismo tamaño.\n";
+        dst = Mat();
+        return;
+    }
 
-            if (alpha <= 0.0f) {
-                continue;
-            }
-            color = colorSlice.at<Vec3b>(y, x);
+    // El kernel mezcla desde grises; una entrada a color (resultado de otro efecto) se convierte
+    Mat gray = src;
+    if (src.channels() == 3) {
+        cvtColor(src, gray, COLOR_BGR2GRAY);
+    }
 
-            uchar originalB = color[0];
-            uchar originalG = color[1];
-            uchar originalR = color[2];
+    dst.create(gray.size(), CV_8UC3);
 
-            float blendedR = (1.0f - alpha) * originalR + alpha * 255.0f;
-            uchar newR = cv::saturate_cast<uchar>(blendedR);
-            // Asignar de vuelta en el Mat de color
-            colorSlice.at<cv::Vec3b>(y, x) = cv::Vec3b(originalB, originalG, newR);
-        }
+    // Gris → BGR y mezcla con el color de cada etiqueta en una sola pasada
+    int rows = gray.rows;
+    int cols = gray.cols;
+    if (gray.isContinuous() && mask.isContinuous() && dst.isContinuous()) {
+        cols *= rows;
+        rows = 1;
     }
 
-    return colorSlice;
+    for (int y = 0; y < rows; y++) {
+        OverlayKernels::blendLabelRow(gray.ptr<uchar>(y), mask.ptr<uchar>(y), dst.ptr<uchar>(y), cols, labelPalette);
+    }
 }
 
 /**
@@ -97,11 +420,15 @@ Mat Volumetrics::processSlice(Mat sliceToProcess) {
  */
 Mat Volumetrics::aplyThreshold(cv::Mat sliceProcessed, double umbral) {
 
-    Mat imageToProcess = (sliceProcessed.empty()) ? slice.clone() : sliceProcessed.clone();
+    Mat imageToProcess = (sliceProcessed.empty()) ? slice : sliceProcessed;
     Mat grayImage;
     Mat thresholded;
 
-    imageToProcess.channels() == 3 ? cvtColor(imageToProcess, grayImage, COLOR_BGR2GRAY) : imageToProcess.copyTo(grayImage);
+    if (imageToProcess.channels() == 3) {
+        cvtColor(imageToProcess, grayImage, COLOR_BGR2GRAY);
+    } else {
+        grayImage = imageToProcess;
+    }
 
     threshold(grayImage, thresholded, umbral, 255, THRESH_BINARY);
     return thresholded;
@@ -109,24 +436,15 @@ Mat Volumetrics::aplyThreshold(cv::Mat sliceProcessed, double umbral) {
 
 /**
  * @brief Aplicar umbral binario a un slice
+ * @details Devuelve la zona "muerta" (etiqueta 1, necrosis) de la máscara en blanco
  */
 Mat Volumetrics::aplyUmbralBinary() {
-    Mat imageToProcess = sliceMask.clone();
-
-    if (imageToProcess.channels() == 1) {
-        Mat tmp;
-        cvtColor(imageToProcess, tmp, COLOR_GRAY2BGR);
-        imageToProcess = tmp;
+    if (sliceMask.empty()) {
+        return Mat();
     }
 
-    Mat imageHSV;
-    cvtColor(imageToProcess, imageHSV, COLOR_BGR2HSV);
-
-    Scalar lowerBoundHSV(0, 0, 60);
-    Scalar upperBoundHSV(180, 30, 70);
-
     Mat maskBinary;
-    inRange(imageHSV, lowerBoundHSV, upperBoundHSV, maskBinary);
+    compare(sliceMask, Scalar(1), maskBinary, CMP_EQ);
 
     // TODO: Redactar en el informe que si devuelve una imagen negra no hay zona "Muerta"
 
@@ -135,7 +453,7 @@ Mat Volumetrics::aplyUmbralBinary() {
 
 Mat Volumetrics::aplyContratstStreching(Mat sliceProcessed) {
 
-    Mat imageToProcess = (sliceProcessed.empty()) ? slice.clone() : sliceProcessed.clone();
+    Mat imageToProcess = (sliceProcessed.empty()) ? slice : sliceProcessed;
 
     if (imageToProcess.empty()) {
         return Mat();
@@ -176,9 +494,23 @@ Mat Volumetrics::aplyContratstStreching(Mat sliceProcessed) {
     return finalImage;
 }
 
+/**
+ * @brief Máscara 0/255 de las etiquetas visibles del slice actual (para operaciones bit a bit)
+ */
+Mat Volumetrics::binaryMask() const {
+    Mat visibleLut(1, 256, CV_8UC1);
+    for (int label = 0; label < 256; label++) {
+        visibleLut.at<uchar>(label) = (label != 0 && labelVisible[label]) ? 255 : 0;
+    }
+
+    Mat binary;
+    LUT(sliceMask, visibleLut, binary);
+    return binary;
+}
+
 Mat Volumetrics::aplyBitWiseOperation(Mat sliceProcessed1, string type) {
 
-    Mat imageToProcess = (sliceProcessed1.empty()) ? slice.clone() : sliceProcessed1.clone();
+    Mat imageToProcess = (sliceProcessed1.empty()) ? slice : sliceProcessed1;
 
     if (imageToProcess.empty() || sliceMask.empty()) {
         return Mat();
@@ -188,10 +520,8 @@ Mat Volumetrics::aplyBitWiseOperation(Mat sliceProcessed1, string type) {
         cvtColor(imageToProcess, imageToProcess, COLOR_GRAY2BGR);
     }
 
-    Mat maskColor = sliceMask.clone();
-    if (maskColor.channels() == 1) {
-        cvtColor(maskColor, maskColor, COLOR_GRAY2BGR);
-    }
+    Mat maskColor;
+    cvtColor(binaryMask(), maskColor, COLOR_GRAY2BGR);
 
     Mat result;
     if (type == "NOT") {
@@ -213,8 +543,13 @@ Mat Volumetrics::aplyBitWiseOperation(Mat sliceProcessed1, string type) {
     return result;
 }
 
-Mat Volumetrics::aplyCanny(Mat sliceProcessed) {
-    Mat imageToProcess = (sliceProcessed.empty()) ? slice.clone() : sliceProcessed.clone();
+/**
+ * @brief Detector de bordes Canny sobre el slice suavizado
+ * @param lowerThreshold Umbral inferior de histéresis
+ * @param upperThreshold Umbral superior de histéresis
+ */
+Mat Volumetrics::aplyCanny(Mat sliceProcessed, double lowerThreshold, double upperThreshold) {
+    Mat imageToProcess = (sliceProcessed.empty()) ? slice : sliceProcessed;
 
     if (imageToProcess.empty()) {
         return Mat();
@@ -225,16 +560,12 @@ Mat Volumetrics::aplyCanny(Mat sliceProcessed) {
     if (imageToProcess.channels() == 1) {
         cvtColor(imageToProcess, grayImage, COLOR_GRAY2BGR);
     } else {
-        grayImage = imageToProcess.clone();
+        grayImage = imageToProcess;
     }
 
     Mat blurredSlice;
     GaussianBlur(grayImage, blurredSlice, cv::Size(5, 5), 1.5);
 
-    // Definir umbrales para Canny
-    double lowerThreshold = 50.0;  // Umbral inferior
-    double upperThreshold = 150.0; // Umbral superior
-
     // Aplicar detector de bordes Canny
     Mat edges;
     Canny(blurredSlice, edges, lowerThreshold, upperThreshold);
@@ -242,16 +573,18 @@ Mat Volumetrics::aplyCanny(Mat sliceProcessed) {
     return edges;
 }
 
-Mat Volumetrics::adjustBrightness(Mat sliceProcessed) {
+/**
+ * @brief Suma un valor constante de brillo (saturado a 255)
+ * @param valueBrightness Valor a sumar a cada píxel
+ */
+Mat Volumetrics::adjustBrightness(Mat sliceProcessed, int valueBrightness) {
 
-    Mat imageToProcess = (sliceProcessed.empty()) ? slice.clone() : sliceProcessed.clone();
+    Mat imageToProcess = (sliceProcessed.empty()) ? slice : sliceProcessed;
 
     if (imageToProcess.empty()) {
         return Mat();
     }
 
-    int valueBrightness = 50;
-
     Mat adjustedImage;
     addWeighted(imageToProcess, 1.0, imageToProcess, 0.0, valueBrightness, adjustedImage);
 
@@ -265,7 +598,7 @@ Mat Volumetrics::adjustBrightness(Mat sliceProcessed) {
  * @param sliceProcessed Slice procesado por el metodo principal
  */
 Mat Volumetrics::aplyMeanFilter(Mat sliceProcessed, int kernelSize) {
-    Mat imageToProcess = sliceProcessed.empty() ? slice.clone() : sliceProcessed.clone();
+    Mat imageToProcess = sliceProcessed.empty() ? slice : sliceProcessed;
 
     if (imageToProcess.empty()) {
         return Mat();
@@ -287,7 +620,7 @@ Mat Volumetrics::aplyMeanFilter(Mat sliceProcessed, int kernelSize) {
  * @param sliceProcessed Slice procesado por el metodo principal
  */
 Mat Volumetrics::aplyGaussianFilter(Mat sliceProcessed, int kernelSize, double sigmaX) {
-    Mat imageToProcess = sliceProcessed.empty() ? slice.clone() : sliceProcessed.clone();
+    Mat imageToProcess = sliceProcessed.empty() ? slice : sliceProcessed;
 
     if (imageToProcess.empty()) {
         return Mat();
@@ -309,7 +642,7 @@ Mat Volumetrics::aplyGaussianFilter(Mat sliceProcessed, int kernelSize, double s
  * @param sliceProcessed Slice procesado por el metodo principal
  */
 Mat Volumetrics::aplyMedianFilter(Mat sliceProcessed, int kernelSize) {
-    Mat imageToProcess = sliceProcessed.empty() ? slice.clone() : sliceProcessed.clone();
+    Mat imageToProcess = sliceProcessed.empty() ? slice : sliceProcessed;
 
     if (imageToProcess.empty()) {
         return Mat();
@@ -331,7 +664,7 @@ Mat Volumetrics::aplyMedianFilter(Mat sliceProcessed, int kernelSize) {
 
 /** @brief Aplica un filtro bilateral a la imagen */
 Mat Volumetrics::aplyBilateralFilter(Mat sliceProcessed, int diameter, double sigmaColor, double sigmaSpace) {
-    Mat imageToProcess = sliceProcessed.empty() ? slice.clone() : sliceProcessed.clone();
+    Mat imageToProcess = sliceProcessed.empty() ? slice : sliceProcessed;
 
     if (imageToProcess.empty()) {
         return Mat();
@@ -354,16 +687,14 @@ Mat Volumetrics::aplyBilateralFilter(Mat sliceProcessed, int diameter, double si
  * @brief Setear la región de un slice en Z = sliceIndex y lo guarda en this->slice
  */
 void Volumetrics::setSliceAsMat() {
+    TRACE_SCOPE("Volumetrics::setSliceAsMat");
     if (!volumetricImage) {
         cerr << "Volumetrics::setSliceAsMat: volumetricImage no está cargado.\n";
         slice = Mat(); // slice vacío
         return;
     }
 
-    // Obtener las dimensiones Z del volumen
-    auto region3D = volumetricImage->GetLargestPossibleRegion();
-    auto size3D = region3D.GetSize();
-    size_t depth = size3D[2];
+    size_t depth = volumetricImage.depth();
 
     if (sliceIndex < 0 || static_cast<size_t>(sliceIndex) >= depth) {
         cerr << "Volumetrics::setSliceAsMat: índice fuera de rango (Z = "
@@ -372,73 +703,24 @@ void Volumetrics::setSliceAsMat() {
         return;
     }
 
-    // Definir la región 3D para extraer un slice en Z = sliceIndex
-    ImageRegion<3> sliceRegion;
-    {
-        // Tomamos el índice y el tamaño de la región entera
-        auto start3D = region3D.GetIndex();
-        auto sizeRegion3D = region3D.GetSize();
-
-        sizeRegion3D[2] = 0;
-        start3D[2] = sliceIndex;
-
-        sliceRegion.SetSize(sizeRegion3D);
-        sliceRegion.SetIndex(start3D);
-    }
-
-    // 3) Configurar el filtro de extracción de ITK (2D) a partir de la imagen 3D
-    using ExtractFilterType = ExtractImageFilter<VolumetricImageType, Image<float, 2>>;
-    ExtractFilterType::Pointer extractFilter = ExtractFilterType::New();
-
-    extractFilter->SetInput(volumetricImage);
-    extractFilter->SetExtractionRegion(sliceRegion);
-    extractFilter->SetDirectionCollapseToIdentity(); // para mantener orientaciones 2D válidas
-
-    try {
-        extractFilter->Update();
-    } catch (ExceptionObject &e) {
-        cerr << "Volumetrics::setSliceAsMat: error extrayendo slice: " << e << "\n";
-        slice = Mat();
+    // Si existe la caché 8-bit, el slice es solo una cabecera sobre la memoria precalculada
+    if (!sliceCache.empty()) {
+        int height = sliceCache.rows / static_cast<int>(depth);
+        slice = sliceCache.rowRange(sliceIndex * height, (sliceIndex + 1) * height);
         return;
     }
 
-    // 4) Convertir el result (ITK Image<float,2>) a Mat (float 2D)
-    auto itkSlice2D = extractFilter->GetOutput();
-    auto region2D = itkSlice2D->GetLargestPossibleRegion();
-    auto size2D = region2D.GetSize();
-    int width = static_cast<int>(size2D[0]);
-    int height = static_cast<int>(size2D[1]);
-
-    // Creamos un Mat en 32-bit float
-    Mat matFloat(height, width, CV_32FC1);
-
-    // Iterar sobre cada píxel del slice ITK y copiarlo al Mat
-    ImageRegionConstIterator<Image<float, 2>> it(itkSlice2D, region2D);
-    for (it.GoToBegin(); !it.IsAtEnd(); ++it) {
-        auto idx = it.GetIndex();
-        int x = static_cast<int>(idx[0]);
-        int y = static_cast<int>(idx[1]);
-        matFloat.at<float>(y, x) = it.Get();
-    }
-
-    //  Normalizar el matFloat a 8-bit (0-255) y asignar a this->slice
-    double minVal, maxVal;
-    minMaxLoc(matFloat, &minVal, &maxVal);
-    if (maxVal - minVal <= 0.0) {
-        // Volumen constante o error: llenamos con ceros
-        slice = Mat::zeros(height, width, CV_8UC1);
-    } else {
-        matFloat.convertTo(slice,
-                           CV_8UC1,
-                           255.0 / (maxVal - minVal),
-                           -minVal * 255.0 / (maxVal - minVal));
-    }
+    // Sin caché: vista directa sobre el buffer ITK y una única conversión con la ventana
+    Mat normalized;
+    IntensityWindowing::convert(sliceViewOf(volumetricImage, SliceAxis::Axial, sliceIndex), intensityWindow, normalized);
+    slice = normalized;
 }
 
 /**
  * @brief Extrae un slice del volumen de máscaras y lo guarda en this->sliceMask
  */
 void Volumetrics::setSliceMaskAsMat() {
+    TRACE_SCOPE("Volumetrics::setSliceMaskAsMat");
     // 1) Verificar que volumetricImageMask no sea nulo
     if (!volumetricImageMask) {
         cerr << "Volumetrics::setSliceMaskAsMat: volumetricImageMask no está cargado.\n";
@@ -447,9 +729,7 @@ void Volumetrics::setSliceMaskAsMat() {
     }
 
     // 2) Comprobar rango en Z
-    auto region3D = volumetricImageMask->GetLargestPossibleRegion();
-    auto size3D = region3D.GetSize();
-    size_t depth = size3D[2];
+    size_t depth = volumetricImageMask.depth();
 
     if (sliceIndex < 0 || static_cast<size_t>(sliceIndex) >= depth) {
         cerr << "Volumetrics::setSliceMaskAsMat: índice fuera de rango (Z = "
@@ -458,62 +738,276 @@ void Volumetrics::setSliceMaskAsMat() {
         return;
     }
 
-    // 3) Definir región 3D para extraer solo un slice en Z = sliceIndex
-    ImageRegion<3> sliceRegion;
-    {
-        auto start3D = region3D.GetIndex();
-        auto sizeRegion = region3D.GetSize();
+    // Si existe la caché 8-bit, la máscara es solo una cabecera sobre la memoria precalculada
+    if (!sliceMaskCache.empty()) {
+        int height = sliceMaskCache.rows / static_cast<int>(depth);
+        sliceMask = sliceMaskCache.rowRange(sliceIndex * height, (sliceIndex + 1) * height);
+        return;
+    }
 
-        sizeRegion[2] = 0;
-        start3D[2] = sliceIndex;
+    // 3) Vista directa sobre el buffer ITK; las etiquetas se guardan sin normalizar
+    Mat labels;
+    labelsTo8U(sliceViewOf(volumetricImageMask, SliceAxis::Axial, sliceIndex), labels);
+    sliceMask = labels;
+}
 
-        sliceRegion.SetSize(sizeRegion);
-        sliceRegion.SetIndex(start3D);
+/**
+ * @brief Devuelve una vista de un slice del volumen (o de la máscara) en cualquier eje
+ * @details Axial y coronal son cabeceras Mat sobre el buffer ITK (sin copia, válidas mientras
+ * el volumen siga cargado; no escribir en ellas); sagital no es representable con un solo paso
+ * de fila y se copia. El tipo es el del volumen en memoria: quien necesite float lo convierte
+ * @param axis Eje del corte
+ * @param index Posición del corte a lo largo del eje
+ * @param fromMask true para leer del volumen de máscaras
+ * @return Mat CV_8UC1, CV_16SC1, CV_16UC1 o CV_32FC1 (filas = Y para axial, Z para
+ * coronal/sagital), vacío si no es válido
+ */
+Mat Volumetrics::getSliceView(SliceAxis axis, int index, bool fromMask) const {
+    // Con bricks, coronal y sagital se copian brick a brick en lugar de saltar por el buffer
+    const BrickedVolume &bricked = fromMask ? brickedMask : brickedImage;
+    if (bricked && axis != SliceAxis::Axial) {
+        return bricked.slice(axis, index);
     }
+    return sliceViewOf(fromMask ? volumetricImageMask : volumetricImage, axis, index);
+}
 
-    // 4) Extraer el slice 2D de la máscara
-    using ExtractFilterType = ExtractImageFilter<VolumetricImageType, Image<float, 2>>;
-    ExtractFilterType::Pointer extractFilter = ExtractFilterType::New();
-    extractFilter->SetInput(volumetricImageMask);
-    extractFilter->SetExtractionRegion(sliceRegion);
-    extractFilter->SetDirectionCollapseToIdentity();
+/**
+ * @brief Slice 8-bit (con la ventana de intensidad) en cualquier eje, para la vista multiplanar
+ * @details Con la caché activa el axial es un bloque de filas de la caché, el coronal una
+ * copia de depth filas contiguas (una por slice) y el sagital un bloque de filas de la caché
+ * traspuesta (si la vista multiplanar está activa; si no, se recolecta). Sin caché se
+ * convierte la vista del volumen. No escribir en el resultado
+ * @param axis Eje del corte
+ * @param index Posición del corte a lo largo del eje
+ * @return Mat CV_8UC1 (filas = Y para axial, Z para coronal/sagital), vacío si no es válido
+ */
+Mat Volumetrics::getSliceAsMat(SliceAxis axis, int index) const {
+    return planeOf(sliceCache, sagittalCache, volumetricImage, axis, index, false);
+}
 
-    try {
-        extractFilter->Update();
-    } catch (ExceptionObject &e) {
-        cerr << "Volumetrics::setSliceMaskAsMat: error al extraer mask slice: " << e << "\n";
-        sliceMask = cv::Mat();
-        return;
+/**
+ * @brief Etiquetas de la máscara en cualquier eje (mismo layout que getSliceAsMat(axis, index))
+ */
+Mat Volumetrics::getSliceMaskAsMat(SliceAxis axis, int index) const {
+    return planeOf(sliceMaskCache, sagittalMaskCache, volumetricImageMask, axis, index, true);
+}
+
+/**
+ * @brief Estadísticos 3D de la modalidad activa dentro de cada etiqueta de la máscara
+ * @param stats Resultado (volúmenes en mm³, momentos, histogramas, cajas, slice con más tumor)
+ * @param threads Hilos a usar; 0 = todos los núcleos
+ * @return false si falta el volumen o la máscara
+ */
+bool Volumetrics::computeVolumeStatistics(VolumeStats &stats, size_t threads) const {
+    if (brickedImage && brickedMask) {
+        return VolumeStatistics::compute(brickedImage, brickedMask, stats, threads);
     }
+    return VolumeStatistics::compute(volumetricImage, volumetricImageMask, stats, threads);
+}
 
-    // 5) Convertir ITK slice (float 2D) a cv::Mat<float>
-    auto itkSlice2D = extractFilter->GetOutput();
-    auto region2D = itkSlice2D->GetLargestPossibleRegion();
-    auto size2D = region2D.GetSize();
-    int width = static_cast<int>(size2D[0]);
-    int height = static_cast<int>(size2D[1]);
+/**
+ * @brief Construye la vista de un corte sobre el buffer lineal (x-más-rápido) de un volumen
+ */
+Mat Volumetrics::sliceViewOf(const VolumeImage &image, SliceAxis axis, int index) {
+    TRACE_SCOPE("Volumetrics::sliceViewOf");
+    if (!image) {
+        return Mat();
+    }
 
-    cv::Mat matFloatMask(height, width, CV_32FC1);
-    ImageRegionConstIterator<Image<float, 2>> it(itkSlice2D, region2D);
-    for (it.GoToBegin(); !it.IsAtEnd(); ++it) {
-        auto idx = it.GetIndex();
-        int x = static_cast<int>(idx[0]);
-        int y = static_cast<int>(idx[1]);
-        matFloatMask.at<float>(y, x) = it.Get();
+    const int width = image.width();
+    const int height = image.height();
+    const int depth = image.depth();
+    const size_t sliceSize = static_cast<size_t>(width) * height;
+    const int type = CV_MAKETYPE(image.cvDepth(), 1);
+    const size_t voxelSize = voxelBytes(image.type());
+    // Las vistas son de solo lectura aunque Mat pida un puntero no const
+    char *buffer = static_cast<char *>(const_cast<void *>(image.data()));
+
+    switch (axis) {
+    case SliceAxis::Axial:
+        if (index < 0 || index >= depth) return Mat();
+        // El slice Z es un bloque contiguo de width * height vóxeles
+        return Mat(height, width, type, buffer + index * sliceSize * voxelSize);
+
+    case SliceAxis::Coronal:
+        if (index < 0 || index >= height) return Mat();
+        // Cada fila (Z) es contigua en X; entre filas se salta un slice axial completo
+        return Mat(depth, width, type, buffer + static_cast<size_t>(index) * width * voxelSize, sliceSize * voxelSize);
+
+    case SliceAxis::Sagittal: {
+        if (index < 0 || index >= width) return Mat();
+        // En X fijo ni filas ni columnas son contiguas: recolección con punteros, en el tipo nativo
+        Mat sagittal(depth, height, type);
+        image.visit([&](const auto *voxels) {
+            using Pixel = PixelOf<decltype(voxels)>;
+            for (int z = 0; z < depth; z++) {
+                const Pixel *src = voxels + z * sliceSize + index;
+                Pixel *dst = sagittal.ptr<Pixel>(z);
+                for (int y = 0; y < height; y++) {
+                    dst[y] = src[static_cast<size_t>(y) * width];
+                }
+            }
+        });
+        return sagittal;
+    }
     }
 
-    // 6) Normalizar a 8-bit y guardar en sliceMask
-    double minVal, maxVal;
-    cv::minMaxLoc(matFloatMask, &minVal, &maxVal);
-    if (maxVal - minVal <= 0.0) {
-        sliceMask = cv::Mat::zeros(height, width, CV_8UC1);
+    return Mat();
+}
+
+/**
+ * @brief Corte 8-bit desde las cachés (axial como vista, coronal copiando filas, sagital de la
+ * traspuesta)
+ * @details Lo que no esté cacheado sale de la vista del volumen: las etiquetas tal cual y
+ * las intensidades con la ventana actual
+ */
+Mat Volumetrics::planeOf(const Mat &cache, const Mat &sagittal, const VolumeImage &image, SliceAxis axis, int index,
+                         bool labels) const {
+    if (!image) {
+        return Mat();
+    }
+
+    const int width = image.width();
+    const int height = image.height();
+    const int depth = image.depth();
+    if (!cache.empty()) {
+        switch (axis) {
+        case SliceAxis::Axial:
+            if (index < 0 || index >= depth) return Mat();
+            return cache.rowRange(index * height, (index + 1) * height);
+
+        case SliceAxis::Coronal: {
+            if (index < 0 || index >= height) return Mat();
+            // Fila Y de cada slice: depth filas contiguas. Se copian (son pocos bytes): una cabecera
+            // con paso no mantendría viva la caché si se reemplaza, como sí hace rowRange
+            uchar *row = const_cast<uchar *>(cache.ptr<uchar>(index));
+            return Mat(depth, width, CV_8UC1, row, height * cache.step[0]).clone();
+        }
+
+        case SliceAxis::Sagittal:
+            if (sagittal.empty()) break;
+            if (index < 0 || index >= width) return Mat();
+            return sagittal.rowRange(index * depth, (index + 1) * depth);
+        }
+    }
+
+    Mat view = getSliceView(axis, index, labels);
+    Mat plane;
+    if (labels) {
+        labelsTo8U(view, plane);
     } else {
-        matFloatMask.convertTo(
-            sliceMask,
-            CV_8UC1,
-            255.0 / (maxVal - minVal),
-            -minVal * 255.0 / (maxVal - minVal));
+        IntensityWindowing::convert(view, intensityWindow, plane);
+    }
+    return plane;
+}
+
+/**
+ * @brief Traspone una caché 8-bit a cortes sagitales, por teselas y en paralelo
+ * @details Leer un corte sagital de la caché axial toca una línea de caché distinta por cada
+ * píxel. La copia traspuesta se construye una vez por teselas de 32 x 32 (lo leído y lo
+ * escrito cabe en L1) repartiendo X entre hilos, y después cada corte sagital es un bloque
+ * contiguo de filas, igual que un axial
+ * @param cache Caché (depth * height) x width, CV_8UC1
+ * @param depth Número de slices axiales
+ * @param threads Hilos a usar; 0 = todos los núcleos
+ * @return Mat CV_8UC1 de (width * depth) x height, vacío si cache lo está
+ */
+Mat Volumetrics::buildSagittalCache(const Mat &cache, int depth, size_t threads) {
+    TRACE_SCOPE("Volumetrics::buildSagittalCache");
+    if (cache.empty() || depth <= 0) {
+        return Mat();
     }
+
+    const int tile = 32;
+    const int height = cache.rows / depth;
+    const int width = cache.cols;
+    const size_t step = cache.step[0];
+    Mat sagittal(width * depth, height, CV_8UC1);
+
+    // Cada bloque de X escribe solo sus cortes sagitales
+    forEachSlab<int>(width, threads, [&](int xBegin, int xEnd) {
+        for (int z = 0; z < depth; z++) {
+            const uchar *slice = cache.ptr<uchar>(z * height);
+            for (int x0 = xBegin; x0 < xEnd; x0 += tile) {
+                const int x1 = min(xEnd, x0 + tile);
+                for (int y0 = 0; y0 < height; y0 += tile) {
+                    const int y1 = min(height, y0 + tile);
+                    for (int x = x0; x < x1; x++) {
+                        uchar *dst = sagittal.ptr<uchar>(x * depth + z);
+                        const uchar *src = slice + x;
+                        for (int y = y0; y < y1; y++) {
+                            dst[y] = src[y * step];
+                        }
+                    }
+                }
+            }
+        }
+        return 0;
+    });
+    return sagittal;
+}
+
+/**
+ * @brief Rehace las cachés sagitales tras cambiar las cachés 8-bit de las que salen
+ * @details Sin la vista multiplanar (o sin caché) se liberan. Se escriben en memoria nueva,
+ * así que las copias de Volumetrics de otros hilos siguen viendo las anteriores
+ * @param intensityCache Rehacer la de la modalidad mostrada
+ * @param maskCache Rehacer la de la máscara
+ */
+void Volumetrics::rebuildSagittalCaches(bool intensityCache, bool maskCache) {
+    if (intensityCache) {
+        bool build = multiPlanarEnabled && volumetricImage;
+        sagittalCache = build ? buildSagittalCache(sliceCache, volumetricImage.depth()) : Mat();
+    }
+    if (maskCache) {
+        bool build = multiPlanarEnabled && volumetricImageMask;
+        sagittalMaskCache = build ? buildSagittalCache(sliceMaskCache, volumetricImageMask.depth()) : Mat();
+    }
+}
+
+/**
+ * @brief Rehace las copias por bloques tras cambiar el volumen mostrado o la máscara
+ * @details Sin el almacenamiento por bloques se liberan. Como las cachés, se construyen en
+ * memoria nueva y las copias de Volumetrics de otros hilos conservan las anteriores
+ * @param intensityVolume Rehacer la del volumen mostrado
+ * @param maskVolume Rehacer la de la máscara
+ */
+void Volumetrics::rebuildBrickedVolumes(bool intensityVolume, bool maskVolume) {
+    if (intensityVolume) {
+        bool build = brickedLayoutEnabled && volumetricImage;
+        brickedImage = build ? BrickedVolume(volumetricImage) : BrickedVolume();
+    }
+    if (maskVolume) {
+        bool build = brickedLayoutEnabled && volumetricImageMask;
+        brickedMask = build ? BrickedVolume(volumetricImageMask) : BrickedVolume();
+    }
+}
+
+/**
+ * @brief Convierte un slice de etiquetas a 8-bit sin escalar (1, 2 y 4 siguen siendo 1, 2 y 4)
+ * @param src Mat de la máscara (CV_8UC1: es una copia)
+ * @param dst Destino CV_8UC1; si ya tiene el tamaño correcto se escribe en su memoria
+ */
+void Volumetrics::labelsTo8U(const Mat &src, Mat &dst) {
+    if (src.empty()) {
+        dst = Mat();
+        return;
+    }
+    src.convertTo(dst, CV_8UC1);
+}
+
+/**
+ * @brief Rehace la paleta que usa el kernel de resaltado (etiqueta oculta = alpha 0)
+ */
+void Volumetrics::rebuildLabelPalette() {
+    for (int label = 0; label < 256; label++) {
+        const Vec4b &color = labelColors[label];
+        labelPalette.b[label] = color[0];
+        labelPalette.g[label] = color[1];
+        labelPalette.r[label] = color[2];
+        labelPalette.alpha[label] = labelVisible[label] ? color[3] : 0;
+    }
+    contentVersion++;
 }
 
 /**
@@ -523,17 +1017,165 @@ void Volumetrics::setSliceIndex(int index) {
     this->sliceIndex = index;
 }
 
+/**
+ * @brief Activa o desactiva la caché 8-bit de slices
+ * @details Al activarla se construye para los volúmenes ya cargados; al desactivarla se libera
+ */
+void Volumetrics::setSliceCacheEnabled(bool enabled) {
+    sliceCacheEnabled = enabled;
+    // Las demás modalidades la construyen al activarse
+    for (auto &entry : modalities) {
+        entry.second.sliceCache.release();
+    }
+    sliceMaskCache = enabled ? buildLabelCache(volumetricImageMask) : Mat();
+    sliceCache.release();
+    if (!volumetricImage) {
+        rebuildSagittalCaches(true, true);
+        return;
+    }
+
+    LoadedVolume shown;
+    shown.image = volumetricImage;
+    shown.intensity = intensity;
+    shown.window = intensityWindow;
+    prepareIntensity(shown, enabled);
+    intensity = shown.intensity;
+    sliceCache = shown.sliceCache;
+    rebuildSagittalCaches(true, true);
+
+    auto active = modalities.find(activeModality);
+    if (active != modalities.end() && !volumeFiltered) {
+        active->second.intensity = intensity;
+        active->second.sliceCache = sliceCache;
+    }
+}
+
+/**
+ * @brief Activa o desactiva la vista multiplanar (cortes coronales y sagitales)
+ * @details Al activarla se construyen las cachés sagitales traspuestas del volumen mostrado y
+ * de la máscara, que después se mantienen al cambiar de modalidad, filtro o ventana; al
+ * desactivarla se liberan. Los coronales no necesitan copia
+ */
+void Volumetrics::setMultiPlanarEnabled(bool enabled) {
+    if (enabled == multiPlanarEnabled) {
+        return;
+    }
+    multiPlanarEnabled = enabled;
+    rebuildSagittalCaches(true, true);
+}
+
+/**
+ * @brief Activa o desactiva el almacenamiento por bloques (bricks de 32³)
+ * @details Mantiene, junto al buffer lineal de ITK, una copia por bricks del volumen mostrado
+ * y de la máscara. Con ella los cortes coronales y sagitales sin caché, los estadísticos 3D
+ * y los filtros 3D recorren bricks contiguos en memoria en lugar de saltar slices completos.
+ * Cuesta otra copia de cada volumen (más el relleno de los bricks del borde)
+ */
+void Volumetrics::setBrickedLayoutEnabled(bool enabled) {
+    if (enabled == brickedLayoutEnabled) {
+        return;
+    }
+    brickedLayoutEnabled = enabled;
+    rebuildBrickedVolumes(true, true);
+}
+
+/**
+ * @brief Cambia la ventana de intensidades (window/level) del volumen mostrado
+ * @details Rehace la caché 8-bit desde los niveles cuantizados (una tabla y una pasada en
+ * paralelo, sin leer los float) en memoria nueva (también la sagital, si está activa la vista
+ * multiplanar): las copias de Volumetrics de otros hilos
+ * siguen viendo la anterior. La ventana se recuerda por modalidad; hay que volver a llamar
+ * a setSliceAsMat
+ * @return false si no hay volumen o la ventana no es válida (high <= low)
+ */
+bool Volumetrics::setIntensityWindow(const IntensityWindow &window) {
+    if (!intensity || !window.isValid()) {
+        return false;
+    }
+    if (window == intensityWindow) {
+        return true;
+    }
+
+    intensityWindow = window;
+    if (sliceCacheEnabled) {
+        Mat cache;
+        IntensityWindowing::apply(volumetricImage, *intensity, window, cache);
+        sliceCache = cache;
+        rebuildSagittalCaches(true, false);
+    }
+
+    // Sin filtro 3D la caché nueva es la de la modalidad; con filtro se rehace al quitarlo
+    auto active = modalities.find(activeModality);
+    if (active != modalities.end()) {
+        active->second.window = window;
+        active->second.sliceCache = volumeFiltered ? Mat() : sliceCache;
+    }
+    contentVersion++;
+    return true;
+}
+
+/**
+ * @brief Vuelve a la ventana por percentiles del volumen mostrado
+ */
+void Volumetrics::resetIntensityWindow() {
+    if (intensity) {
+        setIntensityWindow(IntensityWindowing::percentileWindow(*intensity));
+    }
+}
+
+/**
+ * @brief Establece el color (BGR) y la opacidad (A) con que se resalta una etiqueta
+ * @param label Valor de la etiqueta en la máscara (0–255)
+ * @param color Color BGRA; alpha 0 la deja sin resaltar
+ */
+void Volumetrics::setLabelColor(int label, const Vec4b &color) {
+    if (label < 0 || label > 255) {
+        return;
+    }
+    labelColors[label] = color;
+    rebuildLabelPalette();
+}
+
+/**
+ * @brief Muestra u oculta una etiqueta en el resaltado de processSlice
+ * @param label Valor de la etiqueta en la máscara (0–255)
+ * @param visible false para no resaltarla
+ */
+void Volumetrics::setLabelVisible(int label, bool visible) {
+    if (label < 0 || label > 255) {
+        return;
+    }
+    labelVisible[label] = visible;
+    rebuildLabelPalette();
+}
+
 /**
  * @brief Establece el nombre de la tecnica de visión artificial
  */
 void Volumetrics::setEffectName(string effectName) {
     this->effectName = effectName;
+    this->effectId = EffectRegistry::idFromName(effectName);
+}
+
+/**
+ * @brief Selecciona el efecto directamente por su id, sin buscar el nombre
+ */
+void Volumetrics::setEffectId(EffectId id) {
+    this->effectId = id;
+    this->effectName = EffectRegistry::get(id).name;
+}
+
+/**
+ * @brief Establece los parámetros del efecto seleccionado
+ */
+void Volumetrics::setEffectParams(const EffectParams &params) {
+    this->effectParams = params;
 }
 
 //* |------------| | Morfologicas | |------------|
 Mat Volumetrics::aplyErosion(Mat sliceProcessed, int kernelSize) {
     // 1.1) Seleccionar la imagen a procesar
-    Mat imageToProcess = sliceProcessed.empty() ? slice.clone() : sliceProcessed.clone();
+    Mat imageToProcess = sliceProcessed.empty() ? slice : sliceProcessed;
 
     // 1.2) Si está vacía, retorno Mat vacía
     if (imageToProcess.empty()) {
@@ -562,7 +1204,7 @@ Mat Volumetrics::aplyErosion(Mat sliceProcessed, int kernelSize) {
  */
 Mat Volumetrics::aplyDilation(Mat sliceProcessed, int kernelSize) {
     // 2.1) Seleccionar la imagen a procesar
-    Mat imageToProcess = sliceProcessed.empty() ? slice.clone() : sliceProcessed.clone();
+    Mat imageToProcess = sliceProcessed.empty() ? slice : sliceProcessed;
 
     // 2.2) Si está vacía, retorno Mat vacía
     if (imageToProcess.empty()) {
@@ -591,7 +1233,7 @@ Mat Volumetrics::aplyDilation(Mat sliceProcessed, int kernelSize) {
  */
 Mat Volumetrics::aplyOpening(Mat sliceProcessed, int kernelSize) {
     // 3.1) Seleccionar la imagen a procesar
-    Mat imageToProcess = sliceProcessed.empty() ? slice.clone() : sliceProcessed.clone();
+    Mat imageToProcess = sliceProcessed.empty() ? slice : sliceProcessed;
 
     // 3.2) Si está vacía, retorno Mat vacía
     if (imageToProcess.empty()) {
@@ -620,7 +1262,7 @@ Mat Volumetrics::aplyOpening(Mat sliceProcessed, int kernelSize) {
  */
 Mat Volumetrics::aplyClosing(Mat sliceProcessed, int kernelSize) {
     // 4.1) Seleccionar la imagen a procesar
-    Mat imageToProcess = sliceProcessed.empty() ? slice.clone() : sliceProcessed.clone();
+    Mat imageToProcess = sliceProcessed.empty() ? slice : sliceProcessed;
 
     // 4.2) Si está vacía, retorno Mat vacía
     if (imageToProcess.empty()) {
@@ -649,7 +1291,7 @@ Mat Volumetrics::aplyClosing(Mat sliceProcessed, int kernelSize) {
  * @brief Aplica ecualización de histograma
  */
 cv::Mat Volumetrics::aplyHistogramEqualization(cv::Mat sliceProcessed) {
-    cv::Mat imageToProcess = sliceProcessed.empty() ? slice.clone() : sliceProcessed.clone();
+    cv::Mat imageToProcess = sliceProcessed.empty() ? slice : sliceProcessed;
 
     if (imageToProcess.empty()) {
         return cv::Mat();
@@ -690,7 +1332,7 @@ cv::Mat Volumetrics::aplyHistogramEqualization(cv::Mat sliceProcessed) {
 //* |------------| | Investigado | |------------|
 Mat Volumetrics::aplyEmbossFilter(Mat sliceProcessed) {
     // 1) Seleccionar la imagen a procesar (si sliceProcessed está vacío, usamos slice)
-    Mat imageToProcess = sliceProcessed.empty() ? slice.clone() : sliceProcessed.clone();
+    Mat imageToProcess = sliceProcessed.empty() ? slice : sliceProcessed;
 
     // 2) Si no hay imagen, devolvemos Mat vacío
     if (imageToProcess.empty()) {
@@ -744,9 +1386,74 @@ size_t Volumetrics::getDepth() const {
     if (!volumetricImage) {
         return 0;
     }
-    auto region3D = volumetricImage->GetLargestPossibleRegion();
-    auto size3D = region3D.GetSize();
-    return size3D[2];
+    return volumetricImage.depth();
+}
+
+/**
+ * @brief Número de cortes a lo largo de un eje (X para sagital, Y para coronal, Z para axial)
+ */
+int Volumetrics::getSliceCount(SliceAxis axis) const {
+    const VolumeImage &image = volumetricImage ? volumetricImage : volumetricImageMask;
+    if (!image) {
+        return 0;
+    }
+    switch (axis) {
+    case SliceAxis::Coronal:
+        return image.height();
+    case SliceAxis::Sagittal:
+        return image.width();
+    case SliceAxis::Axial:
+        break;
+    }
+    return image.depth();
+}
+
+/**
+ * @brief Tamaño del vóxel en mm (X, Y, Z); 1 mm si no hay volumen
+ */
+Vec3d Volumetrics::getSpacing() const {
+    const VolumeImage &image = volumetricImage ? volumetricImage : volumetricImageMask;
+    if (!image) {
+        return Vec3d(1.0, 1.0, 1.0);
+    }
+    auto spacing = image.itkImage()->GetSpacing();
+    return Vec3d(spacing[0], spacing[1], spacing[2]);
+}
+
+/**
+ * @brief Devuelve el nombre de la modalidad activa
+ */
+string Volumetrics::getActiveModality() const {
+    return activeModality;
+}
+
+/**
+ * @brief Indica si una modalidad ya está cargada
+ */
+bool Volumetrics::hasModality(const string &type) const {
+    return modalities.count(type) > 0;
+}
+
+/**
+ * @brief Indica si la máscara ya está cargada
+ */
+bool Volumetrics::hasMask() const {
+    return static_cast<bool>(volumetricImageMask);
+}
+
+/**
+ * @brief Indica si el volumen mostrado tiene aplicado algún filtro 3D
+ */
+bool Volumetrics::hasVolumeFilter() const {
+    return volumeFiltered;
+}
+
+/**
+ * @brief Versión de lo que se muestra: cambia al cambiar de volumen, de máscara, de modalidad,
+ * de filtro 3D o de colores/visibilidad de etiquetas. Sirve para invalidar resultados guardados
+ */
+uint64_t Volumetrics::getContentVersion() const {
+    return contentVersion;
 }
 
 /**
@@ -770,9 +1477,72 @@ string Volumetrics::getEffectName() const {
     return effectName;
 }
 
+/**
+ * @brief Devuelve el id del efecto seleccionado (resuelto en setEffectName)
+ */
+EffectId Volumetrics::getEffectId() const {
+    return effectId;
+}
+
+/**
+ * @brief Devuelve los parámetros del efecto seleccionado
+ */
+const EffectParams &Volumetrics::getEffectParams() const {
+    return effectParams;
+}
+
 /**
  * @brief Devuelve el sliceIndex
  */
 int Volumetrics::getSliceIndex() const {
     return sliceIndex;
+}
+
+/**
+ * @brief Devuelve el color (BGRA) con que se resalta una etiqueta
+ */
+Vec4b Volumetrics::getLabelColor(int label) const {
+    return (label < 0 || label > 255) ? Vec4b() : labelColors[label];
+}
+
+/**
+ * @brief Indica si una etiqueta se resalta en processSlice
+ */
+bool Volumetrics::isLabelVisible(int label) const {
+    return label >= 0 && label <= 255 && labelVisible[label];
+}
+
+/**
+ * @brief Devuelve la ventana de intensidades con que se muestra el volumen
+ */
+IntensityWindow Volumetrics::getIntensityWindow() const {
+    return intensityWindow;
+}
+
+/**
+ * @brief Devuelve el rango completo de intensidades del volumen mostrado (mínimo y máximo)
+ */
+IntensityWindow Volumetrics::getIntensityRange() const {
+    return intensity ? IntensityWindow{intensity->minimum, intensity->maximum} : IntensityWindow();
+}
+
+/**
+ * @brief Indica si la caché 8-bit de slices está activa
+ */
+bool Volumetrics::isSliceCacheEnabled() const {
+    return sliceCacheEnabled;
+}
+
+/**
+ * @brief Indica si se mantienen las cachés sagitales de la vista multiplanar
+ */
+bool Volumetrics::isMultiPlanarEnabled() const {
+    return multiPlanarEnabled;
+}
+
+/**
+ * @brief Indica si se mantienen las copias por bloques del volumen y la máscara
+ */
+bool Volumetrics::isBrickedLayoutEnabled() const {
+    return brickedLayoutEnabled;
 }
\ No newline at end of file
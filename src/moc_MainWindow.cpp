@@ -1,146 +0,0 @@
-/****************************************************************************
-** Meta object code from reading C++ file 'MainWindow.h'
-**
-** Created by: The Qt Meta Object Compiler version 67 (Qt 5.15.13)
-**
-** WARNING! All changes made in this file will be lost!
-*****************************************************************************/
-
-#include <memory>
-#include "../include/MainWindow.h"
-#include <QtCore/qbytearray.h>
-#include <QtCore/qmetatype.h>
-#if !defined(Q_MOC_OUTPUT_REVISION)
-#error "The header file 'MainWindow.h' doesn't include <QObject>."
-#elif Q_MOC_OUTPUT_REVISION != 67
-#error "This file was generated using the moc from 5.15.13. It"
-#error "cannot be used with the include files from this version of Qt."
-#error "(The moc has changed too much.)"
-#endif
-
-QT_BEGIN_MOC_NAMESPACE
-QT_WARNING_PUSH
-QT_WARNING_DISABLE_DEPRECATED
-struct qt_meta_stringdata_MainWindow_t {
-    QByteArrayData data[11];
-    char stringdata0[202];
-};
-#define QT_MOC_LITERAL(idx, ofs, len) \
-    Q_STATIC_BYTE_ARRAY_DATA_HEADER_INITIALIZER_WITH_OFFSET(len, \
-    qptrdiff(offsetof(qt_meta_stringdata_MainWindow_t, stringdata0) + ofs \
-        - idx * sizeof(QByteArrayData)) \
-    )
-static const qt_meta_stringdata_MainWindow_t qt_meta_stringdata_MainWindow = {
-    {
-QT_MOC_LITERAL(0, 0, 10), // "MainWindow"
-QT_MOC_LITERAL(1, 11, 22), // "on_btLoadImage_clicked"
-QT_MOC_LITERAL(2, 34, 0), // ""
-QT_MOC_LITERAL(3, 35, 29), // "on_slSliceNumber_valueChanged"
-QT_MOC_LITERAL(4, 65, 5), // "value"
-QT_MOC_LITERAL(5, 71, 35), // "on_cbAplyEffect_currentIndexC..."
-QT_MOC_LITERAL(6, 107, 5), // "index"
-QT_MOC_LITERAL(7, 113, 30), // "on_chUseImageProcessed_toggled"
-QT_MOC_LITERAL(8, 144, 7), // "checked"
-QT_MOC_LITERAL(9, 152, 22), // "on_btSaveImage_clicked"
-QT_MOC_LITERAL(10, 175, 26) // "on_btGenerateVideo_clicked"
-
-    },
-    "MainWindow\0on_btLoadImage_clicked\0\0"
-    "on_slSliceNumber_valueChanged\0value\0"
-    "on_cbAplyEffect_currentIndexChanged\0"
-    "index\0on_chUseImageProcessed_toggled\0"
-    "checked\0on_btSaveImage_clicked\0"
-    "on_btGenerateVideo_clicked"
-};
-#undef QT_MOC_LITERAL
-
-static const uint qt_meta_data_MainWindow[] = {
-
- // content:
-       8,       // revision
-       0,       // classname
-       0,    0, // classinfo
-       6,   14, // methods
-       0,    0, // properties
-       0,    0, // enums/sets
-       0,    0, // constructors
-       0,       // flags
-       0,       // signalCount
-
- // slots: name, argc, parameters, tag, flags
-       1,    0,   44,    2, 0x08 /* Private */,
-       3,    1,   45,    2, 0x08 /* Private */,
-       5,    1,   48,    2, 0x08 /* Private */,
-       7,    1,   51,    2, 0x08 /* Private */,
-       9,    0,   54,    2, 0x08 /* Private */,
-      10,    0,   55,    2, 0x08 /* Private */,
-
- // slots: parameters
-    QMetaType::Void,
-    QMetaType::Void, QMetaType::Int,    4,
-    QMetaType::Void, QMetaType::Int,    6,
-    QMetaType::Void, QMetaType::Bool,    8,
-    QMetaType::Void,
-    QMetaType::Void,
-
-       0        // eod
-};
-
-void MainWindow::qt_static_metacall(QObject *_o, QMetaObject::Call _c, int _id, void **_a)
-{
-    if (_c == QMetaObject::InvokeMetaMethod) {
-        auto *_t = static_cast<MainWindow *>(_o);
-        (void)_t;
-        switch (_id) {
-        case 0: _t->on_btLoadImage_clicked(); break;
-        case 1: _t->on_slSliceNumber_valueChanged((*reinterpret_cast< int(*)>(_a[1]))); break;
-        case 2: _t->on_cbAplyEffect_currentIndexChanged((*reinterpret_cast< int(*)>(_a[1]))); break;
-        case 3: _t->on_chUseImageProcessed_toggled((*reinterpret_cast< bool(*)>(_a[1]))); break;
-        case 4: _t->on_btSaveImage_clicked(); break;
-        case 5: _t->on_btGenerateVideo_clicked(); break;
-        default: ;
-        }
-    }
-}
-
-QT_INIT_METAOBJECT const QMetaObject MainWindow::staticMetaObject = { {
-    QMetaObject::SuperData::link<QMainWindow::staticMetaObject>(),
-    qt_meta_stringdata_MainWindow.data,
-    qt_meta_data_MainWindow,
-    qt_static_metacall,
-    nullptr,
-    nullptr
-} };
-
-
-const QMetaObject *MainWindow::metaObject() const
-{
-    return QObject::d_ptr->metaObject ? QObject::d_ptr->dynamicMetaObject() : &staticMetaObject;
-}
-
-void *MainWindow::qt_metacast(const char *_clname)
-{
-    if (!_clname) return nullptr;
-    if (!strcmp(_clname, qt_meta_stringdata_MainWindow.stringdata0))
-        return static_cast<void*>(this);
-    return QMainWindow::qt_metacast(_clname);
-}
-
-int MainWindow::qt_metacall(QMetaObject::Call _c, int _id, void **_a)
-{
-    _id = QMainWindow::qt_metacall(_c, _id, _a);
-    if (_id < 0)
-        return _id;
-    if (_c == QMetaObject::InvokeMetaMethod) {
-        if (_id < 6)
-            qt_static_metacall(this, _c, _id, _a);
-        _id -= 6;
-    } else if (_c == QMetaObject::RegisterMethodArgumentMetaType) {
-        if (_id < 6)
-            *reinterpret_cast<int*>(_a[0]) = -1;
-        _id -= 6;
-    }
-    return _id;
-}
-QT_WARNING_POP
-QT_END_MOC_NAMESPACE
@@ -0,0 +1,228 @@
+#include "utils/MultiPlanarView.h"
+#include "utils/Utils.h"
+
+#include <QGridLayout>
+#include <QLabel>
+#include <QMouseEvent>
+#include <QPainter>
+
+#include <algorithm>
+#include <functional>
+
+using namespace cv;
+using namespace std;
+
+/**
+ * @brief Panel de un corte: lo pinta con su proporción real, dibuja la cruz y traduce los
+ * clics a (columna, fila) del corte
+ */
+class PlanePane : public QWidget {
+  public:
+    explicit PlanePane(QWidget *parent = nullptr) : QWidget(parent) {
+        setMinimumSize(160, 160);
+        setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    }
+
+    std::function<void(int, int)> picked; // (columna, fila) del corte
+
+    /**
+     * @param image Corte tal como sale del volumen (fila 0 = primera Y o primera Z)
+     * @param columnSpacing mm por columna
+     * @param rowSpacing mm por fila
+     * @param flipRows true para pintar la última fila arriba (Z hacia arriba)
+     */
+    void setImage(const QImage &image, double columnSpacing, double rowSpacing, bool flipRows) {
+        this->image = flipRows ? image.mirrored(false, true) : image;
+        this->columnSpacing = columnSpacing;
+        this->rowSpacing = rowSpacing;
+        this->flipRows = flipRows;
+        update();
+    }
+
+    void setCross(int column, int row) {
+        crossColumn = column;
+        crossRow = row;
+        update();
+    }
+
+    void clear() {
+        image = QImage();
+        update();
+    }
+
+  protected:
+    void paintEvent(QPaintEvent *) override {
+        QPainter painter(this);
+        painter.fillRect(rect(), Qt::black);
+        if (image.isNull()) {
+            return;
+        }
+
+        QRectF target = imageRect();
+        painter.setRenderHint(QPainter::SmoothPixmapTransform);
+        painter.drawImage(target, image);
+
+        // Cruz en el centro del vóxel
+        double x = target.left() + (crossColumn + 0.5) * target.width() / image.width();
+        double y = target.top() + (displayRow(crossRow) + 0.5) * target.height() / image.height();
+        painter.setPen(QPen(QColor(255, 200, 0, 180), 1));
+        painter.drawLine(QPointF(x, target.top()), QPointF(x, target.bottom()));
+        painter.drawLine(QPointF(target.left(), y), QPointF(target.right(), y));
+    }
+
+    void mousePressEvent(QMouseEvent *event) override { pickAt(event); }
+
+    void mouseMoveEvent(QMouseEvent *event) override {
+        if (event->buttons() & Qt::LeftButton) {
+            pickAt(event);
+        }
+    }
+
+  private:
+    // Rectángulo donde cabe el corte sin deformar (proporción en mm, no en vóxeles)
+    QRectF imageRect() const {
+        double physicalWidth = image.width() * columnSpacing;
+        double physicalHeight = image.height() * rowSpacing;
+        double scale = min(width() / physicalWidth, height() / physicalHeight);
+        QSizeF fitted(physicalWidth * scale, physicalHeight * scale);
+        return QRectF(QPointF((width() - fitted.width()) / 2, (height() - fitted.height()) / 2), fitted);
+    }
+
+    int displayRow(int row) const { return flipRows ? image.height() - 1 - row : row; }
+
+    void pickAt(QMouseEvent *event) {
+        if (image.isNull() || !picked) {
+            return;
+        }
+        QRectF target = imageRect();
+        int column = static_cast<int>((event->pos().x() - target.left()) * image.width() / target.width());
+        int row = static_cast<int>((event->pos().y() - target.top()) * image.height() / target.height());
+        column = max(0, min(image.width() - 1, column));
+        row = displayRow(max(0, min(image.height() - 1, row)));
+        picked(column, row);
+    }
+
+    QImage image;
+    double columnSpacing = 1.0;
+    double rowSpacing = 1.0;
+    bool flipRows = false;
+    int crossColumn = 0;
+    int crossRow = 0;
+};
+
+MultiPlanarView::MultiPlanarView(QWidget *parent) : QWidget(parent) {
+    QGridLayout *layout = new QGridLayout(this);
+    const SliceAxis axes[] = {SliceAxis::Axial, SliceAxis::Coronal, SliceAxis::Sagittal};
+    for (SliceAxis axis : axes) {
+        int i = static_cast<int>(axis);
+        titles[i] = new QLabel;
+        titles[i]->setAlignment(Qt::AlignCenter);
+        panes[i] = new PlanePane;
+        panes[i]->picked = [this, axis](int column, int row) { pick(axis, column, row); };
+        layout->addWidget(titles[i], 0, i);
+        layout->addWidget(panes[i], 1, i);
+    }
+    updateTitles();
+}
+
+/**
+ * @brief Dimensiones y tamaño de vóxel del volumen; la cruz pasa al centro
+ */
+void MultiPlanarView::setVolumeSize(int width, int height, int depth, const Vec3d &spacing) {
+    size = Vec3i(width, height, depth);
+    this->spacing = spacing;
+    setCrosshair(width / 2, height / 2, depth / 2);
+}
+
+/**
+ * @brief Mueve la cruz (ajustada al volumen) sin emitir crosshairMoved()
+ * @details No cambia las imágenes: hay que pasar los nuevos cortes con setPlane()
+ */
+void MultiPlanarView::setCrosshair(int x, int y, int z) {
+    cross = Vec3i(max(0, min(size[0] - 1, x)), max(0, min(size[1] - 1, y)), max(0, min(size[2] - 1, z)));
+    panes[static_cast<int>(SliceAxis::Axial)]->setCross(cross[0], cross[1]);
+    panes[static_cast<int>(SliceAxis::Coronal)]->setCross(cross[0], cross[2]);
+    panes[static_cast<int>(SliceAxis::Sagittal)]->setCross(cross[1], cross[2]);
+    updateTitles();
+}
+
+/**
+ * @brief Muestra un corte (gris o BGR, como lo devuelve Volumetrics::getSliceAsMat)
+ * @details La QImage envuelve el Mat sin copiarlo; coronal y sagital se invierten al pintar
+ */
+void MultiPlanarView::setPlane(SliceAxis axis, const Mat &plane) {
+    PlanePane *pane = panes[static_cast<int>(axis)];
+    QImage image = plane.empty() ? QImage() : Utils::matToQImage(plane);
+    switch (axis) {
+    case SliceAxis::Axial:
+        pane->setImage(image, spacing[0], spacing[1], false);
+        break;
+    case SliceAxis::Coronal:
+        pane->setImage(image, spacing[0], spacing[2], true);
+        break;
+    case SliceAxis::Sagittal:
+        pane->setImage(image, spacing[1], spacing[2], true);
+        break;
+    }
+}
+
+/**
+ * @brief Vacía los tres paneles (p. ej. al cambiar de paciente)
+ */
+void MultiPlanarView::clear() {
+    for (PlanePane *pane : panes) {
+        pane->clear();
+    }
+    size = Vec3i(0, 0, 0);
+    cross = Vec3i(0, 0, 0);
+    updateTitles();
+}
+
+/**
+ * @brief Posición de la cruz (x, y, z)
+ */
+Vec3i MultiPlanarView::crosshair() const {
+    return cross;
+}
+
+/**
+ * @brief Índice del corte que se muestra en un eje (z para axial, y para coronal, x para sagital)
+ */
+int MultiPlanarView::indexOf(SliceAxis axis) const {
+    switch (axis) {
+    case SliceAxis::Coronal:
+        return cross[1];
+    case SliceAxis::Sagittal:
+        return cross[0];
+    case SliceAxis::Axial:
+        break;
+    }
+    return cross[2];
+}
+
+/**
+ * @brief Clic en un panel: mueve la cruz en sus dos ejes y avisa
+ */
+void MultiPlanarView::pick(SliceAxis axis, int column, int row) {
+    Vec3i previous = cross;
+    switch (axis) {
+    case SliceAxis::Axial:
+        setCrosshair(column, row, cross[2]);
+        break;
+    case SliceAxis::Coronal:
+        setCrosshair(column, cross[1], row);
+        break;
+    case SliceAxis::Sagittal:
+        setCrosshair(cross[0], column, row);
+        break;
+    }
+    if (cross != previous) {
+        emit crosshairMoved(cross[0], cross[1], cross[2]);
+    }
+}
+
+void MultiPlanarView::updateTitles() {
+    titles[static_cast<int>(SliceAxis::Axial)]->setText(QString("Axial (Z = %1)").arg(cross[2]));
+    titles[static_cast<int>(SliceAxis::Coronal)]->setText(QString("Coronal (Y = %1)").arg(cross[1]));
+    titles[static_cast<int>(SliceAxis::Sagittal)]->setText(QString("Sagital (X = %1)").arg(cross[0]));
+}
@@ -0,0 +1,112 @@
+#include "utils/RenderWorker.h"
+#include "helpers/Trace.h"
+#include "utils/Utils.h"
+
+using namespace cv;
+using namespace std;
+
+RenderWorker::RenderWorker(SliceResultCache &cache, QObject *parent)
+    : QObject(parent), cache(cache), worker(&RenderWorker::workerLoop, this) {}
+
+RenderWorker::~RenderWorker() {
+    {
+        lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        hasPending = false;
+    }
+    wake.notify_all();
+    worker.join();
+}
+
+/**
+ * @brief Pide renderizar un slice (llamar desde la interfaz); reemplaza la petición pendiente
+ * @param volumetrics Estado actual; se copia solo si cambió lo que se muestra
+ * @param request Slice, efecto y tamaño de los labels
+ */
+void RenderWorker::render(const Volumetrics &volumetrics, const RenderRequest &request) {
+    snapshot.publish(volumetrics);
+    {
+        lock_guard<std::mutex> lock(mutex);
+        pending = request;
+        hasPending = true;
+    }
+    wake.notify_one();
+}
+
+/**
+ * @brief Recoge el último frame renderizado (llamar desde la interfaz, tras frameReady)
+ * @return false si no hay ninguno nuevo
+ */
+bool RenderWorker::takeFrame(RenderedFrame &frame) {
+    lock_guard<std::mutex> lock(mutex);
+    if (!hasLatest) {
+        return false;
+    }
+    frame = latest;
+    latest = RenderedFrame();
+    hasLatest = false;
+    return true;
+}
+
+bool RenderWorker::hasPendingRequest() {
+    lock_guard<std::mutex> lock(mutex);
+    return hasPending;
+}
+
+/**
+ * @brief Hilo de render: atiende siempre la petición más reciente
+ */
+void RenderWorker::workerLoop() {
+    SliceRenderer renderer;
+
+    while (true) {
+        RenderRequest request;
+        {
+            unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || hasPending; });
+            if (stopping) {
+                return;
+            }
+            request = pending;
+            hasPending = false;
+        }
+        renderer.sync(snapshot);
+
+        TRACE_SCOPE("RenderWorker::frame");
+        const SliceResultKey &key = request.key;
+        RenderedFrame frame;
+        frame.key = key;
+        frame.withProcessed = request.withProcessed;
+
+        Mat original = renderer.extract(key.sliceIndex);
+
+        // Resaltado + efecto: si ya se vio (o el prefetcher lo preparó) sale de la caché
+        if (request.withProcessed && !cache.find(key, frame.processed)) {
+            frame.processed = renderer.process(key);
+            cache.insert(key, frame.processed);
+        }
+
+        // Si mientras tanto se pidió otro slice, este ya no se va a ver: no convertirlo
+        if (hasPendingRequest()) {
+            continue;
+        }
+
+        if (scaledSlice != key.sliceIndex || scaledVersion != key.contentVersion || scaledSize != request.originalSize) {
+            scaledOriginal = Utils::matToQImage(original, request.originalSize);
+            scaledSlice = key.sliceIndex;
+            scaledVersion = key.contentVersion;
+            scaledSize = request.originalSize;
+        }
+        frame.originalImage = scaledOriginal;
+        if (request.withProcessed) {
+            frame.processedImage = Utils::matToQImage(frame.processed, request.processedSize);
+        }
+
+        {
+            lock_guard<std::mutex> lock(mutex);
+            latest = frame;
+            hasLatest = true;
+        }
+        emit frameReady();
+    }
+}
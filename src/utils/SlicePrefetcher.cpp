@@ -0,0 +1,167 @@
+#include "utils/SlicePrefetcher.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+constexpr size_t historySize = 4; // Movimientos del slider que cuentan para la dirección
+constexpr int maxStep = 4;        // Paso máximo estimado al arrastrar rápido
+
+} // namespace
+
+SlicePrefetcher::SlicePrefetcher(QObject *parent) : QObject(parent), worker(&SlicePrefetcher::workerLoop, this) {}
+
+SlicePrefetcher::~SlicePrefetcher() {
+    {
+        lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        jobs.clear();
+    }
+    wake.notify_all();
+    worker.join();
+}
+
+/**
+ * @brief Encola los vecinos del slice que se acaba de mostrar (llamar desde la interfaz)
+ * @param volumetrics Estado actual; se copia solo si cambió lo que se muestra
+ * @param current Clave del slice mostrado (efecto, parámetros y resaltado se mantienen)
+ * @param cache Caché de la interfaz: los slices que ya están no se encolan
+ */
+void SlicePrefetcher::request(const Volumetrics &volumetrics, const SliceResultKey &current, const SliceResultCache &cache) {
+    int depth = static_cast<int>(volumetrics.getDepth());
+    if (depth == 0 || (current.overlay && !volumetrics.hasMask())) {
+        cancel();
+        return;
+    }
+
+    vector<SliceResultKey> pending;
+    for (int index : predictTargets(current.sliceIndex, depth)) {
+        SliceResultKey key = current;
+        key.sliceIndex = index;
+        if (!cache.contains(key)) {
+            pending.push_back(key);
+        }
+    }
+
+    snapshot.publish(volumetrics);
+    {
+        lock_guard<std::mutex> lock(mutex);
+        jobs.assign(pending.begin(), pending.end());
+    }
+    wake.notify_one();
+}
+
+/**
+ * @brief Descarta los slices pendientes (el que se esté procesando termina igual)
+ */
+void SlicePrefetcher::cancel() {
+    lock_guard<std::mutex> lock(mutex);
+    jobs.clear();
+}
+
+/**
+ * @brief Recoge los slices ya procesados (llamar desde la interfaz, tras slicesReady)
+ */
+vector<PrefetchedSlice> SlicePrefetcher::takeResults() {
+    lock_guard<std::mutex> lock(mutex);
+    vector<PrefetchedSlice> ready;
+    ready.swap(results);
+    return ready;
+}
+
+/**
+ * @brief Cuántos slices procesar por delante (en la dirección del recorrido) y por detrás
+ */
+void SlicePrefetcher::setLookahead(int ahead, int behind) {
+    this->ahead = max(0, ahead);
+    this->behind = max(0, behind);
+}
+
+/**
+ * @brief Slices a procesar, del más al menos probable
+ * @details La dirección es el signo de la suma de los últimos movimientos y el paso su
+ * tamaño medio (arrastrar rápido salta slices). Un salto largo reinicia el historial; sin
+ * dirección clara se alternan ambos lados
+ */
+vector<int> SlicePrefetcher::predictTargets(int sliceIndex, int depth) {
+    if (lastIndex >= 0 && sliceIndex != lastIndex) {
+        int delta = sliceIndex - lastIndex;
+        if (abs(delta) > maxStep * max(1, ahead)) {
+            recentDeltas.clear();
+        } else {
+            recentDeltas.push_back(delta);
+            if (recentDeltas.size() > historySize) {
+                recentDeltas.pop_front();
+            }
+        }
+    }
+    lastIndex = sliceIndex;
+
+    int sum = 0;
+    int magnitude = 0;
+    for (int delta : recentDeltas) {
+        sum += delta;
+        magnitude += abs(delta);
+    }
+    int direction = (sum > 0) - (sum < 0);
+    int step = recentDeltas.empty() ? 1 : clamp(static_cast<int>(lround(double(magnitude) / recentDeltas.size())), 1, maxStep);
+
+    vector<int> targets;
+    auto add = [&](int index) {
+        if (index >= 0 && index < depth && index != sliceIndex && find(targets.begin(), targets.end(), index) == targets.end()) {
+            targets.push_back(index);
+        }
+    };
+
+    if (direction == 0) {
+        for (int i = 1; i <= max(ahead, behind); i++) {
+            add(sliceIndex + i);
+            add(sliceIndex - i);
+        }
+    } else {
+        for (int i = 1; i <= ahead; i++) {
+            add(sliceIndex + direction * step * i);
+        }
+        for (int i = 1; i <= behind; i++) {
+            add(sliceIndex - direction * i);
+        }
+    }
+    return targets;
+}
+
+/**
+ * @brief Hilo de trabajo: procesa los slices encolados de uno en uno
+ */
+void SlicePrefetcher::workerLoop() {
+    SliceRenderer renderer;
+
+    while (true) {
+        SliceResultKey key;
+        {
+            unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || !jobs.empty(); });
+            if (stopping) {
+                return;
+            }
+            key = jobs.front();
+            jobs.pop_front();
+        }
+
+        renderer.sync(snapshot);
+        Mat result = renderer.process(key);
+        if (result.empty()) {
+            continue;
+        }
+
+        {
+            lock_guard<std::mutex> lock(mutex);
+            results.push_back(PrefetchedSlice{key, result});
+        }
+        emit slicesReady();
+    }
+}
@@ -1,6 +1,12 @@
 #include <MainWindow.h>
+#include "helpers/EffectRegistry.h"
+#include "helpers/IntensityStatistics.h"
+#include "helpers/Trace.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream> // solo si quieres imprimir mensajes de error
 #include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
 #include <opencv2/imgproc.hpp>
 
 using namespace cv;
@@ -19,234 +25,128 @@ bool isChecked(Ui::MainWindow *ui) {
  * @brief Aplica el efecto seleccionado a la imagen
  * @param volumetrics Objeto Volumetrics
  * @param processedSlice Imagen a la que se le va a aplicar el efecto
- * @param effectName Nombre del efecto - "Threshold", "ContrastStretch", "UmbralBinary", "BitwiseAND", "BitwiseOR", "BitwiseXOR"
- * @return Imagen con el efecto
+ * @param effectId Efecto resuelto al cambiar la selección del combo
+ * @return Imagen con el efecto (con los parámetros guardados en volumetrics)
  */
-Mat aplyFilter(Volumetrics volumetrics, Mat processedSlice, std::string effectName) {
-
-    if (effectName == "Threshold") {
-        processedSlice = volumetrics.aplyThreshold(processedSlice, 55.0);
-        return processedSlice;
-    }
-
-    if (effectName == "ContrastStretch") {
-        processedSlice = volumetrics.aplyContratstStreching(processedSlice);
-        return processedSlice;
-    }
-
-    if (effectName == "UmbralBinary") {
-        processedSlice = volumetrics.aplyUmbralBinary();
-        return processedSlice;
-    }
-    if (effectName == "BitwiseAND") {
-        processedSlice = volumetrics.aplyBitWiseOperation(processedSlice, "AND");
-        return processedSlice;
-    }
-
-    if (effectName == "BitwiseOR") {
-        processedSlice = volumetrics.aplyBitWiseOperation(processedSlice, "OR");
-        return processedSlice;
-    }
-
-    if (effectName == "BitwiseXOR") {
-        processedSlice = volumetrics.aplyBitWiseOperation(processedSlice, "XOR");
-        return processedSlice;
-    }
-
-    if (effectName == "Canny") {
-        processedSlice = volumetrics.aplyCanny(processedSlice);
-        return processedSlice;
-    }
-
-    if (effectName == "Brightness") {
-        processedSlice = volumetrics.adjustBrightness(processedSlice);
-        return processedSlice;
-    }
-
-    if (effectName == "MeanFilter") {
-        // Usa tamaño de kernel por defecto = 5
-        processedSlice = volumetrics.aplyMeanFilter(processedSlice);
-        return processedSlice;
-    }
-
-    if (effectName == "GaussianFilter") {
-        // Usa kernelSize=5, sigmaX=1.0 por defecto
-        processedSlice = volumetrics.aplyGaussianFilter(processedSlice);
-        return processedSlice;
-    }
-
-    if (effectName == "MedianFilter") {
-        // Usa kernelSize por defecto = 5
-        processedSlice = volumetrics.aplyMedianFilter(processedSlice);
-        return processedSlice;
-    }
-
-    if (effectName == "BilateralFilter") {
-        // Usa diameter=9, sigmaColor=75.0, sigmaSpace=75.0 por defecto
-        processedSlice = volumetrics.aplyBilateralFilter(processedSlice);
-        return processedSlice;
-    }
-
-    if (effectName == "Erosion") {
-        processedSlice = volumetrics.aplyErosion(processedSlice, 3);
-        return processedSlice;
-    }
+Mat aplyFilter(Volumetrics &volumetrics, const Mat &processedSlice, EffectId effectId) {
+    return EffectRegistry::apply(effectId, volumetrics, processedSlice, volumetrics.getEffectParams());
+}
 
-    if (effectName == "Dilation") {
-        processedSlice = volumetrics.aplyDilation(processedSlice, 3);
-        return processedSlice;
-    }
+/**
+ * @brief Libera la referencia al Mat que sostiene los píxeles de un QImage
+ */
+static void releaseMat(void *info) {
+    delete static_cast<Mat *>(info);
+}
 
-    if (effectName == "Opening") {
-        processedSlice = volumetrics.aplyOpening(processedSlice, 3);
-        return processedSlice;
+/**
+ * @brief Envuelve un Mat (CV_8UC1 o CV_8UC3) en un QImage sin copiar, escalado si se indica tamaño
+ * @details El QImage apunta a los píxeles del Mat y se queda con una referencia: vale aunque el
+ * Mat original se libere, y como los datos son de solo lectura Qt copia si alguien lo pinta.
+ * El BGR de OpenCV se usa tal cual (Format_BGR888); el escalado se hace con cv::resize, que
+ * es la única copia. No usa nada del hilo de la interfaz (a diferencia de QPixmap), así que
+ * puede llamarse desde el hilo de render
+ * @param mat Imagen en grises o BGR
+ * @param size Tamaño donde debe caber conservando la proporción; vacío = tamaño original
+ * @return QImage nula si el tipo no es soportado
+ */
+QImage matToQImage(const Mat &mat, const QSize &size) {
+    TRACE_SCOPE("Utils::matToQImage");
+    QImage::Format format;
+    if (mat.type() == CV_8UC1) {
+        format = QImage::Format_Grayscale8;
+    } else if (mat.type() == CV_8UC3) {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+        format = QImage::Format_BGR888;
+#else
+        format = QImage::Format_RGB888;
+#endif
+    } else {
+        return QImage();
     }
 
-    if (effectName == "Closing") {
-        processedSlice = volumetrics.aplyClosing(processedSlice, 3);
-        return processedSlice;
+    Mat pixels = mat;
+    if (!size.isEmpty()) {
+        double scale = min(size.width() / double(mat.cols), size.height() / double(mat.rows));
+        Size fitted(max(1, static_cast<int>(lround(mat.cols * scale))), max(1, static_cast<int>(lround(mat.rows * scale))));
+        if (fitted != mat.size()) {
+            TRACE_SCOPE("Utils::matToQImage/resize");
+            resize(mat, pixels, fitted, 0, 0, scale < 1.0 ? INTER_AREA : INTER_LINEAR);
+        }
     }
-
-    if (effectName == "HistogramEqualization") {
-        processedSlice = volumetrics.aplyHistogramEqualization(processedSlice);
-        return processedSlice;
+#if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
+    if (format == QImage::Format_RGB888) {
+        Mat rgb;
+        cvtColor(pixels, rgb, COLOR_BGR2RGB);
+        pixels = rgb;
     }
+#endif
 
-    if (effectName == "Emboss") {
-        processedSlice = volumetrics.aplyEmbossFilter(processedSlice);
-        return processedSlice;
-    }
+    Mat *owner = new Mat(pixels);
+    return QImage(static_cast<const uchar *>(owner->data), owner->cols, owner->rows, static_cast<int>(owner->step), format,
+                  releaseMat, owner);
+}
 
-    return processedSlice;
+/**
+ * @brief Muestra una imagen BGR de OpenCV en un QLabel
+ */
+static QLabel *imageLabel(const Mat &bgr) {
+    QLabel *lbl = new QLabel;
+    lbl->setAlignment(Qt::AlignCenter);
+    lbl->setPixmap(QPixmap::fromImage(matToQImage(bgr)));
+    return lbl;
 }
 
+/**
+ * @brief Calcula los estadísticos del slice dentro de la máscara, los guarda y los muestra
+ * @details Todo sale de un histograma de 256 bins calculado en una pasada; los gráficos se
+ * dibujan con OpenCV y se guardan en outputFolder con los mismos nombres que antes
+ * @param volumetrics Objeto Volumetrics (de él se toma la máscara del slice actual)
+ * @param slice Slice guardado (gris o BGR)
+ * @param outputFolder Carpeta donde se escriben reporte y gráficos
+ * @param parent Ventana padre del diálogo
+ * @return false si no hay máscara o no cubre ningún píxel
+ */
 bool generateStatistics(Volumetrics &volumetrics, const cv::Mat &slice, const QString &outputFolder, QWidget *parent) {
-    // 1) Obtener la máscara desde volumetrics
-    cv::Mat mask = volumetrics.getSliceMaskAsMat();
-    if (mask.empty()) {
-        // No hay máscara → fallamos
+    // 1) Estadísticos a partir del histograma enmascarado
+    IntensityStats stats;
+    if (!IntensityStatistics::computeMasked(slice, volumetrics.getSliceMaskAsMat(), stats)) {
         return false;
     }
 
-    // 2) Convertir 'slice' a escala de grises si viene en color
-    cv::Mat graySlice;
-    if (slice.channels() == 3) {
-        cv::cvtColor(slice, graySlice, COLOR_BGR2GRAY);
-    } else {
-        graySlice = slice;
-    }
+    std::string reporte = IntensityStatistics::report(stats);
+    Mat boxplot = IntensityStatistics::drawBoxplot(stats);
+    Mat histograma = IntensityStatistics::drawHistogram(stats);
+    Mat basicos = IntensityStatistics::drawSummary(stats);
 
-    // 3) Recopilar valores de píxel dentro de la máscara
-    std::vector<int> valores;
-    valores.reserve(graySlice.rows * graySlice.cols);
-    for (int y = 0; y < mask.rows; ++y) {
-        const uchar *ptrMask = mask.ptr<uchar>(y);
-        const uchar *ptrGray = graySlice.ptr<uchar>(y);
-        for (int x = 0; x < mask.cols; ++x) {
-            if (ptrMask[x] > 0) {
-                valores.push_back(static_cast<int>(ptrGray[x]));
-            }
-        }
-    }
-    if (valores.empty()) {
-        // La máscara cubre cero píxeles
-        return false;
-    }
-
-    // 4) Guardar valores en CSV en ./tmp/valores.csv
-    QString tmpDir = QCoreApplication::applicationDirPath() + "/tmp";
-    QDir().mkpath(tmpDir); // crea tmp/ si no existe
-
-    QString csvPath = tmpDir + "/valores.csv";
+    // 2) Guardar reporte y gráficos en la carpeta de salida
+    QDir folder(outputFolder);
     {
-        QFile file(csvPath);
-        if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-            return false;
-        }
-        QTextStream out(&file);
-        for (int v : valores) {
-            out << v << "\n";
+        QFile file(folder.filePath("reporte_estadisticas.txt"));
+        if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            file.write(reporte.data(), static_cast<qint64>(reporte.size()));
+        } else {
+            cerr << "generateStatistics: no se pudo escribir " << file.fileName().toStdString() << "\n";
         }
-        file.close();
     }
+    imwrite(folder.filePath("boxplot.png").toStdString(), boxplot);
+    imwrite(folder.filePath("histograma.png").toStdString(), histograma);
+    imwrite(folder.filePath("estadisticos_basicos.png").toStdString(), basicos);
 
-    // 5) Invocar el script Python (scripts/main.py) con python3
-    QString scriptPython = "python3";
-    QString scriptFile = QCoreApplication::applicationDirPath() + "/scripts/main.py";
-    QStringList argumentos;
-    argumentos << scriptFile << csvPath << outputFolder;
-
-    QProcess process;
-    process.start(scriptPython, argumentos);
-    bool terminó = process.waitForFinished(10000); // 10 s de timeout
-    if (!terminó || process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
-        QString err = process.readAllStandardError();
-        qDebug() << "Error Python:" << err;
-        return false;
-    }
-
-    // 6) Preparar rutas a los archivos generados por Python
-    QString boxplotPath = outputFolder + "/boxplot.png";
-    QString histoPath = outputFolder + "/histograma.png";
-    QString barrasPath = outputFolder + "/estadisticos_basicos.png";
-    QString reportePath = outputFolder + "/reporte_estadisticas.txt";
-
-    // 7) Mostrar un QDialog modal con pestañas para cada gráfico y el reporte
+    // 3) Mostrar un QDialog modal con pestañas para cada gráfico y el reporte (desde memoria)
     QDialog dlg(parent);
     dlg.setWindowTitle("Resultados Estadísticos");
 
     QTabWidget *tabs = new QTabWidget(&dlg);
 
-    // 7a) Pestaña “Reporte” (texto)
-    {
-        QTextEdit *txt = new QTextEdit;
-        txt->setReadOnly(true);
-        QFile ftxt(reportePath);
-        if (ftxt.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            QString contenido = ftxt.readAll();
-            txt->setPlainText(contenido);
-            ftxt.close();
-        } else {
-            txt->setPlainText("No se encontró reporte de texto.");
-        }
-        tabs->addTab(txt, "Reporte");
-    }
-
-    // 7b) Pestaña “Boxplot”
-    {
-        QLabel *lbl = new QLabel;
-        if (QFile::exists(boxplotPath)) {
-            QPixmap pix(boxplotPath);
-            lbl->setPixmap(pix.scaled(600, 400, Qt::KeepAspectRatio, Qt::SmoothTransformation));
-        } else {
-            lbl->setText("No se encontró boxplot.png");
-        }
-        tabs->addTab(lbl, "Boxplot");
-    }
+    QTextEdit *txt = new QTextEdit;
+    txt->setReadOnly(true);
+    txt->setPlainText(QString::fromStdString(reporte));
+    tabs->addTab(txt, "Reporte");
 
-    // 7c) Pestaña “Histograma”
-    {
-        QLabel *lbl = new QLabel;
-        if (QFile::exists(histoPath)) {
-            QPixmap pix(histoPath);
-            lbl->setPixmap(pix.scaled(600, 400, Qt::KeepAspectRatio, Qt::SmoothTransformation));
-        } else {
-            lbl->setText("No se encontró histograma.png");
-        }
-        tabs->addTab(lbl, "Histograma");
-    }
-
-    // 7d) Pestaña “Básicos”
-    {
-        QLabel *lbl = new QLabel;
-        if (QFile::exists(barrasPath)) {
-            QPixmap pix(barrasPath);
-            lbl->setPixmap(pix.scaled(600, 400, Qt::KeepAspectRatio, Qt::SmoothTransformation));
-        } else {
-            lbl->setText("No se encontró estadisticos_basicos.png");
-        }
-        tabs->addTab(lbl, "Básicos");
-    }
+    tabs->addTab(imageLabel(boxplot), "Boxplot");
+    tabs->addTab(imageLabel(histograma), "Histograma");
+    tabs->addTab(imageLabel(basicos), "Básicos");
 
     // Botón “Cerrar” y layout
     QVBoxLayout *layout = new QVBoxLayout;
@@ -257,9 +157,9 @@ bool generateStatistics(Volumetrics &volumetrics, const cv::Mat &slice, const QS
     layout->addWidget(botonCerrar);
 
     dlg.setLayout(layout);
-    dlg.resize(640, 480);
+    dlg.resize(640, 680);
     dlg.exec();
 
     return true;
 }
-} // namespace Utils
\ No newline at end of file
+} // namespace Utils
@@ -0,0 +1,205 @@
+#include "utils/VideoExporter.h"
+#include "helpers/EffectPipeline.h"
+
+#include <algorithm>
+#include <opencv2/imgproc.hpp>
+
+using namespace cv;
+using namespace std;
+
+VideoExporter::VideoExporter(QObject *parent) : QObject(parent) {}
+
+VideoExporter::~VideoExporter() {
+    cancel();
+    join();
+}
+
+/**
+ * @brief Lanza la exportación en segundo plano
+ * @param job Parámetros de la exportación (rango de slices, efecto, salida)
+ * @param numWorkers Hilos de procesamiento; 0 usa todos los núcleos disponibles
+ * @return false si ya hay una exportación en curso o el rango está vacío
+ */
+bool VideoExporter::start(const VideoExportJob &job, int numWorkers) {
+    if (running) {
+        return false;
+    }
+    join(); // Recoger los hilos de una exportación anterior ya terminada
+
+    if (job.endSlice < job.beginSlice) {
+        return false;
+    }
+
+    if (numWorkers <= 0) {
+        numWorkers = max(1, static_cast<int>(thread::hardware_concurrency()));
+    }
+
+    this->job = job;
+    totalFrames = job.endSlice - job.beginSlice + 1;
+    numWorkers = min(numWorkers, totalFrames);
+    // Ventana de reordenamiento: limita cuántos frames pueden esperar al codificador. Los huecos
+    // conservan su memoria de una exportación a otra
+    reorderWindow = 2 * numWorkers;
+    framePool.resize(reorderWindow);
+    for (FrameSlot &slot : framePool) {
+        slot.position = -1;
+    }
+
+    nextToRender = 0;
+    nextToWrite = 0;
+    cancelled = false;
+    running = true;
+
+    for (int i = 0; i < numWorkers; i++) {
+        workers.emplace_back(&VideoExporter::workerLoop, this);
+    }
+    encoder = thread(&VideoExporter::encoderLoop, this);
+    return true;
+}
+
+/**
+ * @brief Solicita detener la exportación en curso (los hilos terminan en el siguiente frame)
+ */
+void VideoExporter::cancel() {
+    cancelled = true;
+    frameReady.notify_all();
+    slotReleased.notify_all();
+}
+
+/**
+ * @brief Indica si hay una exportación en curso
+ */
+bool VideoExporter::isRunning() const {
+    return running;
+}
+
+/**
+ * @brief Espera al hilo codificador (que a su vez recoge a los workers)
+ */
+void VideoExporter::join() {
+    if (encoder.joinable()) {
+        encoder.join();
+    }
+}
+
+/**
+ * @brief Hilo de procesamiento: reclama posiciones en orden, extrae y filtra el slice
+ * y lo deja en BGR en su hueco del pool
+ */
+void VideoExporter::workerLoop() {
+    // Copia propia: setSliceAsMat/processSlice modifican el estado del objeto
+    Volumetrics volumetrics = job.volumetrics;
+
+    // Resaltado + efecto sobre buffers propios del hilo, reutilizados entre frames
+    EffectPipeline pipeline;
+    if (job.useImageProcessed) {
+        pipeline.addOverlay();
+    }
+    pipeline.addEffect(job.effectId);
+    pipeline.setParams(volumetrics.getEffectParams());
+
+    while (!cancelled) {
+        int position = nextToRender.fetch_add(1);
+        if (position >= totalFrames) {
+            break;
+        }
+
+        // No adelantarse demasiado al codificador: el hueco queda libre cuando ya escribió
+        // la posición que lo ocupaba antes
+        {
+            unique_lock<std::mutex> lock(mutex);
+            slotReleased.wait(lock, [&] { return cancelled || position < nextToWrite + reorderWindow; });
+            if (cancelled) {
+                break;
+            }
+        }
+        FrameSlot &slot = framePool[position % reorderWindow];
+
+        volumetrics.setSliceIndex(job.beginSlice + position);
+        volumetrics.setSliceAsMat();
+        volumetrics.setSliceMaskAsMat();
+
+        Mat slice = volumetrics.getSliceAsMat();
+        const Mat &sliceOut = pipeline.run(volumetrics, slice);
+
+        // Al hueco, que ya tiene el tamaño de los frames anteriores (cvtColor y copyTo no
+        // reservan). En BGR para el video, en grises para la secuencia de PNG
+        slot.blank = sliceOut.empty();
+        if (!slot.blank && sliceOut.channels() == 1 && !job.format.imageSequence) {
+            cvtColor(sliceOut, slot.frame, COLOR_GRAY2BGR);
+        } else if (!slot.blank) {
+            sliceOut.copyTo(slot.frame);
+        }
+
+        {
+            lock_guard<std::mutex> lock(mutex);
+            slot.position = position;
+        }
+        frameReady.notify_one();
+    }
+}
+
+/**
+ * @brief Hilo codificador: escribe los frames en orden y reporta el progreso
+ * @details Escribe directamente desde el hueco del pool y lo libera después, así que el frame
+ * nunca se copia entre el worker y el FrameSink
+ */
+void VideoExporter::encoderLoop() {
+    FrameSink sink(job.format, job.fps, job.outputPath);
+    int written = 0;
+    bool ok = true;
+    QString message;
+
+    while (true) {
+        FrameSlot *slot = nullptr;
+        {
+            unique_lock<std::mutex> lock(mutex);
+            if (nextToWrite >= totalFrames) {
+                break;
+            }
+            slot = &framePool[nextToWrite % reorderWindow];
+            frameReady.wait(lock, [&] { return cancelled || slot->position == nextToWrite; });
+            if (cancelled) {
+                break;
+            }
+        }
+
+        // El primer frame válido fija el tamaño del video
+        string error;
+        if (!slot->blank && !sink.write(slot->frame, job.beginSlice + nextToWrite, error)) {
+            ok = false;
+            message = QString::fromStdString(error);
+            cancel();
+            break;
+        }
+
+        {
+            lock_guard<std::mutex> lock(mutex);
+            slot->position = -1;
+            nextToWrite++;
+        }
+        slotReleased.notify_all();
+
+        written++;
+        emit progress(written, totalFrames);
+    }
+
+    for (thread &worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    sink.close();
+
+    if (ok && cancelled) {
+        ok = false;
+        message = "Generación de video cancelada.";
+    } else if (ok && sink.framesWritten() == 0) {
+        ok = false;
+        message = "No se pudo obtener ningún slice para el video.";
+    } else if (ok) {
+        message = QString("Video generado correctamente en %1").arg(QString::fromStdString(sink.path()));
+    }
+
+    running = false;
+    emit finished(ok, message);
+}
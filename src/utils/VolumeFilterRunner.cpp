@@ -0,0 +1,78 @@
+#include "utils/VolumeFilterRunner.h"
+
+using namespace std;
+
+VolumeFilterRunner::VolumeFilterRunner(QObject *parent) : QObject(parent), pool(1) {}
+
+VolumeFilterRunner::~VolumeFilterRunner() {
+    // El hilo emite señales de este objeto: esperarlo mientras sigue completo
+    pool.waitAll();
+}
+
+/**
+ * @brief Lanza el filtro 3D sobre el volumen activo
+ * @details Se filtra una copia superficial (comparte los buffers), así que después se puede
+ * seguir navegando y cambiando de efecto sin esperar
+ * @param volumetrics Volumen a filtrar; solo se lee en esta llamada
+ * @param effectId Efecto con versión 3D (ver VolumeFilters::supports)
+ * @param params Tamaños de kernel y sigma
+ * @return false si ya había un filtro en curso
+ */
+bool VolumeFilterRunner::start(const Volumetrics &volumetrics, EffectId effectId, const EffectParams &params) {
+    if (running.exchange(true)) {
+        return false;
+    }
+    {
+        lock_guard<mutex> lock(mutex);
+        result = LoadedVolume();
+        hasResult = false;
+        startVersion = volumetrics.getContentVersion();
+    }
+
+    Volumetrics snapshot = volumetrics;
+    pool.submit([this, snapshot, effectId, params] { run(snapshot, effectId, params); });
+    return true;
+}
+
+/**
+ * @brief Recoge el volumen filtrado (llamar desde el hilo de la interfaz, tras finished)
+ * @param volumetrics Donde se va a instalar: si su contentVersion ya no es la del inicio
+ * (otra modalidad, otro paciente, otro filtro) el resultado se descarta
+ * @return false si no hay resultado o ya no corresponde al volumen mostrado
+ */
+bool VolumeFilterRunner::take(const Volumetrics &volumetrics, LoadedVolume &filtered) {
+    lock_guard<mutex> lock(mutex);
+    bool valid = hasResult && startVersion == volumetrics.getContentVersion();
+    if (valid) {
+        filtered = result;
+    }
+    result = LoadedVolume();
+    hasResult = false;
+    return valid;
+}
+
+/**
+ * @brief Indica si hay un filtro en curso
+ */
+bool VolumeFilterRunner::isRunning() const {
+    return running;
+}
+
+/**
+ * @brief Filtra en el hilo del pool y avisa a la interfaz
+ */
+void VolumeFilterRunner::run(Volumetrics snapshot, EffectId effectId, EffectParams params) {
+    LoadedVolume filtered;
+    bool ok = snapshot.filterVolume(effectId, params, filtered);
+    {
+        lock_guard<mutex> lock(mutex);
+        if (ok) {
+            result = filtered;
+            hasResult = true;
+        }
+    }
+    running = false;
+
+    // Conexión en cola: el slot corre en el hilo de la interfaz
+    emit finished(ok);
+}
@@ -0,0 +1,88 @@
+#include "utils/VolumeLoader.h"
+
+using namespace std;
+
+VolumeLoader::VolumeLoader(QObject *parent) : QObject(parent) {}
+
+VolumeLoader::~VolumeLoader() {
+    // Los hilos emiten señales de este objeto: esperarlos mientras sigue completo
+    pool.waitAll();
+}
+
+/**
+ * @brief Lanza la carga en segundo plano de todos los volúmenes pedidos
+ * @details Si había una carga en curso, sus resultados se descartan al llegar
+ * @param requests Volúmenes a cargar (uno por tarea del pool)
+ */
+void VolumeLoader::start(const vector<VolumeRequest> &requests) {
+    unsigned currentGeneration;
+    {
+        lock_guard<mutex> lock(mutex);
+        currentGeneration = ++generation;
+        results.clear();
+        total = static_cast<int>(requests.size());
+        loaded = 0;
+        failed = 0;
+        running = total > 0;
+    }
+
+    for (const VolumeRequest &request : requests) {
+        pool.submit([this, currentGeneration, request] { loadOne(currentGeneration, request); });
+    }
+}
+
+/**
+ * @brief Recoge un volumen ya leído (llamar desde el hilo de la interfaz, tras volumeLoaded)
+ * @return false si ese volumen no está listo o ya se recogió
+ */
+bool VolumeLoader::takeVolume(const string &type, LoadedVolume &volume) {
+    lock_guard<mutex> lock(mutex);
+    auto found = results.find(type);
+    if (found == results.end()) {
+        return false;
+    }
+    volume = found->second;
+    results.erase(found);
+    return true;
+}
+
+/**
+ * @brief Indica si queda algún volumen por cargar
+ */
+bool VolumeLoader::isRunning() const {
+    return running;
+}
+
+/**
+ * @brief Lee un volumen en un hilo del pool y avisa a la interfaz
+ */
+void VolumeLoader::loadOne(unsigned requestGeneration, VolumeRequest request) {
+    LoadedVolume volume;
+    bool ok = Volumetrics::readVolume(request.path, request.type == "mask", volume);
+
+    int loadedNow, totalNow, failedNow;
+    {
+        lock_guard<mutex> lock(mutex);
+        if (requestGeneration != generation) {
+            return; // Se pidió otro paciente mientras tanto
+        }
+        if (ok) {
+            results[request.type] = volume;
+        } else {
+            failed++;
+        }
+        loadedNow = ++loaded;
+        totalNow = total;
+        failedNow = failed;
+        if (loadedNow == totalNow) {
+            running = false;
+        }
+    }
+
+    // Conexiones en cola: los slots corren en el hilo de la interfaz
+    emit volumeLoaded(QString::fromStdString(request.type), ok, QString::fromStdString(request.path));
+    emit progress(loadedNow, totalNow);
+    if (loadedNow == totalNow) {
+        emit finished(failedNow);
+    }
+}